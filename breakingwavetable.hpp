@@ -0,0 +1,313 @@
+/*==============================================================
+
+breakingwavetable.hpp
+
+Breaking wave height and angle for a wave shoaling and refracting
+over shore-parallel contours, found by marching, by Newton's method
+or from a precomputed nondimensional lookup table.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file breakingwavetable.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief breaking wave solutions for Coastline::TransformWaves
+@details Waves are shoaled and refracted following Komar (1998) until the
+wave height exceeds 0.78 times the water depth. With the linear wave
+theory used here the depth at which a wave breaks, as a fraction of its
+offshore height, depends only on the offshore wave steepness H_0/L_0 and
+the offshore wave angle Alpha_0. The BreakingWaveTable stores that
+breaking depth ratio on a grid of steepness and angle, so one table serves
+every wave climate.
+@date 16/10/2026
+*/
+
+#ifndef breakingwavetable_HPP
+#define breakingwavetable_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/// @brief Breaking wave height and angle from a nondimensional lookup table.
+/// @details The table holds the breaking depth over the offshore wave height,
+/// h_b/H_0, on a grid uniform in ln(H_0/L_0) and Alpha_0. Looking up a wave
+/// interpolates h_b bilinearly and then shoals the wave to that depth once,
+/// instead of marching down through the water column. Build refines the grid
+/// until the breaking wave height interpolated at the centre of every grid
+/// cell is within the requested relative error of the Newton solution. Waves
+/// outside the table fall back to the Newton solution.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class BreakingWaveTable
+{
+	public:
+
+	//Table extent: steepness from long swell to the deep water breaking limit, angles up to
+	//where refraction makes the breaking height fall away too steeply to interpolate
+	BreakingWaveTable() : MinSteepness(1e-5), MaxSteepness(0.14), MaxAngle(85.), Tolerance(-1), MaxError(-1), NoSteepness(0), NoAngles(0), NoFallbacks(0) {}
+
+	/// @brief Shoals and refracts an offshore wave to depth h
+	/// @param H_0, C_0, L_0 offshore wave height (m), celerity (m/s) and wavelength (m)
+	/// @param Alpha_0 offshore wave angle to the coast (degrees)
+	/// @param H, Alpha returned wave height (m) and angle (degrees) at depth h
+	static void ShoalWave(double h, double H_0, double C_0, double L_0, double Alpha_0, double& H, double& Alpha)
+	{
+		double C, L, n, k, Ks, Kr;
+		L = L_0*sqrt(tanh((2.*M_PI*h)/L_0));		//Wavelength (m) in intermediate-shallow waters
+		C = C_0*tanh((2*M_PI*h)/L);					//Wave speed (m/s) set by water depth, L and C_0
+		k = 2*M_PI/L;								//Wave number (1/m)
+		n = ((2*h*k)/(sinh(2*h*k)) + 1)/2;			//Shoaling factor
+		Ks = sqrt(C_0/(n*C*2));							//Shoaling coefficient
+		Alpha = (180./M_PI)*asin((C/C_0)*sin((M_PI/180.)*Alpha_0));		//update theta
+		Kr = sqrt(cos((M_PI/180.)*Alpha_0)/cos((M_PI/180.)*Alpha));		//refraction coefficient
+		H = H_0*Ks*Kr;										//calculate new wave height
+	}
+
+	/// @brief Finds the breaking wave by stepping down from a depth of 3*H_0 in 0.05 m steps
+	/// @details The original TransformWaves solution. Returns zero height and
+	/// angle if the wave doesn't break before the depth reaches zero.
+	static void MarchBreakingWave(double H_0, double C_0, double L_0, double Alpha_0, double& H_b, double& Alpha_b)
+	{
+		double H, Alpha;
+		int BreakCondition = 0;				//flag for testing wave breaking
+		double h = 3.*H_0;					// water depth at wave base (metres) calculate this later based on period and height
+
+		while (BreakCondition == 0)
+		{
+			//Calculate new wave height
+			ShoalWave(h, H_0, C_0, L_0, Alpha_0, H, Alpha);
+
+			//test if wave breaks
+			if (H > h*0.78)
+			{
+				BreakCondition = 1;
+				H_b = H;
+				Alpha_b = Alpha;
+			}
+
+			//update water depth
+			h -= 0.05;
+
+			//Catch negative water depths!
+			//Must be Alpha -> 90 so assume zero transport and set wave height and angle to 0
+			if (h < 0)
+			{
+				H_b = 0;
+				Alpha_b = 0;
+				BreakCondition = 1; // dont bother with refraction for this cell
+			}
+		}
+	}
+
+	/// @brief Finds the depth at which the wave height reaches 0.78 times the depth by Newton's method
+	/// @details Newton iterations on H(h)-0.78h, kept inside a bracket that is
+	/// halved whenever a step would leave it.
+	/// @return double, the breaking depth (m), or -1 if the wave has no breaking
+	/// depth (e.g. waves at 90 degrees to the coast)
+	static double SolveBreakingDepth(double H_0, double C_0, double L_0, double Alpha_0)
+	{
+		double H, HPlus, HMinus, Alpha, h, hNew, dh, Residual, Gradient;
+		if (!(H_0 > 0)) return -1;
+
+		//bracket the breaking depth, H exceeds 0.78h in the shallows
+		double hDeep = 3.*H_0;
+		ShoalWave(hDeep, H_0, C_0, L_0, Alpha_0, H, Alpha);
+		if (H != H) return -1;
+		if (H > 0.78*hDeep) return hDeep;
+		double hShallow = 1e-6*H_0;
+		ShoalWave(hShallow, H_0, C_0, L_0, Alpha_0, H, Alpha);
+		if (!(H > 0.78*hShallow)) return -1;
+
+		h = 0.5*(hDeep+hShallow);
+		for (int Iteration=0; Iteration<100; ++Iteration)
+		{
+			ShoalWave(h, H_0, C_0, L_0, Alpha_0, H, Alpha);
+			Residual = H-0.78*h;
+			if (Residual > 0) hShallow = h;
+			else hDeep = h;
+
+			dh = 1e-6*h;
+			ShoalWave(h+dh, H_0, C_0, L_0, Alpha_0, HPlus, Alpha);
+			ShoalWave(h-dh, H_0, C_0, L_0, Alpha_0, HMinus, Alpha);
+			Gradient = (HPlus-HMinus)/(2.*dh) - 0.78;
+
+			hNew = h - Residual/Gradient;
+			if (!(hNew > hShallow && hNew < hDeep)) hNew = 0.5*(hShallow+hDeep);
+			if (fabs(hNew-h) < 1e-12*h) return hNew;
+			h = hNew;
+		}
+		return h;
+	}
+
+	/// @brief Breaking wave height and angle from SolveBreakingDepth
+	/// @details Returns zero height and angle if the wave has no breaking depth.
+	static void SolveBreakingWave(double H_0, double C_0, double L_0, double Alpha_0, double& H_b, double& Alpha_b)
+	{
+		double h = SolveBreakingDepth(H_0, C_0, L_0, Alpha_0);
+		if (h < 0)
+		{
+			H_b = 0;
+			Alpha_b = 0;
+		}
+		else ShoalWave(h, H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+	}
+
+	/// @brief Builds the table to a given relative error in breaking wave height
+	/// @details Starts from a coarse grid and doubles its resolution until the
+	/// interpolated breaking height at every cell centre is within Tolerance of
+	/// the Newton solution, or the grid reaches MaxNodes in each direction.
+	void Build(double NewTolerance)
+	{
+		Tolerance = NewTolerance;
+		int Steps = 16;
+		double Error;
+		while (true)
+		{
+			Fill(Steps+1, Steps+1);
+			Error = GetMaxError();
+			if (Error <= Tolerance || 2*Steps+1 > (int)MaxNodes) break;
+			Steps *= 2;
+		}
+		if (Error > Tolerance)
+		{
+			printf("Warning: breaking wave table reached %d x %d nodes with a relative error of %g in %s\n",NoSteepness,NoAngles,Error,__func__);
+		}
+		MaxError = Error;
+	}
+
+	/// @brief Breaking wave height and angle from the table
+	/// @details Falls back to SolveBreakingWave if the wave's steepness or angle
+	/// is outside the table. Safe to call from several threads once built.
+	void GetBreakingWave(double H_0, double C_0, double L_0, double Alpha_0, double& H_b, double& Alpha_b)
+	{
+		double Angle = fabs(Alpha_0);
+		double Steepness = H_0/L_0;
+		if (!(Steepness >= MinSteepness && Steepness <= MaxSteepness && Angle <= MaxAngle))
+		{
+#ifdef _OPENMP
+			#pragma omp atomic
+#endif
+			++NoFallbacks;
+			SolveBreakingWave(H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+			return;
+		}
+		double DepthRatio = Interpolate(log(Steepness), Angle);
+		if (DepthRatio > 0) ShoalWave(DepthRatio*H_0, H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+		else
+		{
+#ifdef _OPENMP
+			#pragma omp atomic
+#endif
+			++NoFallbacks;
+			SolveBreakingWave(H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+		}
+	}
+
+	int IsBuilt() const { return NoSteepness > 0; }
+	double get_Tolerance() const { return Tolerance; }
+	double get_MaxError() const { return MaxError; }
+	int get_NoSteepness() const { return NoSteepness; }
+	int get_NoAngles() const { return NoAngles; }
+	int get_NoFallbacks() const { return NoFallbacks; }
+
+	private:
+
+	double MinSteepness, MaxSteepness; //Range of offshore wave steepness H_0/L_0 in the table
+	double MaxAngle; //Largest offshore wave angle in the table (degrees)
+	enum { MaxNodes = 1025 };
+
+	double Tolerance; //Requested relative error in breaking wave height
+	double MaxError; //Largest relative error found at the cell centres
+	int NoSteepness, NoAngles;
+	int NoFallbacks; //Number of lookups outside the table
+	double LogSteepness0, dLogSteepness, dAngle;
+	vector<double> DepthRatio; //h_b/H_0 at each node, NoSteepness*NoAngles, angle varying fastest
+
+	/// @brief Breaking depth over offshore height for a nondimensional wave, -1 if it doesn't break
+	static double GetDepthRatio(double LogSteepness, double Angle)
+	{
+		//any unit wave with the right steepness will do, C_0 cancels out
+		double H_0 = 1., L_0 = 1./exp(LogSteepness), C_0 = sqrt(L_0);
+		return SolveBreakingDepth(H_0, C_0, L_0, Angle)/H_0;
+	}
+
+	void Fill(int NewNoSteepness, int NewNoAngles)
+	{
+		NoSteepness = NewNoSteepness, NoAngles = NewNoAngles;
+		LogSteepness0 = log(MinSteepness);
+		dLogSteepness = (log(MaxSteepness)-LogSteepness0)/(NoSteepness-1);
+		dAngle = MaxAngle/(NoAngles-1);
+		DepthRatio.resize(NoSteepness*NoAngles);
+		for (int a=0; a<NoSteepness; ++a)
+		{
+			for (int b=0; b<NoAngles; ++b) DepthRatio[a*NoAngles+b] = GetDepthRatio(LogSteepness0+a*dLogSteepness, b*dAngle);
+		}
+	}
+
+	double Interpolate(double LogSteepness, double Angle) const
+	{
+		double x = (LogSteepness-LogSteepness0)/dLogSteepness, y = Angle/dAngle;
+		int a = min((int)x, NoSteepness-2), b = min((int)y, NoAngles-2);
+		double fx = x-a, fy = y-b;
+		const double* Row = &DepthRatio[a*NoAngles+b];
+		return (1.-fx)*((1.-fy)*Row[0] + fy*Row[1]) + fx*((1.-fy)*Row[NoAngles] + fy*Row[NoAngles+1]);
+	}
+
+	/// @brief Largest relative error in breaking wave height at the cell centres
+	double GetMaxError() const
+	{
+		double Error = 0, LogSteepness, Angle, H_0 = 1., L_0, C_0, H_b, Alpha_b, H_Table, Alpha_Table;
+		for (int a=0; a<NoSteepness-1; ++a)
+		{
+			for (int b=0; b<NoAngles-1; ++b)
+			{
+				LogSteepness = LogSteepness0+(a+0.5)*dLogSteepness;
+				Angle = (b+0.5)*dAngle;
+				L_0 = 1./exp(LogSteepness), C_0 = sqrt(L_0);
+				SolveBreakingWave(H_0, C_0, L_0, Angle, H_b, Alpha_b);
+				ShoalWave(Interpolate(LogSteepness, Angle)*H_0, H_0, C_0, L_0, Angle, H_Table, Alpha_Table);
+				if (H_b > 0) Error = max(Error, fabs(H_Table-H_b)/H_b);
+			}
+		}
+		return Error;
+	}
+};
+
+#endif
@@ -72,6 +72,11 @@ using namespace std;
 void Cliffline::Initialise()
 {
 	printf("\nCliffline.Initialise: Warning, initialised an empty Cliffline object\n");
+	NoNodes = 0;
+	LostFraction = 0;
+	NoRemeshOperations = 0;
+	ErosionIsPending = 0;
+	BeachIndexVersion = -1;
 	//exit(EXIT_FAILURE);
 }
 /**Initialise the Cliffline with an xyfile. File format is a headerline containing the start and end boundary 
@@ -89,6 +94,11 @@ void Cliffline::Initialise(string xyfilename)
 	float Time=0;
 	ReadCliff(xyfilename, Time);
 
+	LostFraction = 0;
+	NoRemeshOperations = 0;
+	ErosionIsPending = 0;
+	BeachIndexVersion = -1;
+
 	//Populate empty vectors
 	vector<double> EmptyVector(NoNodes, -9999);
 	Distance = EmptyVector;
@@ -105,6 +115,7 @@ void Cliffline::Initialise(string xyfilename)
 	CalculateMorphology();
 	CalculateMeanNodeSpacing();
 	DesiredNodeSpacing = MeanNodeSpacing;
+	IndexSegments();
 
 }
 /**Initialise the Cliffline with an xyfile and a start time. File format is a headerline containing the start
@@ -119,6 +130,11 @@ void Cliffline::Initialise(string xyfilename, float StartTime)
 	cout << "\nCliffline.Initialise: Initialising Cliffline from XY file: " << xyfilename << " at Time: " << StartTime << endl;
 	ReadCliff(xyfilename, StartTime);
 	
+	LostFraction = 0;
+	NoRemeshOperations = 0;
+	ErosionIsPending = 0;
+	BeachIndexVersion = -1;
+
 	//Populate empty vectors
 	vector<double> EmptyVector(NoNodes, -9999);
 	Distance = EmptyVector;
@@ -142,6 +158,7 @@ void Cliffline::Initialise(string xyfilename, float StartTime)
 	CalculateMorphology();
 	CalculateMeanNodeSpacing();
 	DesiredNodeSpacing = MeanNodeSpacing;
+	IndexSegments();
 }
 
 /** Initialise the Cliffline object as a straight line (with small amplitude random noise) by specifying
@@ -149,7 +166,7 @@ the mean node spacing (in metres) the total length of the coast (in metres), the
 (azimuth direction with sea to the left as you look down this line) and the type of start and end boundary 
 conditions.
 * MDH 6/1/14 */
-void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend, int StartBoundaryInput, int EndBoundaryInput)
+void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend, int StartBoundaryInput, int EndBoundaryInput, unsigned long long NoiseSeed)
 {
 
 	/*	Initialises the coast as a straight segment with low amplitude noise
@@ -175,6 +192,7 @@ void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 	MeanNodeSpacing = (double)NodeSpacing;
 	DesiredNodeSpacing = MeanNodeSpacing;
   double NoiseAmplitude =(MeanNodeSpacing/10.);
+	RandomStream Noise(NoiseSeed); //Own stream, so the same seed gives the same line
 	
 	//initialise coast
 	while (Dist<CoastLength)
@@ -200,8 +218,8 @@ void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 			else
 			{
         //sort out random addition
-	      tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
-	      tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
+	      tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
+	      tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
 	      X.push_back(tempX);
 	      Y.push_back(tempY);
 	      NoNodes += 1;
@@ -211,8 +229,8 @@ void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 		else
 		{
 			//sort out random addition
-			tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
-			tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
+			tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
+			tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
 			X.push_back(tempX);
 			Y.push_back(tempY);
 			NoNodes += 1;
@@ -237,6 +255,11 @@ void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
     NoNodes += 1;
   }
 	
+	LostFraction = 0;
+	NoRemeshOperations = 0;
+	ErosionIsPending = 0;
+	BeachIndexVersion = -1;
+
 	//Populate empty vectors
 	vector<double> EmptyVector(NoNodes, -9999);
 	Distance = EmptyVector;
@@ -258,6 +281,7 @@ void Cliffline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 	
 	//Calculate Orientation, Slope and Curvature
 	CalculateMorphology();
+	IndexSegments();
 }
 
 //Reads a vector of whether the cliff is fixed or unfixed (i.e. protected)
@@ -445,18 +469,17 @@ void Cliffline::CalculateMorphology()
 	double SpatialGradient;
 	double LeftDiff, RightDiff;
 
-	//Reset all vectors (could builda function for this)
-	vector<double> EmptyVector(NoNodes, -9999);
-	Distance = EmptyVector;
-	FluxOrientation = EmptyVector;
-	Orientation = EmptyVector;
-	CellWidth = EmptyVector;
-	PositionChange = EmptyVector;
-	VolumeChange = EmptyVector;
-	BeachWidth = EmptyVector;
-	NearestBeachIndex = EmptyVector;
-	e1 = EmptyVector;
-	e2 = EmptyVector;
+	//Reset all vectors in place
+	ResetWorkspace(Distance, -9999.);
+	ResetWorkspace(FluxOrientation, -9999.);
+	ResetWorkspace(Orientation, -9999.);
+	ResetWorkspace(CellWidth, -9999.);
+	ResetWorkspace(PositionChange, -9999.);
+	ResetWorkspace(VolumeChange, -9999.);
+	ResetWorkspace(BeachWidth, -9999.);
+	ResetWorkspace(NearestBeachIndex, -9999.);
+	ResetWorkspace(e1, -9999.);
+	ResetWorkspace(e2, -9999.);
 	
 	for (int i=0; i<NoNodes; ++i)
 	{
@@ -608,72 +631,58 @@ void Cliffline::CheckNodeSpacing()
 	/* Function to check the spacing bewteen the nodes is optimal and add or delete nodes 
 		as appropriate. Where nodes are <0.6*DesiredNodeSpacing a new node interpolated
 		between them will be created. Where nodes are >1.5*DesiredNodeSpacing apart then
-		a new node is created between them		*/
+		a new node is created between them
+		
+		Only the pair behind a changed node can have changed length, so step back one
+		pair after each change rather than restarting the check, and recalculate the
+		morphology once at the end	*/
 		
 	//declare variables
 	//double OptimalArea = MeanNodeSpacing*(ClosureDepth/ShorefaceSlope);
-	int SpacingFlag = 0;
 	int NodeFlag = 0;
+	int i = 1;
 	double Distance,X0,Y0;//MeanOrientation; //,M1,M2; //, VolumeOld, VolumeNew, VolChange, a, b, c;
-	//need to recalculate morphology and start check again after each new node is added
-	while (SpacingFlag == 0)
+	NoRemeshOperations = 0;
+	
+	while (i < NoNodes-2)
 	{
-		for (int i=0; i<NoNodes-1; ++i)
+		Distance = sqrt(pow(X[i+1]-X[i],2.0) + pow(Y[i+1]-Y[i],2.0));
+		
+		//if distance between two cells is too small, 
+		//replace with a linearly interpolated point between
+		if (Distance < 0.4*DesiredNodeSpacing)
 		{
-			if (i<1 || i>NoNodes-3) continue;
-			if (i == NoNodes-1) {}
+			//if cell is too narrow remove its adjacent nodes
+			if ((StartBoundary == 2 && EndBoundary == 2) & (i == 1 || i == NoNodes-3)) {}
 			else
 			{
-				Distance = sqrt(pow(X[i+1]-X[i],2.0) + pow(Y[i+1]-Y[i],2.0));
-				
-				//if distance between two cells is too small, 
-				//replace with a linearly interpolated point between
-				if (Distance < 0.4*DesiredNodeSpacing)
-				{
-					//if cell is too narrow remove its adjacent nodes
-					if ((StartBoundary == 2 && EndBoundary == 2) & (i == 1 || i == NoNodes-3))
-					{
-						//cout << "Erasing Node" << endl;
-						X.erase(X.begin()+i+1); 
-						Y.erase(Y.begin()+i+1); 
-						Fixed.erase(Fixed.begin()+i+1);
-						NoNodes -= 1;
-						SpacingFlag = 0;
-						NodeFlag = 1;
-						CalculateMorphology();
-					}
-					else
-					{
-						//cout << "Erasing Node" << endl;
-						X[i] = ((X[i+1]+X[i])/2.);
-						Y[i] = ((Y[i+1]+Y[i])/2.);
-						X.erase(X.begin()+i+1); 
-						Y.erase(Y.begin()+i+1); 
-						Fixed.erase(Fixed.begin()+i+1);
-						NoNodes -= 1;
-						SpacingFlag = 0;
-						NodeFlag = 1;
-						CalculateMorphology();
-					}
-					break;
-				}
-				else if (Distance > 1.5*DesiredNodeSpacing)
-				{
-					//if cell too far apart add new node
-					X0 = (X[i]+X[i+1])/2.;
-					Y0 = (Y[i]+Y[i+1])/2.;
-					X.insert(X.begin()+i+1,X0);
-					Y.insert(Y.begin()+i+1,Y0);
-					Fixed.insert(Fixed.begin()+i+1,0.0);
-					NoNodes += 1;
-					SpacingFlag = 0;
-					NodeFlag = 1;
-					CalculateMorphology();
-					break;
-				}
-				else SpacingFlag = 1;
+				X[i] = ((X[i+1]+X[i])/2.);
+				Y[i] = ((Y[i+1]+Y[i])/2.);
 			}
+			//cout << "Erasing Node" << endl;
+			X.erase(X.begin()+i+1); 
+			Y.erase(Y.begin()+i+1); 
+			Fixed.erase(Fixed.begin()+i+1);
+			NoNodes -= 1;
 		}
+		else if (Distance > 1.5*DesiredNodeSpacing)
+		{
+			//if cell too far apart add new node
+			X0 = (X[i]+X[i+1])/2.;
+			Y0 = (Y[i]+Y[i+1])/2.;
+			X.insert(X.begin()+i+1,X0);
+			Y.insert(Y.begin()+i+1,Y0);
+			Fixed.insert(Fixed.begin()+i+1,0.0);
+			NoNodes += 1;
+		}
+		else
+		{
+			++i;
+			continue;
+		}
+		++NoRemeshOperations;
+		NodeFlag = 1;
+		i = max(1,i-1);
 	}
 	if (NodeFlag == 1) CalculateMorphology();
 }
@@ -728,9 +737,13 @@ void Cliffline::IntersectionAnalysis()
 	//declare temporary variables
 	double X1, X2, X3, X4, Y1, Y2, Y3, Y4, dX12, dY12, dX34, dY34, dX31, dY31, XProd, S, T;
 	int XProdPos = 0;
+	int j;
+	
+	//bin the segments so each is only tested against those it might touch
+	IntersectionGrid.Build(X.data(), Y.data(), NoNodes-1);
 	
 	//#pragma omp parallel for
-	for (int i=0; i<NoNodes; ++i)
+	for (int i=0; i<NoNodes-3; ++i)
 	{
 		//assign first segment
 		X1 = X[i];
@@ -740,8 +753,12 @@ void Cliffline::IntersectionAnalysis()
 		dX12 = X2-X1;
 		dY12 = Y2-Y1;
 		
-		for (int j=i+2; j<NoNodes-1; ++j)
+		IntersectionGrid.Query(min(X1,X2), min(Y1,Y2), max(X1,X2), max(Y1,Y2), SegmentCandidates);
+		for (int k=0; k<(int)SegmentCandidates.size(); ++k)
 		{
+			j = SegmentCandidates[k];
+			if (j < i+2) continue;
+			
 			//assign second segment
 			X3 = X[j];
 			Y3 = Y[j];
@@ -781,74 +798,150 @@ void Cliffline::IntersectionAnalysis()
 	}
 }
 
-void Cliffline::DetermineBeachWidth(Coastline Coastline)
+void Cliffline::DetermineBeachWidth(const Coastline& Coastline)
 {
-  //Declare parameters
-  //StartSearch and EndSearch define where to look up and down the vector from the last 
-  //successful measurement to find the shortest beach width
-  int SearchDistance = 5;
-  int StartSearch = 0;
-  int EndSearch = 0;
-  
-  //Parameters for dot product search
-  double dX12, dY12, dX13, dY13, DotProduct, t, lastt, DistanceToLine, XLine, YLine;
+  //Parameters for the nearest point on the beach
+  int Nearest;
+  int LastBeachSegment = Coastline.NoNodes-2;
+  double t, DistanceToLine;
 
   //Reset beach width  
   fill(BeachWidth.begin(),BeachWidth.end(),9999);
+
+  //the beach moves every step so is indexed whenever it has changed
+  IndexBeach(Coastline);
   
   //loop through cliffline and compare to coastline to get beachwidth
   for (int i=0; i<NoNodes-1; ++i)
   {
-		if (i == 0) NearestBeachIndex[i] = i, StartSearch = i, EndSearch = SearchDistance;
-		else if (NearestBeachIndex[i-1] > Coastline.NoNodes-SearchDistance) StartSearch = NearestBeachIndex[i-1], EndSearch = Coastline.NoNodes-1;
-		else StartSearch = NearestBeachIndex[i-1], EndSearch = NearestBeachIndex[i-1]+SearchDistance;
-	
-	  //reset t
-	  t = 0;
-	  
-	  for (int j=StartSearch; j<EndSearch; ++j)
-	  {
-		  //Get vector x and y
-	    dX12 = Coastline.X[j+1]-Coastline.X[j];
-  		dY12 = Coastline.Y[j+1]-Coastline.Y[j];
-	
-	    //Get 2nd Vector properties
-		  dX13 = X[i]-Coastline.X[j];
-		  dY13 = Y[i]-Coastline.Y[j];
-		
-		  //Find Dot Product
-		  DotProduct = dX12*dX13 + dY12*dY13;
-		
-		  //calculate fraction of distance along line
-		  lastt = t;
-		  t = DotProduct/(dX12*dX12 + dY12*dY12);
-		  if ((lastt < 0. && t > 1.) || (lastt > 1. && t < 0))
-		  {
-			  XLine = Coastline.X[j];
-  			YLine = Coastline.Y[j];
-			}
-			else if (t<0. || t>1.) continue;
-			else
-		  {
-		    //Find point along line
-  		  XLine = Coastline.X[j] + t*dX12;
-	  	  YLine = Coastline.Y[j] + t*dY12;
-	    }
-	    		
-		  //find distance to point
-		  DistanceToLine = sqrt((XLine-X[i])*(XLine-X[i]) + (YLine-Y[i])*(YLine-Y[i]));
-		  if (DistanceToLine < BeachWidth[i]) 
-		  {
-		    BeachWidth[i] = DistanceToLine;
-		    NearestBeachIndex[i] = j;
-		  }
-	  }
-	  if (BeachWidth[i] == 9999) NearestBeachIndex[i] = 0;
+    NearestBeachIndex[i] = 0;
+    Nearest = BeachIndex.Nearest(Coastline.X.data(), Coastline.Y.data(), X[i], Y[i], DistanceToLine, t);
+
+    //no beach in front of nodes beyond its ends
+    if (Nearest < 0) continue;
+    if ((Nearest == 0 && t < 0.) || (Nearest == LastBeachSegment && t > 1.)) continue;
+
+    BeachWidth[i] = DistanceToLine;
+    NearestBeachIndex[i] = Nearest;
+  }
+}
+
+void Cliffline::IndexBeach(const Coastline& Coastline)
+{
+  int BeachIsIndexed = (BeachIndexVersion == Coastline.TopologyVersion && (int)BeachIndexX.size() == Coastline.NoNodes);
+  for (int j=0; BeachIsIndexed && j<Coastline.NoNodes; ++j)
+  {
+    if (Coastline.X[j] != BeachIndexX[j] || Coastline.Y[j] != BeachIndexY[j]) BeachIsIndexed = 0;
+  }
+  if (BeachIsIndexed) return;
+
+  BeachIndex.Build(Coastline.X.data(), Coastline.Y.data(), Coastline.NoNodes-1);
+  BeachIndexX.assign(Coastline.X.begin(), Coastline.X.end());
+  BeachIndexY.assign(Coastline.Y.begin(), Coastline.Y.end());
+  BeachIndexVersion = Coastline.TopologyVersion;
+}
+
+double Cliffline::RetreatRate(double TheBeachWidth, int ErosionType)
+{
+  if (ErosionType == 1) return MaxRetreatRate*exp(-TheBeachWidth/CriticalWidth);
+  else if (ErosionType == 2)
+  {
+    if (TheBeachWidth < CriticalWidth) return (MaxRetreatRate/2.)*(1+TheBeachWidth/CriticalWidth);
+    else return MaxRetreatRate*exp(-(TheBeachWidth-CriticalWidth)/(WidthScale));
+  }
+  cout << "Erosion Type not set!" << endl;
+  exit(EXIT_SUCCESS);
+}
+
+void Cliffline::UpdateBeachWidth(const Coastline& Coastline)
+{
+  double dX12, dY12, dX13, dY13, t, DistanceToLine;
+  for (int i=0; i<NoNodes-1; ++i)
+  {
+    //no beach was found in front of this node
+    if (BeachWidth[i] == 9999) continue;
+
+    int Nearest = NearestBeachIndex[i];
+    int StartSearch = max(0, Nearest-1);
+    int EndSearch = min(Coastline.NoNodes-1, Nearest+2);
+    BeachWidth[i] = 9999;
+    for (int j=StartSearch; j<EndSearch; ++j)
+    {
+      //nearest point on beach segment j
+      dX12 = Coastline.X[j+1]-Coastline.X[j];
+      dY12 = Coastline.Y[j+1]-Coastline.Y[j];
+      dX13 = X[i]-Coastline.X[j];
+      dY13 = Y[i]-Coastline.Y[j];
+      t = (dX12*dX13 + dY12*dY13)/(dX12*dX12 + dY12*dY12);
+      if (t < 0.) t = 0.;
+      else if (t > 1.) t = 1.;
+      DistanceToLine = sqrt((Coastline.X[j]+t*dX12-X[i])*(Coastline.X[j]+t*dX12-X[i]) + (Coastline.Y[j]+t*dY12-Y[i])*(Coastline.Y[j]+t*dY12-Y[i]));
+      if (DistanceToLine < BeachWidth[i])
+      {
+        BeachWidth[i] = DistanceToLine;
+        NearestBeachIndex[i] = j;
+      }
+    }
   }
 }
 
-void Cliffline::ErodeCliff(double &TimeDelta, Coastline Coastline, int ErosionType)
+void Cliffline::AccumulateErosion(double TimeDelta, Coastline& Coastline, int ErosionType)
 {
+  //search the whole beach if the cliff has moved since the last call or the beach
+  //nodes have been renumbered, otherwise only round the nearest beach segments
+  int SearchBeach = (ErosionIsPending == 0 || Coastline.NoRemeshOperations > 0 || Coastline.NoNodes != MeasuredBeachNodes);
+  if (ErosionIsPending == 0)
+  {
+    //cliff has moved since the last call, start again
+    CalculateMorphology();
+    ResetWorkspace(PendingChange, 0.);
+    ErosionIsPending = 1;
+  }
+  if (SearchBeach)
+  {
+    DetermineBeachWidth(Coastline);
+    MeasuredBeachNodes = Coastline.NoNodes;
+  }
+  else UpdateBeachWidth(Coastline);
+
+  for (int i=0; i<NoNodes-1; ++i)
+  {
+    //if nearest beach node is in shadow, do nothing
+    if (Coastline.Shadows[NearestBeachIndex[i]] != 0) continue;
+
+    double Change = -RetreatRate(BeachWidth[i], ErosionType)*TimeDelta/365.;
+    PendingChange[i] += Change;
+
+    //supply the eroded volume now, the cliff catches up at ApplyErosion
+    Coastline.SupplySediment(-Change*CellWidth[i]*CliffHeight*(1.-LostFraction), NearestBeachIndex[i]);
+  }
+}
+
+void Cliffline::ApplyErosion()
+{
+  if (ErosionIsPending == 0) return;
+
+  //Move the cliff by the accumulated change, CellWidth and Orientation haven't changed since it was started
+  for (int i=0; i<NoNodes-1; ++i)
+  {
+    PositionChange[i] = PendingChange[i];
+    VolumeChange[i] = PositionChange[i]*CellWidth[i]*CliffHeight;
+    X[i] -= PositionChange[i]*cos((M_PI/180.)*Orientation[i]);
+    Y[i] += PositionChange[i]*sin((M_PI/180.)*Orientation[i]);
+  }
+  ErosionIsPending = 0;
+
+  //Check for intersections and check node spacing
+  IntersectionAnalysis();
+  CheckNodeSpacing();
+  IndexSegments();
+}
+
+void Cliffline::ErodeCliff(double &TimeDelta, Coastline& Coastline, int ErosionType)
+{
+  //Catch up on any erosion accumulated by AccumulateErosion first
+  ApplyErosion();
+
   //Calculate Cliffline Morphology
   CalculateMorphology();
   
@@ -862,17 +955,7 @@ void Cliffline::ErodeCliff(double &TimeDelta, Coastline Coastline, int ErosionTy
     if (Coastline.Shadows[NearestBeachIndex[i]] != 0) continue;
     
     //get position change
-    if (ErosionType == 1) PositionChange[i] = -MaxRetreatRate*exp(-BeachWidth[i]/CriticalWidth)*TimeDelta/365.; 
-    else if (ErosionType == 2)
-    {
-      if (BeachWidth[i] < CriticalWidth) PositionChange[i] = -(MaxRetreatRate/2.)*(1+BeachWidth[i]/CriticalWidth)*TimeDelta/365.; 
-      else PositionChange[i] = -MaxRetreatRate*exp(-(BeachWidth[i]-CriticalWidth)/(WidthScale))*TimeDelta/365.;
-    }
-    else 
-    {
-    	cout << "Erosion Type not set!" << endl;
-    	exit(EXIT_SUCCESS);
-    }
+    PositionChange[i] = -RetreatRate(BeachWidth[i], ErosionType)*TimeDelta/365.;
     
     //Determine volume change in cliff
     VolumeChange[i] = PositionChange[i]*CellWidth[i]*CliffHeight;
@@ -881,13 +964,15 @@ void Cliffline::ErodeCliff(double &TimeDelta, Coastline Coastline, int ErosionTy
     X[i] -= PositionChange[i]*cos((M_PI/180.)*Orientation[i]);
 		Y[i] += PositionChange[i]*sin((M_PI/180.)*Orientation[i]);
 		
-		//Add volume to the beach (this is where things could get complicated!
-	  Coastline.AddVolume(VolumeChange[i], NearestBeachIndex[i]);	
+		//Supply the eroded volume (VolumeChange is negative) to the nearest beach cell,
+		//less the fraction lost to the sea, the beach picks it up on its next step
+	  Coastline.SupplySediment(-VolumeChange[i]*(1.-LostFraction), NearestBeachIndex[i]);
   }
     
   //Check for intersections and check node spacing
 	IntersectionAnalysis();
 	CheckNodeSpacing();
+	IndexSegments();
 }
 
 #endif
@@ -60,7 +60,9 @@ friend class.
 #include <vector>
 #include <cstring>
 #include <queue>
+#include <algorithm>
 #include "waveclimate.hpp"
+#include "segmentgrid.hpp"
 #include "coastline.hpp"
 
 using namespace std;
@@ -114,7 +116,55 @@ class Cliffline
 	double CriticalWidth;           //Beach width at which cliff retreat is maximised (m)
   double WidthScale;              //Sets the Beach width at which cliff retreat is minimised
 	double LostFraction;            //Fraction of material supplied from cliff immediately lost to the sea
+	int NoRemeshOperations;         //Number of nodes added or removed by the last CheckNodeSpacing
+	vector<double> PendingChange;   //Change in clifftop position accumulated by AccumulateErosion (m)
+	int ErosionIsPending;           //1 if PendingChange holds erosion not yet applied to X and Y
+	int MeasuredBeachNodes;         //Number of Coastline nodes when NearestBeachIndex was last searched for
+	SegmentGrid IntersectionGrid;   //Broad phase for IntersectionAnalysis
+	vector<int> SegmentCandidates;  //Segments that might cross the one being checked in IntersectionAnalysis
+	SegmentGrid SegmentIndex;       //Cliff segments, for Coastline::DetermineBeachWidth, rebuilt when the cliff moves
+	SegmentGrid BeachIndex;         //Beach segments, for DetermineBeachWidth, rebuilt when the beach has changed
+	vector<double> BeachIndexX;     //X positions of the beach nodes BeachIndex was built from
+	vector<double> BeachIndexY;     //Y positions of the beach nodes BeachIndex was built from
+	int BeachIndexVersion;          //Coastline TopologyVersion when BeachIndex was built, -1 = never built
 	
+	/* @brief Resets a per-node vector in place
+	@details As Coastline::ResetWorkspace, sets Workspace to NoNodes copies of
+	Value while keeping its storage, growing capacity geometrically if needed.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	template <class T> void ResetWorkspace(vector<T>& Workspace, T Value)
+	{
+		if (Workspace.capacity() < (size_t)NoNodes) Workspace.reserve(max((size_t)NoNodes, 2*Workspace.capacity()));
+		Workspace.assign(NoNodes, Value);
+	}
+
+	/* @brief Cliff retreat rate (m/yr) for a given beach width
+	@details Valvo et al. (2006) for ErosionType 1, Limber and Murray (2011) for ErosionType 2.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	double RetreatRate(double TheBeachWidth, int ErosionType);
+
+	/* @brief Rebuilds SegmentIndex from the cliff nodes
+	@details Called whenever the cliff moves, so that the index is only rebuilt when
+	the cliff changes rather than every time the beach measures its width from it.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void IndexSegments() { SegmentIndex.Build(X.data(), Y.data(), NoNodes-1); }
+
+	/* @brief Rebuilds BeachIndex from the beach nodes if they have changed since it was built
+	@details DetermineBeachWidth can be called more than once between beach steps, e.g.
+	by AccumulateErosion and again after the cliff is moved, so the beach is only indexed
+	once for each position of its nodes. */
+	void IndexBeach(const Coastline& Coastline);
+
+	/* @brief Update beach width from the beach segments around the nearest one
+	@details Cheap alternative to DetermineBeachWidth while the cliff hasn't moved and the
+	beach hasn't been remeshed, searching only the segments either side of NearestBeachIndex.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void UpdateBeachWidth(const Coastline& Coastline);
+
 	/** @brief Calculates the morphological properties of the coastline
 	@details Resets the coastline morphological vectors and recalculates a variety
 	of geometric properties and metrics. Calculates Distance along the coast, Orientation 
@@ -127,7 +177,8 @@ class Cliffline
 	/* @brief Checks nodes haven't got too close together or too far apart.
 	@details Checks to see whether there are nodes too close together 
 	(<0.66*DesiredNodeSpacing) or too far apart (>1.5*DesiredNodeSpacing). 
-	Nodes are added by interpolation or deleted as appropriate
+	Nodes are added by interpolation or deleted as appropriate. As in Coastline,
+	the cliff is checked in a single sweep and the morphology recalculated once.
 	@author Martin D. Hurst
   @date 4/1/2015 */ 
 	void CheckNodeSpacing();
@@ -139,7 +190,8 @@ class Cliffline
 	void CalculateMeanNodeSpacing();
 	
 	/* @brief Checks the coastline doesn't intersect itself anywhere.
-	@details This would indicate formation of a stack!?
+	@details This would indicate formation of a stack!? Uses a SegmentGrid
+	broad phase, as Coastline::IntersectionAnalysis.
 	@author Martin D. Hurst
   @date 4/1/2016 */ 
 	void IntersectionAnalysis();
@@ -148,7 +200,7 @@ class Cliffline
 	void Initialise();
 	void Initialise(string xyfilename);
 	void Initialise(string xyfilename, float StartTime);
-	void Initialise(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary);
+	void Initialise(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary, unsigned long long NoiseSeed);
 	
 	//Writing functions for debugging
   void WriteXYFile();
@@ -183,11 +235,12 @@ class Cliffline
 	@param Trend Double, the azimuth direction in which to create the coast.
 	@param StartBoundary, the boundary condition at the start of the line (1=fixed, 2=periodic)
 	@param EndBoundary, the boundary condition at the end of the line (1=fixed, 2=periodic), must be same as StartBoundary (for the moment).
+	@param NoiseSeed, seed of the noise added to the node positions, the same seed always gives the same line
 	@author Martin D. Hurst
 	@date 4/1/2016 */
-	Cliffline(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary)
+	Cliffline(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary, unsigned long long NoiseSeed = 1)
 	{
-		Initialise(MeanNodeSpacing, CoastLength, Trend, StartBoundary, EndBoundary);
+		Initialise(MeanNodeSpacing, CoastLength, Trend, StartBoundary, EndBoundary, NoiseSeed);
 	}
 	
 	/// @brief Reads whether cliff is fixed
@@ -215,22 +268,51 @@ class Cliffline
 	
 	/* @brief Measure the beach width by comparison to 
 	@details Fucntion to determine the shortest distance between cliffline nodes and the coastline
-	object as an measure of beach width. Beach width then inflences the rate of cliff reterat
+	object as an measure of beach width. Beach width then inflences the rate of cliff reterat.
+	The beach segments are indexed with a SegmentGrid, so the nearest is found wherever it
+	is along the beach. Nodes beyond the ends of the beach have no beach.
 	@param Coastline Coastline, the Coastline object
 	@author Martin D. Hurst
 	@date 2/2/2016 */
-	void DetermineBeachWidth(Coastline Coastline);
+	void DetermineBeachWidth(const Coastline& Coastline);
 	
 	/* @brief Erode the Cliffline
 	@details Function to calculate how much cliff to erode, and move the cliffline. Cliff erosion is a 
 	function of	beach width following Valvo et al (2006) OR Limber and Murray (2011). Eroded material 
-	is supplied to the nearest adjacent beach cell in the coastline object.
+	is supplied to the nearest adjacent beach cell in the coastline object, less the LostFraction, through
+	Coastline::SupplySediment and so is added to the beach in the next call to TransportSediment.
 	@param TimeDelta double, the time step length (days)
 	@param LostFraction, double, the fraction of cliff material lost instantly to the sea (in suspension).
 	@param ErosionType, integer, flag for Valvo et al. (2006) style cliffs (ErosionType = 1)
 	@author Martin D. Hurst
 	@date 4/1/2016 */
-	void ErodeCliff(double &TimeDelta, Coastline MyCoastline, int ErosionType);
+	void ErodeCliff(double &TimeDelta, Coastline& MyCoastline, int ErosionType);
+
+	/* @brief Accumulate cliff erosion without moving the cliff
+	@details For multi-rate stepping, when the cliff is updated less often than the beach
+	(see CoastCliffSystem::SetCliffTimeDelta). Called after each beach step, it adds the
+	retreat over TimeDelta to PendingChange and supplies the eroded volume to the beach
+	straight away, so the beach sees the same supply as with ErodeCliff. The rate is found
+	from the beach width this step, integrating the rate rather than averaging the width
+	since the erosion laws are nonlinear in width. Morphology and the full search for the
+	nearest beach are only done on the first call after the cliff moves, or if the beach
+	has been remeshed, otherwise each node's beach width is updated from the beach
+	segments around the last nearest one.
+	@param TimeDelta double, the time step length (days)
+	@param MyCoastline Coastline, the beach in front of the cliff
+	@param ErosionType int, 1 = Valvo et al. (2006), 2 = Limber and Murray (2011)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void AccumulateErosion(double TimeDelta, Coastline& MyCoastline, int ErosionType);
+
+	/* @brief Move the cliff by the erosion accumulated since the last update
+	@details Moves each node by its PendingChange, as ErodeCliff, then checks for
+	intersections and node spacing. The volume has already been supplied to the beach
+	by AccumulateErosion so the volume lost by the cliff and gained by the beach match.
+	Does nothing if there is no erosion pending.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void ApplyErosion();
 
 	/* @brief Determine amount of cliff retreat
 	@details Calculate how much cliff to erode following Limber and Murray (2011).
@@ -275,7 +357,7 @@ class Cliffline
 	@param LostFraction  double, The fraction of material lost
 	@author Martin D. Hurst
 	@date 14/1/2016 */
-  void SetLostFraction(double LostFraction) {LostFraction = LostFraction;}
+  void SetLostFraction(double LostFraction) {this->LostFraction = LostFraction;}
 
 	/*****************************************\
 	| Get Functions to return private members |
@@ -348,6 +430,16 @@ class Cliffline
   /// @date 4/1/2016
 	int get_MeanNodeSpacing() const				{return MeanNodeSpacing;}	//get average spacing between nodes (m)
 
+	/// @brief Return 1 if erosion has been accumulated but not yet applied to the cliff position.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_ErosionIsPending() const				{return ErosionIsPending;}
+
+	/// @brief Return the number of nodes added or removed by the last node spacing check.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoRemeshOperations() const				{return NoRemeshOperations;}
+
 };
 
 #endif
@@ -0,0 +1,93 @@
+/*==============================================================
+
+coastcliffsystem.cpp
+
+The coupled coast and cliff system
+couples a coastline object to the cliffline object that
+backs it, stepping the two together each timestep.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+#ifndef coastcliffsystem_CPP
+#define coastcliffsystem_CPP
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "coastline.hpp"
+#include "cliffline.hpp"
+#include "waveclimate.hpp"
+#include "coastcliffsystem.hpp"
+
+using namespace std;
+
+void CoastCliffSystem::Step(double &TimeDelta, Wave TheWave)
+{
+	//Move sediment along the beach, taking up anything the cliff supplied last step
+	Coast.TransportSediment(TimeDelta, TheWave, Cliff);
+
+	//Erode the cliff over the (possibly reduced) timestep and supply the beach
+	if (CliffTimeDelta <= 0)
+	{
+		Cliff.ErodeCliff(TimeDelta, Coast, ErosionType);
+		++NoCliffUpdates;
+		return;
+	}
+
+	//Multi-rate, supply the beach now but only move the cliff every CliffTimeDelta
+	Cliff.AccumulateErosion(TimeDelta, Coast, ErosionType);
+	CliffElapsedTime += TimeDelta;
+	if (CliffElapsedTime < CliffTimeDelta*(1.-1e-9)) return;
+	if (Cliff.get_ErosionIsPending() == 1)
+	{
+		Cliff.ApplyErosion();
+		++NoCliffUpdates;
+	}
+	CliffElapsedTime = 0;
+}
+
+void CoastCliffSystem::UpdateCliff()
+{
+	//doesn't restart the interval, so output doesn't change when the cliff next moves
+	if (Cliff.get_ErosionIsPending() == 0) return;
+	Cliff.ApplyErosion();
+	++NoCliffSyncs;
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*==============================================================
+
+coastcliffsystem.hpp
+
+The coupled coast and cliff system
+couples a coastline object to the cliffline object that
+backs it, stepping the two together each timestep.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file coastcliffsystem.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief coupled coastline and cliffline step
+@details This file contains the CoastCliffSystem object, which holds
+references to a coastline and the cliffline behind it and advances both
+through a model timestep. Neither object is copied: the beach reads the
+cliff position to measure beach width and the cliff passes its eroded
+sediment to the beach through the coastline's sediment supply buffer.
+@date 16/10/2026
+*/
+
+#ifndef coastcliffsystem_HPP
+#define coastcliffsystem_HPP
+
+#include <string>
+#include <vector>
+#include "waveclimate.hpp"
+#include "coastline.hpp"
+#include "cliffline.hpp"
+
+using namespace std;
+
+/// @brief coupled coastline and cliffline object.
+/// @details Holds references to a Coastline and the Cliffline that backs it
+/// and steps them together. Each Step transports sediment along the beach,
+/// taking up any cliff sediment supplied during the previous step, then erodes
+/// the cliff against the updated beach width, supplying the eroded volume to
+/// the beach for the next step. Both objects must outlive the system.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class CoastCliffSystem
+{
+	private:
+	//data members
+	Coastline& Coast;		//The beach
+	Cliffline& Cliff;		//The cliff behind the beach
+	int ErosionType;		//Cliff erosion law, 1 = Valvo et al. (2006), 2 = Limber and Murray (2011)
+	double CliffTimeDelta;	//Interval between moves of the cliff (days), 0 = every step
+	double CliffElapsedTime;	//Time since the cliff last moved (days)
+	int NoCliffUpdates;		//Number of times the cliff has moved in Step
+	int NoCliffSyncs;		//Number of times UpdateCliff has moved the cliff between moves in Step
+
+	public:
+
+	/* @brief Creates a coupled system from a coastline and cliffline
+	@param TheCoast Coastline, the coastline object
+	@param TheCliff Cliffline, the cliffline object backing TheCoast
+	@param TheErosionType int, cliff erosion law (1 = Valvo et al. 2006, 2 = Limber and Murray 2011)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	CoastCliffSystem(Coastline& TheCoast, Cliffline& TheCliff, int TheErosionType)
+		: Coast(TheCoast), Cliff(TheCliff), ErosionType(TheErosionType),
+		  CliffTimeDelta(0), CliffElapsedTime(0), NoCliffUpdates(0), NoCliffSyncs(0) {}
+
+	/* @brief Advance the coast and cliff through one timestep
+	@details Calls Coastline::TransportSediment then Cliffline::ErodeCliff. If the
+	coast has to reduce the timestep, TimeDelta is returned reduced and the cliff
+	is eroded over the same reduced timestep. With a CliffTimeDelta set the cliff
+	only accumulates its erosion each step (Cliffline::AccumulateErosion) and is
+	moved once CliffTimeDelta has passed (Cliffline::ApplyErosion).
+	@param TimeDelta double, the model timestep (days), may be reduced
+	@param TheWave Wave, the offshore wave for this step
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void Step(double &TimeDelta, Wave TheWave);
+
+	/* @brief Move the cliff by any erosion accumulated since it last moved
+	@details Call before writing the cliff to file or at the end of a run so the
+	cliff position is up to date with the beach. The cliff still next moves in Step
+	CliffTimeDelta after it last moved there, so output doesn't change the cadence,
+	and these moves are counted separately (get_NoCliffSyncs).
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void UpdateCliff();
+
+	/* @brief Set how often the cliff is moved
+	@details Cliff retreat is orders of magnitude slower than changes in the beach,
+	so the cliff can be moved much less often than the beach is stepped. Between
+	moves the erosion is accumulated against the beach width of every step and
+	its sediment supplied to the beach as it is eroded.
+	@param NewCliffTimeDelta double, interval between moves of the cliff (days), 0 = every step
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetCliffTimeDelta(double NewCliffTimeDelta) { CliffTimeDelta = NewCliffTimeDelta; }
+
+	/* @brief Set the cliff erosion law
+	@param TheErosionType int, 1 = Valvo et al. (2006), 2 = Limber and Murray (2011)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetErosionType(int TheErosionType) { ErosionType = TheErosionType; }
+
+	/// @brief Return the cliff erosion law
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_ErosionType() const { return ErosionType; }
+
+	/// @brief Return the interval between moves of the cliff (days)
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	double get_CliffTimeDelta() const { return CliffTimeDelta; }
+
+	/// @brief Return the number of times the cliff has moved in Step
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoCliffUpdates() const { return NoCliffUpdates; }
+
+	/// @brief Return the number of times UpdateCliff has moved the cliff
+	int get_NoCliffSyncs() const { return NoCliffSyncs; }
+};
+
+#endif
@@ -60,10 +60,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "coastline.hpp"
 #include "cliffline.hpp"
 #include "waveclimate.hpp"
+#include "transportpolicies.hpp"
 #include "global_variables.hpp"
 
 using namespace std;
 
+NodeColumn<double> NodeStore::* const Coastline::MeshColumns[Coastline::NoMeshColumns] =
+{
+	&NodeStore::X, &NodeStore::Y, &NodeStore::XL, &NodeStore::YL, &NodeStore::XR, &NodeStore::YR,
+	&NodeStore::Orientation, &NodeStore::LeftOrientation, &NodeStore::RightOrientation,
+	&NodeStore::e1, &NodeStore::e2, &NodeStore::CellWidth,
+	&NodeStore::X0, &NodeStore::Y0, &NodeStore::Dsf, &NodeStore::Area
+};
+
 /********************************************
 * Coastline Object Initialisation Functions *
 ********************************************/
@@ -75,6 +84,60 @@ void Coastline::Initialise()
 	printf("\nCoastline.Initialise: Error, initialised an empty Coastline object\n");
 	exit(EXIT_FAILURE);
 }
+
+/**Sets the default values of the optional settings, called by each of the initialisers.
+* MDH 16/10/26 */
+void Coastline::SetDefaults()
+{
+	MeshTolerance = 0;
+	MeshDebugFlag = 0;
+	MeshTopologyVersion = -1;
+	NoMeshBuilds = 0;
+	NoMeshReuses = 0;
+	MeshHalo = 10;
+	NoWindowedMeshBuilds = 0;
+	MaxWindowDsfError = 0;
+	MaxWindowAreaError = 0;
+	NoWindowRecieverErrors = 0;
+	NoRemeshOperations = 0;
+	WaveTransformMethod = 0;
+	WaveTableTolerance = 0.001;
+	WaveCacheTolerance = 0;
+	WaveCachePeriod = -9999;
+	WaveCacheMethod = -1;
+	WaveCacheTableTolerance = -9999;
+	ShadowTopologyVersion = -1;
+	ShadowWaveHeight = -9999;
+	ShadowWavePeriod = -9999;
+	ShadowWaveDirection = -9999;
+	ShadowRefDiffFlag = -1;
+	NoWaveCacheHits = 0;
+	NoWaveCacheMisses = 0;
+	NoShadowCacheHits = 0;
+	NoShadowCacheMisses = 0;
+	NoThreads = 0;
+	NoGhostLayers = 1;
+	FluxFunction = AlphaFunction = BoundaryFunction = BreakingFunction = 0;
+	PolicyFluxType = PolicyStartBoundary = PolicyEndBoundary = PolicyWaveTransformMethod = -9999;
+	AdaptiveTimeStep = 0;
+	SemiImplicitDiffusion = 0;
+	StableTimeDelta = 9999.;
+	StepControl = TimeStepController();
+}
+
+/**Number of threads for a per-node loop, short coasts aren't worth splitting.
+* MDH 16/10/26 */
+int Coastline::GetNoThreads() const
+{
+#ifdef _OPENMP
+	const int MinParallelNodes = 400;
+	if (NoNodes < MinParallelNodes) return 1;
+	if (NoThreads > 0) return NoThreads;
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
 /**Initialise the coastline with an xyfile. File format is a headerline containing the start and end boundary
 conditions (white-space delimited) followed by paired rows in which the first element is Time followed by a
 vector of x and y respectively with which to initialise the coastline object. Since no start time is specified
@@ -83,6 +146,8 @@ this initialiser defaults to StartTime=0
 void Coastline::Initialise(string xyfilename)
 {
 
+	SetDefaults();
+
 	/*	Read coastline.XY text file */
 	cout << "Coastline.Initialise: Initialising Coastline from XY file: " << xyfilename << endl;
 	;
@@ -91,43 +156,7 @@ void Coastline::Initialise(string xyfilename)
 	ReadCoast(xyfilename, Time);
 
 	//Populate empty vectors
-	vector<double> EmptyVector(NoNodes, -9999);
-	Distance = EmptyVector;
-	Orientation = EmptyVector;
-	FluxOrientation = EmptyVector;
-	LeftOrientation = EmptyVector;
-	RightOrientation = EmptyVector;
-	BreakingWaveHeight = EmptyVector;
-	BreakingWaveAngle = EmptyVector;
-	CellWidth = EmptyVector;
-	LongshoreFlux = EmptyVector;
-	VolumeChange = EmptyVector;
-	VolumeIn = EmptyVector;
-	VolumeOut = EmptyVector;
-	MinVolumeChange = EmptyVector;
-	PositionChange = EmptyVector;
-	BeachWidth = EmptyVector;
-	Shadows = EmptyVector;
-	ShadowZoneWaveDirection = EmptyVector;
-	ShadowZoneWaveHeight = EmptyVector;
-	e1 = EmptyVector;
-	e2 = EmptyVector;
-	X0 = EmptyVector;
-	Y0 = EmptyVector;
-	XL = EmptyVector;
-	YL = EmptyVector;
-	XR = EmptyVector;
-	YR = EmptyVector;
-	Area = EmptyVector;
-	Dsf = EmptyVector;
-
-	vector< vector<Node> > EmptyNodes(NoNodes);
-	Vertices = EmptyNodes;
-	vector< vector<CoastNode> > EmptyCoastNodes(NoNodes);
-	Recievers = EmptyCoastNodes;
-
-	vector<int> Zeros(NoNodes, 0);
-	Fixed = Zeros;
+	ResizeNodes(NoNodes);
 
 	// These are default values, to change them, use the "set" functions defined in coastline.hpp in your driver file
 	ClosureDepth = 10.;			//NEED TO FIND SOMEWHERE BETTER TO DEFINE THESE
@@ -157,50 +186,14 @@ initialisation of a coastline from previous model output.
 void Coastline::Initialise(string xyfilename, float StartTime)
 {
 
+	SetDefaults();
+
 	/*	Read coastline.XY text file */
 	cout << "Coastline.Initialise: Initialising Coastline from XY file: " << xyfilename << " at Time: " << StartTime << endl;
 	ReadCoast(xyfilename, StartTime);
 
 	//Populate empty vectors
-	vector<double> EmptyVector(NoNodes, -9999);
-	Distance = EmptyVector;
-	Orientation = EmptyVector;
-	FluxOrientation = EmptyVector;
-	LeftOrientation = EmptyVector;
-	RightOrientation = EmptyVector;
-	BreakingWaveHeight = EmptyVector;
-	BreakingWaveAngle = EmptyVector;
-	CellWidth = EmptyVector;
-	LongshoreFlux = EmptyVector;
-	VolumeChange = EmptyVector;
-	VolumeIn = EmptyVector;
-	VolumeOut = EmptyVector;
-	MinVolumeChange = EmptyVector;
-	PositionChange = EmptyVector;
-	BeachWidth = EmptyVector;
-	Shadows = EmptyVector;
-	ShadowZoneWaveDirection = EmptyVector;
-	ShadowZoneWaveHeight = EmptyVector;
-	e1 = EmptyVector;
-	e2 = EmptyVector;
-	Volume = EmptyVector;
-	Area = EmptyVector;
-	Dsf = EmptyVector;
-
-	vector< vector<Node> > EmptyNodes(NoNodes);
-	Vertices = EmptyNodes;
-	vector< vector<CoastNode> > EmptyCoastNodes(NoNodes);
-	Recievers = EmptyCoastNodes;
-
-	X0 = EmptyVector;
-	Y0 = EmptyVector;
-	XL = EmptyVector;
-	XR = EmptyVector;
-	YL = EmptyVector;
-	YR = EmptyVector;
-
-	vector<int> Zeros(NoNodes, 0);
-	Fixed = Zeros;
+	ResizeNodes(NoNodes);
 
 	if (StartBoundary == 2) Fixed[0] = 1, Fixed[1] = 1;
 	if (EndBoundary == 2) Fixed[NoNodes-1] = 1, Fixed[NoNodes-2] = 1;
@@ -232,8 +225,9 @@ the mean node spacing (in metres) the total length of the coast (in metres), the
 (azimuth direction with sea to the left as you look down this line) and the type of start and end boundary
 conditions.
 * MDH 6/1/14 */
-void Coastline::Initialise(int NodeSpacing, double CoastLength, double TheTrend, int StartBoundaryInput, int EndBoundaryInput)
+void Coastline::Initialise(int NodeSpacing, double CoastLength, double TheTrend, int StartBoundaryInput, int EndBoundaryInput, unsigned long long NoiseSeed)
 {
+	SetDefaults();
 
 	/*	Initialises the coast as a straight segment with low amplitude noise
 		Coast has a fixed length and an orientation/trend. Coordinates of the
@@ -258,6 +252,7 @@ void Coastline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 	MeanNodeSpacing = (double)NodeSpacing;
 	DesiredNodeSpacing = MeanNodeSpacing;
     double NoiseAmplitude = (MeanNodeSpacing/10.);
+	RandomStream Noise(NoiseSeed); //Own stream, so the same seed gives the same line
 
 	//initialise coast
 	while (Dist<CoastLength-MeanNodeSpacing)
@@ -283,8 +278,8 @@ void Coastline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 			else
 			{
         //sort out random addition
-	      tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
-	      tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
+	      tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
+	      tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
 	      X.push_back(tempX);
 	      Y.push_back(tempY);
 	      NoNodes += 1;
@@ -294,8 +289,8 @@ void Coastline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
 		else
 		{
 			//sort out random addition
-			tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
-			tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+((double)rand()/RAND_MAX));
+			tempX = tempX + MeanNodeSpacing*sin(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
+			tempY = tempY + MeanNodeSpacing*cos(Trend*M_PI/180) + NoiseAmplitude*(-0.5+Noise.Uniform());
 			X.push_back(tempX);
 			Y.push_back(tempY);
 			NoNodes += 1;
@@ -321,45 +316,7 @@ void Coastline::Initialise(int NodeSpacing, double CoastLength, double TheTrend,
   }
 
 	//Populate empty vectors
-	vector<double> EmptyVector(NoNodes, -9999);
-	Distance = EmptyVector;
-	Orientation = EmptyVector;
-	FluxOrientation = EmptyVector;
-	LeftOrientation = EmptyVector;
-	RightOrientation = EmptyVector;
-	BreakingWaveHeight = EmptyVector;
-	BreakingWaveAngle = EmptyVector;
-	Shadows = EmptyVector;
-	ShadowZoneWaveDirection = EmptyVector;
-	ShadowZoneWaveHeight = EmptyVector;
-	CellWidth = EmptyVector;
-	LongshoreFlux = EmptyVector;
-	VolumeChange = EmptyVector;
-	VolumeIn = EmptyVector;
-	VolumeOut = EmptyVector;
-	MinVolumeChange = EmptyVector;
-	PositionChange = EmptyVector;
-	BeachWidth = EmptyVector;
-	e1 = EmptyVector;
-	e2 = EmptyVector;
-	Volume = EmptyVector;
-	Area = EmptyVector;
-	Dsf = EmptyVector;
-
-	vector< vector<Node> > EmptyNodes(NoNodes);
-	Vertices = EmptyNodes;
-	vector< vector<CoastNode> > EmptyCoastNodes(NoNodes);
-	Recievers = EmptyCoastNodes;
-
-	X0 = EmptyVector;
-	Y0 = EmptyVector;
-	XL = EmptyVector;
-	XR = EmptyVector;
-	YL = EmptyVector;
-	YR = EmptyVector;
-
-	vector<int> Zeros(NoNodes, 0);
-	Fixed = Zeros;
+	ResizeNodes(NoNodes);
 
 	if (StartBoundary == 2) Fixed[0] = 1, Fixed[1] = 1;
 	if (EndBoundary == 2) Fixed[NoNodes-1] = 1, Fixed[NoNodes-2] = 1;
@@ -533,12 +490,11 @@ void Coastline::UpdateMorphology()
 	****************************************************************/
 
 	//Reset vectors
-	vector<double> EmptyVector(NoNodes,-9999);
 	double dX, dY, LeftDiff, RightDiff, SpatialGradient;
 
-	FluxOrientation = EmptyVector;
-	CellWidth = EmptyVector;
-	Distance = EmptyVector;
+	ResetWorkspace(FluxOrientation, -9999.);
+	ResetWorkspace(CellWidth, -9999.);
+	ResetWorkspace(Distance, -9999.);
 
 	for (int i=0; i<NoNodes; ++i)
 	{
@@ -649,34 +605,29 @@ void Coastline::CalculateMorphology()
 	double LeftDiff, RightDiff;
 	double SpatialGradient;
 
-	//Reset all vectors (could builda function for this)
-	vector<double> EmptyVector(NoNodes,-9999);
-	Distance = EmptyVector;
-	Orientation = EmptyVector;
-	FluxOrientation = EmptyVector;
-	LeftOrientation = EmptyVector;
-	RightOrientation = EmptyVector;
-	CellWidth = EmptyVector;
-	BreakingWaveHeight = EmptyVector;
-	BreakingWaveAngle = EmptyVector;
-	VolumeChange = EmptyVector;
-	VolumeIn = EmptyVector;
-	VolumeOut = EmptyVector;
-	MinVolumeChange = EmptyVector;
-	PositionChange = EmptyVector;
-	BeachWidth = EmptyVector;
-	LongshoreFlux = EmptyVector;
-	e1 = EmptyVector;
-	e2 = EmptyVector;
-	Volume = EmptyVector;
-	Dsf = EmptyVector;
-	Area = EmptyVector;
-	X0 = EmptyVector;
-	Y0 = EmptyVector;
-	XL = EmptyVector;
-	XR = EmptyVector;
-	YL = EmptyVector;
-	YR = EmptyVector;
+	//Reset all vectors in place
+	ResetWorkspace(Distance, -9999.);
+	ResetWorkspace(Orientation, -9999.);
+	ResetWorkspace(FluxOrientation, -9999.);
+	ResetWorkspace(LeftOrientation, -9999.);
+	ResetWorkspace(RightOrientation, -9999.);
+	ResetWorkspace(CellWidth, -9999.);
+	ResetWorkspace(BreakingWaveHeight, -9999.);
+	ResetWorkspace(BreakingWaveAngle, -9999.);
+	ResetWorkspace(VolumeChange, -9999.);
+	ResetWorkspace(VolumeIn, -9999.);
+	ResetWorkspace(VolumeOut, -9999.);
+	ResetWorkspace(MinVolumeChange, -9999.);
+	ResetWorkspace(PositionChange, -9999.);
+	ResetWorkspace(BeachWidth, -9999.);
+	ResetWorkspace(LongshoreFlux, -9999.);
+	ResetWorkspace(e1, -9999.);
+	ResetWorkspace(e2, -9999.);
+	ResetWorkspace(Volume, -9999.);
+	ResetWorkspace(XL, -9999.);
+	ResetWorkspace(XR, -9999.);
+	ResetWorkspace(YL, -9999.);
+	ResetWorkspace(YR, -9999.);
 
 	BuildCellsFlag = 0;
 
@@ -751,7 +702,6 @@ void Coastline::CalculateMorphology()
         XR[i] = X[i]+RightDiff*cos((M_PI/180.)*(Orientation[i]-90.));
         YR[i] = Y[i]-RightDiff*sin((M_PI/180.)*(Orientation[i]-90.));
         CellWidth[i] = 2.*RightDiff;
-        Dsf[i] = ClosureDepth;
 			}
 		}
 
@@ -781,14 +731,9 @@ void Coastline::CalculateMorphology()
 				//Cell Width parallel to orientation AT the node position
 				CellWidth[i] = LeftDiff+RightDiff;
 
-				//Flag triangles and calculate mass of sand assuming a fixed beach width
-				//Get effective shoreface depth
-				Dsf[i] = -(CellWidth[i]*ShorefaceSlope)/(tan((M_PI/180.)*e1[i]) + tan((M_PI/180.)*e2[i]));
-				if (Dsf[i] > ClosureDepth || Dsf[i] < 0) Dsf[i] = ClosureDepth;
-
+				//shoreface depth is found when the cells are built
 				e1[0] = e1[i];
 				CellWidth[0] = CellWidth[i];
-				Dsf[0] = Dsf[i];
 			}
 
 			//FIXED BOUNDARY
@@ -808,77 +753,242 @@ void Coastline::CalculateMorphology()
         XR[i] = X[i]+RightDiff*cos((M_PI/180.)*(Orientation[i]-90.));
         YR[i] = Y[i]-RightDiff*sin((M_PI/180.)*(Orientation[i]-90.));
         CellWidth[i] = 2.*RightDiff;
-        Dsf[i] = ClosureDepth;
 			}
 		}
 		//Finally do all the bits inbetween
-		else
+		else CalculateNodeMorphology(i);
+  }
+
+  //Only rebuild the cells round nodes that have moved or changed convexity, or all of them if nodes were added/removed
+  UpdateMesh();
+  BuildCellsFlag = 0;
+}
+
+void Coastline::CalculateNodeMorphology(int i)
+{
+	//declare some temporary variables
+	double dX, dY;
+	double LeftDiff, RightDiff;
+	double SpatialGradient;
+
+	//First get flux orientation (2-node)
+	dX = X[i+1]-X[i];
+	dY = Y[i+1]-Y[i];
+	Distance[i+1] = Distance[i] + sqrt(dX*dX + dY*dY);
+
+	//don't allow divide by zero, just make spatial gradient very large
+	if (dX == 0) dX = 0.0001;
+	SpatialGradient = dY/dX;
+	//convert to azimuths
+	if (dX == 0 && dY < 0) FluxOrientation[i] = 180.;
+	else if (dX == 0 && dY > 0) FluxOrientation[i] = 0.;
+	else if (dX > 0) FluxOrientation[i] = (180./M_PI)*(M_PI*0.5 - atan(SpatialGradient));
+	else if (dX < 0) FluxOrientation[i] = (180./M_PI)*(M_PI*1.5 - atan(SpatialGradient));
+	else
+	{
+		printf("Failed to compute cell flux orientation in %s at line %d\n",__func__,__LINE__);
+		exit(EXIT_FAILURE);
+	}
+
+	//Next get curvature and orientation (3-node)
+	dX = (X[i+1]-X[i-1]);
+	dY = (Y[i+1]-Y[i-1]);
+	//convert to azimuths
+	if (dX == 0 && dY < 0) Orientation[i] = 180.;
+	else if (dX == 0 && dY > 0) Orientation[i] = 0.;
+	else if (dX > 0) Orientation[i] = (180./M_PI)*(M_PI*0.5 - atan(dY/dX));
+	else if (dX < 0) Orientation[i] = (180./M_PI)*(M_PI*1.5 - atan(dY/dX));
+	else
+	{
+		printf("Failed to compute cell orientation in %s at line %d\n",__func__,__LINE__);
+		//exit(EXIT_FAILURE);
+	}
+
+	//Get cell geometry angles
+	if ((Orientation[i] > 270) && (FluxOrientation[i-1] < 90)) e1[i] = Orientation[i]-360.-FluxOrientation[i-1];
+	else e1[i] = Orientation[i]-FluxOrientation[i-1];
+	e2[i] = FluxOrientation[i] - Orientation[i];
+	if (e2[i] < -180) e2[i] += 360;
+	if (e1[i] < -180) e1[i] += 360;
+	LeftOrientation[i] = Orientation[i]-90-e1[i];
+	RightOrientation[i] = Orientation[i]-90+e2[i];
+
+	if (LeftOrientation[i]<0) LeftOrientation[i]+=360;
+	if (RightOrientation[i]<0) RightOrientation[i]+=360;
+	if (LeftOrientation[i]>360) LeftOrientation[i]-=360;
+	if (RightOrientation[i]>360) RightOrientation[i]-=360;
+
+	//Get MidPoints
+	LeftDiff = (0.5*sqrt((X[i]-X[i-1])*(X[i]-X[i-1]) + ((Y[i]-Y[i-1])*(Y[i]-Y[i-1]))))/cos((M_PI/180.)*(e1[i]));
+	RightDiff = (0.5*sqrt((X[i+1]-X[i])*(X[i+1]-X[i]) + ((Y[i+1]-Y[i])*(Y[i+1]-Y[i]))))/cos((M_PI/180.)*(-e2[i]));
+	XL[i] = X[i]-LeftDiff*cos((M_PI/180.)*(Orientation[i]-90.));
+	YL[i] = Y[i]+LeftDiff*sin((M_PI/180.)*(Orientation[i]-90.));
+	XR[i] = X[i]+RightDiff*cos((M_PI/180.)*(Orientation[i]-90.));
+	YR[i] = Y[i]-RightDiff*sin((M_PI/180.)*(Orientation[i]-90.));
+
+	//Cell Width parallel to orientation AT the node position
+	CellWidth[i] = (0.5*sqrt(pow(X[i]-X[i-1],2.0) + pow(Y[i]-Y[i-1],2.0)))/cos(M_PI/180.*(Orientation[i]-FluxOrientation[i-1]));
+	CellWidth[i] += (0.5*sqrt(pow(X[i+1]-X[i],2.0) + pow(Y[i+1]-Y[i],2.0)))/cos(M_PI/180.*(Orientation[i]-FluxOrientation[i]));
+
+	//Get cell width at bottom of the shoreface
+	//Wb = CellWidth[i] + (ClosureDepth/ShorefaceSlope)*(tan((M_PI/180.)*e1[i]) + tan((M_PI/180.)*e2[i]));
+}
+
+void Coastline::UpdateMesh()
+{
+	int NoWindowNodes = (MeshTopologyVersion == TopologyVersion) ? FindMeshWindows() : NoNodes;
+
+	//rebuilding windows over most of the coast costs more than rebuilding it all
+	if (2*NoWindowNodes > NoNodes)
+	{
+		BuildCellGeometries();
+		SaveMeshState(0, NoNodes-1);
+		++NoMeshBuilds;
+	}
+	else if (NoWindowNodes == 0)
+	{
+		++NoMeshReuses;
+		if (MeshDebugFlag == 1) CheckMeshReuse();
+	}
+	else
+	{
+		for (int w=0, n=MeshWindows.size(); w<n; w+=2) BuildMeshWindow(MeshWindows[w], MeshWindows[w+1]);
+		Vertices.Compact();
+		Recievers.Compact();
+		++NoWindowedMeshBuilds;
+		if (MeshDebugFlag == 1) CheckMeshReuse();
+	}
+}
+
+int Coastline::FindMeshWindows()
+{
+	MeshWindows.clear();
+	ReserveWorkspace(MeshWindows, 2*NoNodes);
+	int Width = 2*MeshHalo;
+	for (int i=0; i<NoNodes; ++i)
+	{
+		if (fabs(X[i]-MeshX[i]) > MeshTolerance || fabs(Y[i]-MeshY[i]) > MeshTolerance || MeshConvex[i] != (e1[i] > 0) + 2*(e2[i] > 0))
 		{
-			//First get flux orientation (2-node)
-			dX = X[i+1]-X[i];
-			dY = Y[i+1]-Y[i];
-			Distance[i+1] = Distance[i] + sqrt(dX*dX + dY*dY);
+			//the end nodes are built differently, and on a periodic coast are the same cell
+			int First = i-Width, Last = i+Width;
+			if (MeshHalo < 0 || First < 1 || Last > NoNodes-2) return NoNodes;
+			if (!MeshWindows.empty() && First <= MeshWindows.back()+1) MeshWindows.back() = Last;
+			else MeshWindows.push_back(First), MeshWindows.push_back(Last);
+		}
+	}
 
-			//don't allow divide by zero, just make spatial gradient very large
-			if (dX == 0) dX = 0.0001;
-			SpatialGradient = dY/dX;
-			//convert to azimuths
-			if (dX == 0 && dY < 0) FluxOrientation[i] = 180.;
-			else if (dX == 0 && dY > 0) FluxOrientation[i] = 0.;
-			else if (dX > 0) FluxOrientation[i] = (180./M_PI)*(M_PI*0.5 - atan(SpatialGradient));
-			else if (dX < 0) FluxOrientation[i] = (180./M_PI)*(M_PI*1.5 - atan(SpatialGradient));
-			else
-			{
-				printf("Failed to compute cell flux orientation in %s at line %d\n",__func__,__LINE__);
-			  exit(EXIT_FAILURE);
-			}
+	int NoWindowNodes = 0;
+	for (int w=0, n=MeshWindows.size(); w<n; w+=2) NoWindowNodes += MeshWindows[w+1]-MeshWindows[w]+1;
+	return NoWindowNodes;
+}
 
-			//Next get curvature and orientation (3-node)
-			dX = (X[i+1]-X[i-1]);
-			dY = (Y[i+1]-Y[i-1]);
-			//convert to azimuths
-			if (dX == 0 && dY < 0) Orientation[i] = 180.;
-			else if (dX == 0 && dY > 0) Orientation[i] = 0.;
-			else if (dX > 0) Orientation[i] = (180./M_PI)*(M_PI*0.5 - atan(dY/dX));
-			else if (dX < 0) Orientation[i] = (180./M_PI)*(M_PI*1.5 - atan(dY/dX));
-			else
-			{
-			  printf("Failed to compute cell orientation in %s at line %d\n",__func__,__LINE__);
-			  //exit(EXIT_FAILURE);
-			}
+void Coastline::BuildMeshWindow(int First, int Last)
+{
+	//swap the window in for the whole coast
+	int NoWindowNodes = Last-First+1;
+	for (int c=0; c<NoMeshColumns; ++c)
+	{
+		NodeColumn<double>& Column = this->*MeshColumns[c];
+		WindowColumns[c].resize(NoWindowNodes, -9999.);
+		copy(Column.begin()+First, Column.begin()+Last+1, WindowColumns[c].begin());
+		Column.swap(WindowColumns[c]);
+	}
+	Vertices.swap(WindowVertices);
+	Recievers.swap(WindowRecievers);
+	int CoastNoNodes = NoNodes, CoastStartBoundary = StartBoundary, CoastEndBoundary = EndBoundary;
+	NoNodes = NoWindowNodes, StartBoundary = 2, EndBoundary = 2;
+
+	BuildCellGeometries();
+
+	//swap the coast back, leaving the window's cells in the window columns
+	NoNodes = CoastNoNodes, StartBoundary = CoastStartBoundary, EndBoundary = CoastEndBoundary;
+	for (int c=0; c<NoMeshColumns; ++c) (this->*MeshColumns[c]).swap(WindowColumns[c]);
+	Vertices.swap(WindowVertices);
+	Recievers.swap(WindowRecievers);
+
+	//keep the cells far enough from the ends of the window to be unaffected by them.
+	//The build also changes Left/RightOrientation, but only uses them while building,
+	//so they are left as CalculateMorphology found them, as for a reused mesh
+	for (int i=First+MeshHalo; i<=Last-MeshHalo; ++i)
+	{
+		int j = i-First;
+		for (int c=NoMeshInputColumns; c<NoMeshColumns; ++c) (this->*MeshColumns[c])[i] = WindowColumns[c][j];
+		Vertices.CopyCell(i, WindowVertices, j);
+		Recievers.CopyCell(i, WindowRecievers, j);
+		for (int k=0, n=Recievers[i].size(); k<n; ++k) Recievers[i][k].i += First;
+	}
+	SaveMeshState(First+MeshHalo, Last-MeshHalo);
+}
 
-      //Get cell geometry angles
-      if ((Orientation[i] > 270) && (FluxOrientation[i-1] < 90)) e1[i] = Orientation[i]-360.-FluxOrientation[i-1];
-      else e1[i] = Orientation[i]-FluxOrientation[i-1];
-      e2[i] = FluxOrientation[i] - Orientation[i];
-      if (e2[i] < -180) e2[i] += 360;
-      if (e1[i] < -180) e1[i] += 360;
-      LeftOrientation[i] = Orientation[i]-90-e1[i];
-      RightOrientation[i] = Orientation[i]-90+e2[i];
-
-		if (LeftOrientation[i]<0) LeftOrientation[i]+=360;
-      if (RightOrientation[i]<0) RightOrientation[i]+=360;
-      if (LeftOrientation[i]>360) LeftOrientation[i]-=360;
-      if (RightOrientation[i]>360) RightOrientation[i]-=360;
-      
-      //Get MidPoints
-      LeftDiff = (0.5*sqrt((X[i]-X[i-1])*(X[i]-X[i-1]) + ((Y[i]-Y[i-1])*(Y[i]-Y[i-1]))))/cos((M_PI/180.)*(e1[i]));
-      RightDiff = (0.5*sqrt((X[i+1]-X[i])*(X[i+1]-X[i]) + ((Y[i+1]-Y[i])*(Y[i+1]-Y[i]))))/cos((M_PI/180.)*(-e2[i]));
-      XL[i] = X[i]-LeftDiff*cos((M_PI/180.)*(Orientation[i]-90.));
-      YL[i] = Y[i]+LeftDiff*sin((M_PI/180.)*(Orientation[i]-90.));
-      XR[i] = X[i]+RightDiff*cos((M_PI/180.)*(Orientation[i]-90.));
-      YR[i] = Y[i]-RightDiff*sin((M_PI/180.)*(Orientation[i]-90.));
-
-      //Cell Width parallel to orientation AT the node position
-      CellWidth[i] = (0.5*sqrt(pow(X[i]-X[i-1],2.0) + pow(Y[i]-Y[i-1],2.0)))/cos(M_PI/180.*(Orientation[i]-FluxOrientation[i-1]));
-      CellWidth[i] += (0.5*sqrt(pow(X[i+1]-X[i],2.0) + pow(Y[i+1]-Y[i],2.0)))/cos(M_PI/180.*(Orientation[i]-FluxOrientation[i]));
-
-      //Get cell width at bottom of the shoreface
-      //Wb = CellWidth[i] + (ClosureDepth/ShorefaceSlope)*(tan((M_PI/180.)*e1[i]) + tan((M_PI/180.)*e2[i]));
-    }
-  }
-  BuildCellGeometries();
-  BuildCellsFlag = 0;
+void Coastline::SaveMeshState(int First, int Last)
+{
+	for (int i=First; i<=Last; ++i)
+	{
+		MeshX[i] = X[i], MeshY[i] = Y[i];
+		MeshConvex[i] = (e1[i] > 0) + 2*(e2[i] > 0);
+	}
+	MeshTopologyVersion = TopologyVersion;
+}
+
+void Coastline::CheckMeshReuse()
+{
+	//keep the current mesh
+	NodeColumn<double> OldX0 = X0, OldY0 = Y0, OldDsf = Dsf, OldArea = Area;
+	NodeColumn<double> OldLeftOrientation = LeftOrientation, OldRightOrientation = RightOrientation;
+	CellArena<CoastNode> OldRecievers = Recievers;
+	CellArena<Node> OldVertices = Vertices;
+
+	//full rebuild for comparison
+	BuildCellGeometries();
+
+	//cells rebuilt in a window, and cells kept from an earlier build
+	double MaxDsfDiff[2] = {0, 0}, MaxAreaDiff[2] = {0, 0};
+	int RecieverDiffs[2] = {0, 0};
+	int Window = 0;
+	for (int i=0; i<NoNodes; ++i)
+	{
+		while (Window < (int)MeshWindows.size() && i > MeshWindows[Window+1]-MeshHalo) Window += 2;
+		int Kept = (Window == (int)MeshWindows.size() || i < MeshWindows[Window]+MeshHalo);
+		MaxDsfDiff[Kept] = max(MaxDsfDiff[Kept], fabs(Dsf[i]-OldDsf[i]));
+		if (Area[i] > 0) MaxAreaDiff[Kept] = max(MaxAreaDiff[Kept], fabs(Area[i]-OldArea[i])/Area[i]);
+		if (Recievers[i].size() != OldRecievers[i].size()) ++RecieverDiffs[Kept];
+		else for (int j=0, n=Recievers[i].size(); j<n; ++j) if (Recievers[i][j].i != OldRecievers[i][j].i) ++RecieverDiffs[Kept], j=n;
+	}
+	MaxWindowDsfError = max(MaxWindowDsfError, MaxDsfDiff[0]);
+	MaxWindowAreaError = max(MaxWindowAreaError, MaxAreaDiff[0]);
+	NoWindowRecieverErrors += RecieverDiffs[0];
+	if (!MeshWindows.empty()) printf("Mesh check in %s: rebuilt cells max Dsf difference %f m, max relative Area difference %f, %d reciever lists differ\n",__func__,MaxDsfDiff[0],MaxAreaDiff[0],RecieverDiffs[0]);
+	printf("Mesh check in %s: reused cells max Dsf difference %f m, max relative Area difference %f, %d reciever lists differ\n",__func__,MaxDsfDiff[1],MaxAreaDiff[1],RecieverDiffs[1]);
+
+	//put the current mesh back so the check doesn't change the run
+	X0 = OldX0, Y0 = OldY0, Dsf = OldDsf, Area = OldArea;
+	LeftOrientation = OldLeftOrientation, RightOrientation = OldRightOrientation;
+	Recievers = OldRecievers;
+	Vertices = OldVertices;
+}
+
+int Coastline::ShadowsAreCurrent()
+{
+	if (WaveCacheTolerance < 0) return 0;
+	if (ShadowTopologyVersion != TopologyVersion) return 0;
+	if (OffshoreWaveHeight != ShadowWaveHeight || OffshoreWavePeriod != ShadowWavePeriod || OffshoreWaveDirection != ShadowWaveDirection) return 0;
+	if (RefDiffFlag != ShadowRefDiffFlag) return 0;
+	for (int i=0; i<NoNodes; ++i)
+	{
+		if (!(fabs(X[i]-ShadowX[i]) <= MeshTolerance) || !(fabs(Y[i]-ShadowY[i]) <= MeshTolerance)) return 0;
+	}
+	return 1;
+}
+
+void Coastline::SaveShadowState()
+{
+	copy(X.begin(), X.end(), ShadowX.begin());
+	copy(Y.begin(), Y.end(), ShadowY.begin());
+	ShadowTopologyVersion = TopologyVersion;
+	ShadowWaveHeight = OffshoreWaveHeight;
+	ShadowWavePeriod = OffshoreWavePeriod;
+	ShadowWaveDirection = OffshoreWaveDirection;
+	ShadowRefDiffFlag = RefDiffFlag;
 }
 
 void Coastline::CheckNodeSpacing()
@@ -886,99 +996,91 @@ void Coastline::CheckNodeSpacing()
 	/* Function to check the spacing bewteen the nodes is optimal and add or delete nodes
 		as appropriate. Where nodes are <0.6*DesiredNodeSpacing a new node interpolated
 		between them will be created. Where nodes are >1.5*DesiredNodeSpacing apart then
-		a new node is created between them		*/
+		a new node is created between them
+
+		Adding or removing a node only moves node i, so only the pair behind it can
+		have changed length. Rather than restarting the check from the start of the
+		coast and recalculating the morphology after every change, step back one pair
+		and carry on, refreshing the cell edges of the nodes either side of the change.
+		The full morphology (and the cells) are recalculated once at the end.	*/
 
 	//declare variables
 	//double OptimalArea = MeanNodeSpacing*(ClosureDepth/ShorefaceSlope);
-	int SpacingFlag = 0;
 	int NodeFlag = 0;
+	int i = 1;
 	double Distance,X0,Y0;//MeanOrientation; //,M1,M2; //, VolumeOld, VolumeNew, VolChange, a, b, c;
-	//need to recalculate morphology and start check again after each new node is added
-	while (SpacingFlag == 0)
+	NoRemeshOperations = 0;
+
+	while (i < NoNodes-2)
 	{
-		for (int i=0; i<NoNodes-1; ++i)
+		Distance = sqrt(pow(X[i+1]-X[i],2.0) + pow(Y[i+1]-Y[i],2.0));
+
+		//if distance between two cells is too small,
+		//replace with a linearly interpolated point between
+		if (Distance < 0.6*DesiredNodeSpacing)
 		{
-			if (i<1 || i>NoNodes-3) continue;
-			if (i == NoNodes-1) {}
+			//if cell is too narrow remove its adjacent nodes
+			//cout << "\nErasing Node" << endl;
+			if ((StartBoundary == 2 && EndBoundary == 2) & (i == 1 || i == NoNodes-3)) {}
 			else
 			{
-				Distance = sqrt(pow(X[i+1]-X[i],2.0) + pow(Y[i+1]-Y[i],2.0));
-
-				//if distance between two cells is too small,
-				//replace with a linearly interpolated point between
-				if (Distance < 0.6*DesiredNodeSpacing)
+				X[i] = ((X[i+1]+X[i])/2.);
+				Y[i] = ((Y[i+1]+Y[i])/2.);
+			}
+			EraseNodes(i+1, i+2);
+		}
+		else if (Distance > 1.5*DesiredNodeSpacing)
+		{
+			//if cell too far apart add new node
+			//cout << "\nAdding Node" << endl;
+			if ((StartBoundary == 2 && EndBoundary == 2) & (i == 1 || i == NoNodes-3))
+			{
+				X0 = (X[i]+X[i+1])/2.;
+				Y0 = (Y[i]+Y[i+1])/2.;
+				InsertNodes(i+1, 1);
+				X[i+1] = X0, Y[i+1] = Y0;
+			}
+			else
+			{
+				X0 = (X[i]+XR[i]+XL[i+1])/3.;
+				Y0 = (Y[i]+YR[i]+YL[i+1])/3.;
+				InsertNodes(i+1, 1);
+				X[i+1] = X0, Y[i+1] = Y0;
+				if (i > 2)
 				{
-					//if cell is too narrow remove its adjacent nodes
-					//cout << "\nErasing Node" << endl;
-					if ((StartBoundary == 2 && EndBoundary == 2) & (i == 1 || i == NoNodes-3)) {}
-					else
-					{
-  					X[i] = ((X[i+1]+X[i])/2.);
-						Y[i] = ((Y[i+1]+Y[i])/2.);
-					}
-
-					X.erase(X.begin()+i+1);
-					Y.erase(Y.begin()+i+1);
-					Fixed.erase(Fixed.begin()+i+1);
-					Vertices.erase(Vertices.begin()+i+1);
-					Recievers.erase(Recievers.begin()+i+1);
-					NoNodes -= 1;
-					SpacingFlag = 0;
-					NodeFlag = 1;
-					CalculateMorphology();
-					break;
+					X0 = (X[i]+XR[i-1]+XL[i])/3.;
+					Y0 = (Y[i]+YR[i-1]+YL[i])/3.;
 				}
-				else if (Distance > 1.5*DesiredNodeSpacing)
+				else
 				{
-					//if cell too far apart add new node
-					//cout << "\nAdding Node" << endl;
-					if ((StartBoundary == 2 && EndBoundary == 2) & (i == 1 || i == NoNodes-3))
-					{
-					  X0 = (X[i]+X[i+1])/2.;
-						Y0 = (Y[i]+Y[i+1])/2.;
-						X.insert(X.begin()+i+1,X0);
-						Y.insert(Y.begin()+i+1,Y0);
-						Fixed.insert(Fixed.begin()+i+1,0.0);
-						Vertices.insert(Vertices.begin()+i+1,Vertices[0]);
-						Recievers.insert(Recievers.begin()+i+1,Recievers[0]);
-						NoNodes += 1;
-						SpacingFlag = 0;
-						NodeFlag = 1;
-						CalculateMorphology();
-						break;
-					}
-					else
-					{
-						X0 = (X[i]+XR[i]+XL[i+1])/3.;
-						Y0 = (Y[i]+YR[i]+YL[i+1])/3.;
-						X.insert(X.begin()+i+1,X0);
-						Y.insert(Y.begin()+i+1,Y0);
-						Fixed.insert(Fixed.begin()+i+1,0.0);
-						Vertices.insert(Vertices.begin()+i+1,Vertices[0]);
-						Recievers.insert(Recievers.begin()+i+1,Recievers[0]);
-						NoNodes += 1;
-						if (i > 2)
-						{
-							X0 = (X[i]+XR[i-1]+XL[i])/3.;
-							Y0 = (Y[i]+YR[i-1]+YL[i])/3.;
-						}
-						else
-						{
-							X0 = (2.*X[i]+X[i-1])/3.;
-							Y0 = (2.*Y[i]+Y[i-1])/3.;
-						}
-						X[i] = X0;
-						Y[i] = Y0;
-
-						SpacingFlag = 0;
-						NodeFlag = 1;
-						CalculateMorphology();
-						break;
-					}
+					X0 = (2.*X[i]+X[i-1])/3.;
+					Y0 = (2.*Y[i]+Y[i-1])/3.;
 				}
-				else SpacingFlag = 1;
+				X[i] = X0;
+				Y[i] = Y0;
 			}
 		}
+		else
+		{
+			++i;
+			continue;
+		}
+
+		++NoRemeshOperations;
+
+		//the coast has moved since the morphology was last calculated, so the
+		//first change brings all the cell edges up to date, later ones only
+		//need the nodes around the change
+		if (NodeFlag == 0)
+		{
+			for (int j=1; j<NoNodes-1; ++j) CalculateNodeMorphology(j);
+			NodeFlag = 1;
+		}
+		else
+		{
+			for (int j=max(1,i-1); j<=min(NoNodes-2,i+2); ++j) CalculateNodeMorphology(j);
+		}
+		i = max(1,i-1);
 	}
 	if (NodeFlag == 1)
 	{
@@ -1018,13 +1120,20 @@ void Coastline::CalculateMeanNodeSpacing()
 	//Calculate MeanNodeSpacing
 	MeanNodeSpacing = (int)(TotalDistance/NoNodes);
 }
-void Coastline::GetAlpha()
+template <class Boundary> void Coastline::GetAlphaWith()
 {
 	//Function to determine the angle between the shoreline and offshore wave conditions
 	double FluxOrientationLast, FluxOrientationNext;
 	double Alpha_0_Last, Alpha_0_This, Alpha_0_Next;
 	double Theta_0;
 
+	//neighbouring flux orientations, the end nodes are their own neighbours
+	FluxOrientationGhost.Refresh(FluxOrientation.data(), NoNodes, NoGhostLayers, GhostClamp);
+
+	//each node only writes its own Alpha_0
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static) private(FluxOrientationLast, FluxOrientationNext, Alpha_0_Last, Alpha_0_This, Alpha_0_Next, Theta_0)
+#endif
 	for (int i=0; i<NoNodes; ++i)
 	{
 		//if we're in the shadow zone then use shadow zone wave characteristics (H_0 == 0 if no diffraction).
@@ -1033,9 +1142,8 @@ void Coastline::GetAlpha()
 		else Theta_0 = OffshoreWaveDirection;
 
 		//get adjacent flux orientations
-		if (i==0) {FluxOrientationLast = FluxOrientation[i]; FluxOrientationNext = FluxOrientation[i+1];}
-		else if (i==NoNodes-1) {FluxOrientationLast = FluxOrientation[i-1]; FluxOrientationNext = FluxOrientation[i];}
-		else {FluxOrientationLast = FluxOrientation[i-1]; FluxOrientationNext = FluxOrientation[i+1];}
+		FluxOrientationLast = FluxOrientationGhost[i-1];
+		FluxOrientationNext = FluxOrientationGhost[i+1];
 
 		// This will need refining!
 		if ((FluxOrientation[i] < 90) && (FluxOrientationLast > 270)) FluxOrientationLast -= 360;
@@ -1091,7 +1199,7 @@ void Coastline::GetAlpha()
 	     	else Alpha_0_Last = 270.-(Theta_0-FluxOrientationLast);
 		  }
 	  }
-	  else if (StartBoundary == 1 && EndBoundary == 1)
+	  else if (Boundary::Periodic)
 	  {
 		  if (Shadows[NoNodes-2] == 1)
 	    {
@@ -1125,7 +1233,7 @@ void Coastline::GetAlpha()
 		    else Alpha_0_Next = 270.-(Theta_0-FluxOrientation[i+1]);
 		  }
 	  }
-	  else if (StartBoundary == 1 && EndBoundary == 1)
+	  else if (Boundary::Periodic)
 	  {
 		  if (Shadows[1] == 1)
 	    {
@@ -1163,15 +1271,15 @@ void Coastline::GetAlpha()
     //else for high angle waves use updrift orientation
     else if (Alpha_0_This > 45.0 && Alpha_0_Last > 0)
     {
-     	if (Theta_0 <= Orientation[i]) Alpha_0_This = FluxOrientation[i-1]-Theta_0-90.;
-     	else if (Theta_0 > Orientation[i]+270.) Alpha_0_This = (FluxOrientation[i-1]+270.)-Theta_0;
-     	else Alpha_0_This = 270.-(Theta_0-FluxOrientation[i-1]);
+     	if (Theta_0 <= Orientation[i]) Alpha_0_This = FluxOrientationGhost[i-1]-Theta_0-90.;
+     	else if (Theta_0 > Orientation[i]+270.) Alpha_0_This = (FluxOrientationGhost[i-1]+270.)-Theta_0;
+     	else Alpha_0_This = 270.-(Theta_0-FluxOrientationGhost[i-1]);
     }
 	  else if (Alpha_0_This< -45.0 && Alpha_0_Next < 0)
 	  {
-		  if (Theta_0 <= Orientation[i]) Alpha_0_This = FluxOrientation[i+1]-Theta_0-90.;
-     	else if (Theta_0 > Orientation[i]+270.) Alpha_0_This = (FluxOrientation[i+1]+270.)-Theta_0;
-     	else Alpha_0_This = 270.-(Theta_0-FluxOrientation[i+1]);
+		  if (Theta_0 <= Orientation[i]) Alpha_0_This = FluxOrientationGhost[i+1]-Theta_0-90.;
+     	else if (Theta_0 > Orientation[i]+270.) Alpha_0_This = (FluxOrientationGhost[i+1]+270.)-Theta_0;
+     	else Alpha_0_This = 270.-(Theta_0-FluxOrientationGhost[i+1]);
 	  }
 
 		//Assign to array
@@ -1189,12 +1297,20 @@ void Coastline::TransformWaves()
 	//	Ks is shoaling coefficient, Kr is refraction coefficient
 	// See Komar (1998)
 
-	double C_0, L_0, H_0;
-	double C, H, L, Alpha;
-	double h, n, k, Ks, Kr;
-	int BreakCondition = 0;
+  //compiled for the current boundaries, see SelectPolicies
+  (this->*AlphaFunction)();
+
+  //the breaking wave table is nondimensional, so it is built once on first use
+  if (WaveTransformMethod == 1 && WaveTable.get_Tolerance() != WaveTableTolerance) WaveTable.Build(WaveTableTolerance);
 
-  GetAlpha();
+  //breaking waves kept from the last call are only any use for the same period and method
+  if (OffshoreWavePeriod != WaveCachePeriod || WaveTransformMethod != WaveCacheMethod || WaveTableTolerance != WaveCacheTableTolerance)
+  {
+    fill(WaveCacheH_0.begin(), WaveCacheH_0.end(), -9999.);
+    WaveCachePeriod = OffshoreWavePeriod;
+    WaveCacheMethod = WaveTransformMethod;
+    WaveCacheTableTolerance = WaveTableTolerance;
+  }
 
 //	//Calculate Alpha_0 everywhere
 //	for (int i=0; i<NoNodes; ++i)
@@ -1258,6 +1374,18 @@ void Coastline::TransformWaves()
 	//WriteAlpha();
   //Alpha_0_2 = Alpha_0;
 
+  (this->*BreakingFunction)();
+}
+
+template <class Breaking> void Coastline::BreakWaves()
+{
+  double C_0, L_0, H_0;
+
+  //nodes are independent, the cache counters are summed over threads
+  int NoHits = 0, NoMisses = 0;
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(GetNoThreads()) schedule(dynamic, 64) private(C_0, L_0, H_0) reduction(+:NoHits,NoMisses)
+#endif
   for (int i=0; i<NoNodes; ++i)
   {
     //if we're in the shadow zone then use shadow zone wave characteristics (H_0 == 0 if no diffraction).
@@ -1294,52 +1422,33 @@ void Coastline::TransformWaves()
 	  C_0 = (g*OffshoreWavePeriod)/(2.0*M_PI);			//Deep water wave speed (m/s)
 	  L_0 = C_0*OffshoreWavePeriod;						      //Deep water wave length (m)
 
-	  BreakCondition = 0;				//flag for testing wave breaking
-	  h = 3.*H_0;							  // water depth at wave base (metres) calculate this later based on period and height
-	  //h = ClosureDepth;					//Dean and Dalrymple says this should be about 1/2 wave length, which is much deaper than 3*H_0!!
-
 	  if (Alpha_0[i] == 0)
 	  {
 		  BreakingWaveHeight[i] = 0;
 		  BreakingWaveAngle[i] = 0;
 	  }
-	  else
+	  //reuse the last breaking wave if the wave approaching the node hasn't changed
+	  else if ((H_0 == WaveCacheH_0[i]) && (fabs(Alpha_0[i]-WaveCacheAlpha_0[i]) <= WaveCacheTolerance))
 	  {
-		  while (BreakCondition == 0)
-		  {
-			  //Calculate new wave height
-			  L = L_0*sqrt(tanh((2.*M_PI*h)/L_0));		//Wavelength (m) in intermediate-shallow waters
-			  //L = L_0*pow(tanh(pow(pow(2.*M_PI/T,2.)*h/g,.75)),2.0/3.0); //Fenton & McKee (1990) formulation
-		    C = C_0*tanh((2*M_PI*h)/L);					//Wave speed (m/s) set by water depth, L and C_0
-			  k = 2*M_PI/L;								//Wave number (1/m)
-	     	n = ((2*h*k)/(sinh(2*h*k)) + 1)/2;			//Shoaling factor
-	     	Ks = sqrt(C_0/(n*C*2));							//Shoaling coefficient
-	     	Alpha = (180./M_PI)*asin((C/C_0)*sin((M_PI/180.)*Alpha_0[i]));		//update theta
-			  Kr = sqrt(cos((M_PI/180.)*Alpha_0[i])/cos((M_PI/180.)*Alpha));		//refraction coefficient
-			  H = H_0*Ks*Kr;										//calculate new wave height
-
-			  //test if wave breaks
-			  if (H > h*0.78)
-			  {
-				  BreakCondition = 1;
-				  BreakingWaveHeight[i] = H;
-				  BreakingWaveAngle[i] = Alpha;
-			  }
-
-			  //update water depth
-			  h -= 0.05;
+		  BreakingWaveHeight[i] = WaveCacheHeight[i];
+		  BreakingWaveAngle[i] = WaveCacheAngle[i];
+		  ++NoHits;
+		  continue;
+	  }
+	  //shoal and refract until the wave breaks, see SetWaveTransformMethod
+	  else Breaking::Break(WaveTable, H_0, C_0, L_0, Alpha_0[i], BreakingWaveHeight[i], BreakingWaveAngle[i]);
 
-			  //Catch negative water depths!
-			  //Must be Alpha -> 90 so assume zero transport and set wave height and angle to 0
-			  if (h < 0)
-			  {
-				  BreakingWaveHeight[i] = 0;
-				  BreakingWaveAngle[i] = 0;
-				  BreakCondition = 1; // dont bother with refraction for this cell
-			  }
-		  }
+	  if (Alpha_0[i] != 0)
+	  {
+		  WaveCacheH_0[i] = H_0;
+		  WaveCacheAlpha_0[i] = Alpha_0[i];
+		  WaveCacheHeight[i] = BreakingWaveHeight[i];
+		  WaveCacheAngle[i] = BreakingWaveAngle[i];
+		  ++NoMisses;
 	  }
 	}
+	NoWaveCacheHits += NoHits;
+	NoWaveCacheMisses += NoMisses;
 }
 
 void Coastline::GetShadows()
@@ -1361,46 +1470,26 @@ void Coastline::GetShadows()
 	*/
 
 	//declare temporary variables
-	double XProd, X1, Y1, X2, Y2, dX12, dY12, X3, Y3, X4, Y4, dX34, dY34, dX31, dY31, S, T, XDiff, YDiff;
+	double X1, Y1, X2, Y2, dX12, dY12;
 	double ShadowAngle;
-	int i, reali, ShadowStart, ShadowEnd, CasterFlag, XProdPos, N;
+	int i, reali, ShadowStart, ShadowEnd, CasterFlag, N;
 
 	//reset shadows
-	vector<double> Zeros(NoNodes, 0);
-	vector<double> Empty(NoNodes, -9999);
-	Shadows = Zeros;
-	ShadowZoneWaveDirection = Empty;
-	ShadowZoneWaveHeight = Zeros;
-	Alpha_0 = Empty;
+	ResetWorkspace(Shadows, 0.);
+	ResetWorkspace(ShadowZoneWaveDirection, -9999.);
+	ResetWorkspace(ShadowZoneWaveHeight, 0.);
+	ResetWorkspace(Alpha_0, -9999.);
 	ShadowFlag = 0;
 
-	//setup vector length of X, Y, to test for shadows
-	vector<double> XCopy, YCopy, ShadowsCopy;
-	XCopy.insert(XCopy.begin(),X.begin(),X.end());
-	YCopy.insert(YCopy.begin(),Y.begin(),Y.end());
-	ShadowsCopy.insert(ShadowsCopy.begin(),Shadows.begin(),Shadows.end());
-//	XCopy = X;
-//	YCopy = Y;
-//	ShadowsCopy = Zeros; Valgrind says this sort of assignment causes a memory error!?
-	N = NoNodes;
-
-	//vector should be 3x length of X and Y for periodic boundaries only!?
-	if (StartBoundary == 1 && EndBoundary == 1)
-	{
-		XDiff = X[NoNodes-1]-X[0];
-		YDiff = Y[NoNodes-1]-Y[0];
-
-		for (i=0; i<NoNodes-1; ++i)
-		{
-			XCopy.insert(XCopy.begin()+i,X[i]-XDiff);
-			XCopy.push_back(X[i+1]+XDiff);
-			YCopy.insert(YCopy.begin()+i,Y[i]-YDiff);
-			YCopy.push_back(Y[i+1]+YDiff);
-			ShadowsCopy.push_back(Shadows[0]);
-			ShadowsCopy.push_back(Shadows[0]);
-		}
-		N = XCopy.size();
-	}
+	//pad the coast with copies shifted up and down coast for periodic boundaries,
+	//so that X,Y occupy [NoNodes-1,2*NoNodes-1) of XS, YS
+	int NoShadowGhosts = (StartBoundary == 1 && EndBoundary == 1) ? NoNodes-1 : 0;
+	ShadowXPadded.Refresh(X.data(), NoNodes, NoShadowGhosts, GhostWrap, X[NoNodes-1]-X[0]);
+	ShadowYPadded.Refresh(Y.data(), NoNodes, NoShadowGhosts, GhostWrap, Y[NoNodes-1]-Y[0]);
+	const double* XS = ShadowXPadded.begin_padded();
+	const double* YS = ShadowYPadded.begin_padded();
+	N = NoNodes+2*NoShadowGhosts;
+	ResetWorkspace(ShadowsCopy, (size_t)N, 0.);
 
 	//get incoming wave direction and project to shadow angle
 	ShadowAngle = OffshoreWaveDirection+180.;
@@ -1423,63 +1512,39 @@ void Coastline::GetShadows()
 			ShadowsCopy[i] = 1;
 	    ShadowFlag = 1;
 	  }
+	}
 
-		else
-		{
-			//set point for casting shadow
-      X1 = XCopy[i];
-			Y1 = YCopy[i];
+	//otherwise cast a ray towards the waves and look for the coast crossing it,
+	//testing only the segments the sweep across the wave direction finds (see shadowsweep.hpp)
+	ShadowFinder.Build(XS, YS, N, OffshoreWaveDirection);
+	ShadowCandidates.reserve(N);
+	for (int k=0; k<N; ++k)
+	{
+		i = ShadowFinder.Advance(k, ShadowCandidates);
+		if (i == 0 || ShadowsCopy[i] == 1) continue;
 
-			//create a hypothetical point for offshore vector in direction of OffshoreWaveDirection
-			X2 = XCopy[i] + 100000.*sin((M_PI/180.)*OffshoreWaveDirection);
-			Y2 = YCopy[i] + 100000.*cos((M_PI/180.)*OffshoreWaveDirection);
-			dX12 = X2-X1;
-			dY12 = Y2-Y1;
+		//set point for casting shadow
+		X1 = XS[i];
+		Y1 = YS[i];
 
-			//loop forward getting cast shadows
-      for (int j=0; j<N-1; ++j)
-      {
-				if (abs(XCopy[i] - XCopy[j]) < 0.0001) continue;
-				else if (abs(XCopy[j+1] - XCopy[i]) < 0.0001) continue;
-				else if ((j < i-1) || (j > i))
-				{
-					//Get points for coastal segment and diffs
-					X3 = XCopy[j];
-					Y3 = YCopy[j];
-					X4 = XCopy[j+1];
-					Y4 = YCopy[j+1];
-					dX34 = X4-X3;
-					dY34 = Y4-Y3;
-
-					//Find the cross product of the two vectors
-					XProd = dX12*dY34 - dX34*dY12;
-
-					//Xproduct == 0 for parallel lines
-         	if (XProd != 0)
-         	{
-           	if (XProd > 0) XProdPos = 1;
-           	else XProdPos = 0;
-
-           	//assign third test segment
-			      dX31 = X1-X3;
-            dY31 = Y1-Y3;
-
-           	//get cross products
-            S = dX12*dY31 - dY12*dX31;
-            T = dX34*dY31 - dY34*dX31;
-
-           	//logic for collision occurence
-           	if ((S < 0) == XProdPos) {}
-           	else if ((T < 0) == XProdPos) {}
-           	else if (((S > XProd) == XProdPos) or ((T > XProd) == XProdPos)) {}
-            else
-			      {
-           		ShadowsCopy[i] = 1;
-           		ShadowFlag = 1;
-           		break;
-           	}
-			    }
-				}
+		//create a hypothetical point for offshore vector in direction of OffshoreWaveDirection
+		X2 = X1 + 100000.*sin((M_PI/180.)*OffshoreWaveDirection);
+		Y2 = Y1 + 100000.*cos((M_PI/180.)*OffshoreWaveDirection);
+		dX12 = X2-X1;
+		dY12 = Y2-Y1;
+
+		for (int c=0, m=ShadowCandidates.size(); c<m; ++c)
+		{
+			int j = ShadowCandidates[c];
+			if ((j >= i-1) && (j <= i)) continue;
+			double X3 = XS[j], X4 = XS[j+1];
+			if (abs(X1 - X3) < 0.0001) continue;
+			else if (abs(X4 - X1) < 0.0001) continue;
+			if (ShadowSweep::RayCrossesSegment(X1, Y1, dX12, dY12, X3, YS[j], X4, YS[j+1]))
+			{
+				ShadowsCopy[i] = 1;
+				ShadowFlag = 1;
+				break;
 			}
 		}
 	}
@@ -1507,12 +1572,12 @@ void Coastline::GetShadows()
       }
 
 			//set point for casting shadow
-			X1 = XCopy[ShadowStart];
-			Y1 = YCopy[ShadowStart];
+			X1 = XS[ShadowStart];
+			Y1 = YS[ShadowStart];
 
 	    //create a hypothetical point for vector in direction of ShadowAngle
-		  X2 = XCopy[ShadowStart] + 100000.*sin((M_PI/180.)*ShadowAngle);
-		  Y2 = YCopy[ShadowStart] + 100000.*cos((M_PI/180.)*ShadowAngle);
+		  X2 = X1 + 100000.*sin((M_PI/180.)*ShadowAngle);
+		  Y2 = Y1 + 100000.*cos((M_PI/180.)*ShadowAngle);
 	    dX12 = X2-X1;
 		  dY12 = Y2-Y1;
 
@@ -1520,41 +1585,11 @@ void Coastline::GetShadows()
 
 	    for (int j=ShadowStart+1; j<ShadowEnd+1; ++j)
 	    {
-	      //Get points for coastal segment and diffs
-	     	X3 = XCopy[j];
-	     	Y3 = YCopy[j];
-	      X4 = XCopy[j+1];
-	      Y4 = YCopy[j+1];
-	      dX34 = X4-X3;
-	      dY34 = Y4-Y3;
-
-	      //Find the cross product of the two vectors
-		    XProd = dX12*dY34 - dX34*dY12;
-
-	      //Xproduct == 0 for parallel lines
-	      if (XProd != 0)
+	      if (ShadowSweep::RayCrossesSegment(X1, Y1, dX12, dY12, XS[j], YS[j], XS[j+1], YS[j+1]))
 	      {
-					if (XProd > 0) XProdPos = 1;
-		      else XProdPos = 0;
-
-					//assign third test segment
-		      dX31 = X1-X3;
-	        dY31 = Y1-Y3;
-
-		      //get cross products
-		      S = dX12*dY31 - dY12*dX31;
-		      T = dX34*dY31 - dY34*dX31;
-
-		      //logic for collision occurence
-		      if ((S < 0) == XProdPos) {}
-		      else if ((T < 0) == XProdPos) {}
-		      else if (((S > XProd) == XProdPos) or ((T > XProd) == XProdPos)) {}
-		      else
-		      {
-		      	CasterFlag = 1;
-		      	break;
-		      }
-				}
+	      	CasterFlag = 1;
+	      	break;
+	      }
 	    }
 
     	//if shadowstart casts the shadow set Shadows to 2
@@ -1577,22 +1612,8 @@ void Coastline::GetShadows()
 	}
 
 	//Copy shadows vector back to coastline object
-	if (N > NoNodes)
-	{
-		vector<double> TempVec(ShadowsCopy.begin()+NoNodes-1, ShadowsCopy.begin()+2*NoNodes-1);
-		Shadows = TempVec;
-	}
-	else
-	{
-		//This throws a mem error bug
-		if (Shadows.size() != ShadowsCopy.size())
-		{
-			cout << "Size mismatch: " << endl;
-			cout << "Shadows is size " << Shadows.size() << endl;
-			cout << "ShadowsCopy is size " << ShadowsCopy.size() << endl;
-		}
-		Shadows = ShadowsCopy;
-	}
+	if (N > NoNodes) copy(ShadowsCopy.begin()+NoNodes-1, ShadowsCopy.begin()+2*NoNodes-1, Shadows.begin());
+	else copy(ShadowsCopy.begin(), ShadowsCopy.end(), Shadows.begin());
 
 	//Write X, Y and Shadows to file
 	//WriteShadowsFile();
@@ -1823,9 +1844,13 @@ void Coastline::IntersectionAnalysis()
 	double X1, X2, X3, X4, Y1, Y2, Y3, Y4, dX12, dY12, dX34, dY34, dX31, dY31, XProd, S, T;
 	int XProdPos = 0;
 	int IntersectionFlag = 0;
+	int j;
+
+	//bin the segments so each is only tested against those it might touch
+	IntersectionGrid.Build(X.data(), Y.data(), NoNodes-1);
 
 	//#pragma omp parallel for
-	for (int i=0; i<NoNodes; ++i)
+	for (int i=0; i<NoNodes-3; ++i)
 	{
 		//assign first segment
 		X1 = X[i];
@@ -1835,8 +1860,13 @@ void Coastline::IntersectionAnalysis()
 		dX12 = X2-X1;
 		dY12 = Y2-Y1;
 
-		for (int j=i+2; j<NoNodes-1; ++j)
+		//candidates come back in ascending order, so segments are visited as in a full loop over j
+		IntersectionGrid.Query(min(X1,X2), min(Y1,Y2), max(X1,X2), max(Y1,Y2), SegmentCandidates);
+		for (int k=0; k<(int)SegmentCandidates.size(); ++k)
 		{
+			j = SegmentCandidates[k];
+			if (j < i+2 || j >= NoNodes-1) continue;
+
 			//assign second segment
 			X3 = X[j];
 			Y3 = Y[j];
@@ -1891,13 +1921,13 @@ void Coastline::IntersectionAnalysis()
 						else if (fabs(Orientation[j]-Orientation[i]) < 135.)
 						{
 							printf("Bypass in %s at line %d\n",__func__,__LINE__);
-							X.erase(X.begin()+i+1, X.begin()+j+1);
-							Y.erase(Y.begin()+i+1, Y.begin()+j+1);
-							Fixed.erase(Fixed.begin()+i+1, Fixed.begin()+j+1);
-							Vertices.erase(Vertices.begin()+i+1, Vertices.begin()+j+1);
-							Recievers.erase(Recievers.begin()+i+1, Recievers.begin()+j+1);
-							NoNodes -= (j-i);
+							EraseNodes(i+1, j+1);
 						}
+
+						//the coast has changed under the grid, rebin and carry on from the next segment after j
+						IntersectionGrid.Build(X.data(), Y.data(), NoNodes-1);
+						IntersectionGrid.Query(min(X1,X2), min(Y1,Y2), max(X1,X2), max(Y1,Y2), SegmentCandidates);
+						k = (upper_bound(SegmentCandidates.begin(), SegmentCandidates.end(), j)-SegmentCandidates.begin())-1;
 					}
 				}
 			}
@@ -1965,10 +1995,21 @@ void Coastline::BuildCellGeometries()
 
 	*/
 
+	//Reset the mesh
+	Vertices.Reset(NoNodes);
+	Recievers.Reset(NoNodes);
+	ResetWorkspace(X0, -9999.);
+	ResetWorkspace(Y0, -9999.);
+	ResetWorkspace(Dsf, -9999.);
+	ResetWorkspace(Area, -9999.);
+
 	//declare temporary variables
-	vector<int> CellType(NoNodes, 1);
-	vector<int> Weighting(NoNodes, 1);
-	vector<int> Recieved(NoNodes, 0);
+	ResetWorkspace(CellType, 1);
+	ResetWorkspace(Weighting, 1);
+	ResetWorkspace(Recieved, 0);
+
+	//neighbours of each node, wrapping round the coast (node 0 is processed as node NoNodes-1)
+	NeighbourIndex.RefreshIndices(NoNodes, NoGhostLayers, GhostWrap);
 
 	Node XYNode;
 	CoastNode CurrentNode;
@@ -1984,10 +2025,6 @@ void Coastline::BuildCellGeometries()
 	//Loop through coast and look for triangles
 	for (i=0; i<NoNodes; ++i)
 	{
-		//clear vertices
-		Vertices[i].clear();
-		Recievers[i].clear();
-
 		//Get cell width at bottom of the shoreface
 		if ((e1[i] > 0) && (e2[i] > 0)) Dsft = ClosureDepth;
 		else
@@ -2040,10 +2077,8 @@ void Coastline::BuildCellGeometries()
 				}
 
 				//set indexes for adjacent cells
-				if (i == 0) a = NoNodes-2;
-				else a = i-1;
-				if (i==NoNodes-1) b = 1;
-				else b = i+1;
+				a = NeighbourIndex[i-1];
+				b = NeighbourIndex[i+1];
 
 				//update CellType
 				if (CellType[b] == 3) CellType[b] = 4;
@@ -2063,7 +2098,7 @@ void Coastline::BuildCellGeometries()
 				//populate vertices list, add X0,Y0 as first point in vertices list for i+1 and i-1
 				XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[i].push_back(XYNode);
 				if (b<i) XYNode.X = X0[i]+(X[0]-X[NoNodes-1]), XYNode.Y = Y0[i]+(Y[0]-Y[NoNodes-1]);
-				else XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[b].insert(Vertices[b].begin(),XYNode);
+				else XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[b].push_front(XYNode);
 				if (a>i) XYNode.X = X0[i]-(X[0]-X[NoNodes-1]), XYNode.Y = Y0[i]-(Y[0]-Y[NoNodes-1]), Vertices[a].push_back(XYNode);
 				else XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[a].push_back(XYNode);
 
@@ -2264,8 +2299,7 @@ void Coastline::BuildCellGeometries()
 				a = i; b = i;
 				while (CellType[a] == 0)
 				{
-					if (a == 0) a = NoNodes-1;
-					--a;
+					a = NeighbourIndex[a-1];
 					if (a == i)
 					{
 						printf("Round the back issue in cell building %s at line %d\n",__func__,__LINE__);
@@ -2273,9 +2307,7 @@ void Coastline::BuildCellGeometries()
 					}
 					if (Dsf[a] >= ClosureDepth) break;
 				}
-				if (i == NoNodes-1) b = 1;
-				else if (b == NoNodes-1) b = 0;
-				else b = i+1;
+				b = NeighbourIndex[i+1];
 
 				//check for adjacent cells having been already processed
 				if (CellType[b] == 1) CellType[b] = 2;
@@ -2392,13 +2424,13 @@ void Coastline::BuildCellGeometries()
 					{
 						XYNode.X = X0[i] + (X[0]-X[NoNodes-1]);
 						XYNode.Y = Y0[i] + (Y[0]-Y[NoNodes-1]);
-						Vertices[b].insert(Vertices[b].begin(),XYNode);
+						Vertices[b].push_front(XYNode);
 					}
 					else
 					{
 						XYNode.X = X0[i];
 						XYNode.Y = Y0[i];
-						Vertices[b].insert(Vertices[b].begin(),XYNode);
+						Vertices[b].push_front(XYNode);
 					}
 
 					//calculate area
@@ -2650,8 +2682,7 @@ void Coastline::BuildCellGeometries()
 				b = i;
 				while (CellType[b] == 0)
 				{
-					if (b == NoNodes-1) b = 0;
-					++b;
+					b = NeighbourIndex[b+1];
 					if (b == i)
 					{
 						printf("Round the back issue in cell building %s at line %d\n",__func__,__LINE__);
@@ -2705,7 +2736,7 @@ void Coastline::BuildCellGeometries()
 					Y0[i] = YL[i] + Dist*cos((M_PI/180.)*(LeftOrientation[i]));
 
 					//create the node list for the cell
-					XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[i].insert(Vertices[i].begin(),XYNode);
+					XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[i].push_front(XYNode);
 
 					//find right boundary
 					//find location of interesection with flux orientations
@@ -2762,8 +2793,8 @@ void Coastline::BuildCellGeometries()
 					else XYNode.X = X0[i]-(X[0]-X[NoNodes-1]), XYNode.Y = Y0[i]-(Y[0]-Y[NoNodes-1]), Vertices[a].push_back(XYNode);
 					if (CellType[b] != 1)
 					{
-						if (b < i) XYNode.X = X0[i]-(X[NoNodes-1]-X[0]), XYNode.Y = Y0[i]-(Y[NoNodes-1]-Y[0]), Vertices[b].insert(Vertices[b].begin(),XYNode);
-						else XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[b].insert(Vertices[b].begin(),XYNode);
+						if (b < i) XYNode.X = X0[i]-(X[NoNodes-1]-X[0]), XYNode.Y = Y0[i]-(Y[NoNodes-1]-Y[0]), Vertices[b].push_front(XYNode);
+						else XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[b].push_front(XYNode);
 					}
 
 					// calculate area
@@ -3012,8 +3043,7 @@ void Coastline::BuildCellGeometries()
 	     	a = i, b = i;
 	     	while (CellType[a] == 0)
 	     	{
-          if (a == 0) a = NoNodes-1;
-				  --a;
+          a = NeighbourIndex[a-1];
 				  if (a == i)
 	     		{
 	     			//printf("Round the back issue in cell building %s at line %d\n",__func__,__LINE__);
@@ -3022,8 +3052,7 @@ void Coastline::BuildCellGeometries()
 	      }
         while (CellType[b] == 0)
         {
-          if (b == NoNodes-1) b = 0;
-          ++b;
+          b = NeighbourIndex[b+1];
 		     	if (b == i)
 		     	{
 		     		//printf("Round the back issue in cell building %s at line %d\n",__func__,__LINE__);
@@ -3125,10 +3154,10 @@ void Coastline::BuildCellGeometries()
 //					{
 //					  XYNode.X = X0[a] + (X[NoNodes-1]-X[0]);
 //					  XYNode.Y = Y0[a] - (Y[NoNodes-1]-Y[0]);
-//					  Vertices[i].insert(Vertices[i].begin(),XYNode);
+//					  Vertices[i].push_front(XYNode);
 //					}
-//					else XYNode.X = X0[a], XYNode.Y = Y0[a], Vertices[i].insert(Vertices[i].begin(),XYNode);
-					XYNode.X = X0[a], XYNode.Y = Y0[a], Vertices[i].insert(Vertices[i].begin(),XYNode);
+//					else XYNode.X = X0[a], XYNode.Y = Y0[a], Vertices[i].push_front(XYNode);
+					XYNode.X = X0[a], XYNode.Y = Y0[a], Vertices[i].push_front(XYNode);
 
 					dX = X0RTemp-X[i];
 					dY = Y0RTemp-Y[i];
@@ -3180,9 +3209,9 @@ void Coastline::BuildCellGeometries()
 
 			  	//add to vertices vector
 					XYNode.X = X0[i], XYNode.Y = Y0[i], Vertices[i].push_back(XYNode);
-					//if (Dsfb < ClosureDepth) XYNode.X = X0RTemp, XYNode.Y = Y0RTemp, Vertices[b].insert(Vertices[b].begin(),XYNode);
+					//if (Dsfb < ClosureDepth) XYNode.X = X0RTemp, XYNode.Y = Y0RTemp, Vertices[b].push_front(XYNode);
 					//if (Dsfa < ClosureDepth) XYNode.X = X0LTemp, XYNode.Y = Y0LTemp, Vertices[a].push_back(XYNode);
-					XYNode.X = X0RTemp, XYNode.Y = Y0RTemp, Vertices[b].insert(Vertices[b].begin(),XYNode);
+					XYNode.X = X0RTemp, XYNode.Y = Y0RTemp, Vertices[b].push_front(XYNode);
 					XYNode.X = X0LTemp, XYNode.Y = Y0LTemp, Vertices[a].push_back(XYNode);
 
 				  //Update mesh orientation as mean orientation of all contributing cells
@@ -3474,17 +3503,21 @@ void Coastline::BuildCellGeometries()
   //quick fix to get periodic boundary recievers to match
   if (StartBoundary == 1 && EndBoundary == 1)
   {
-    if (Recievers[NoNodes-1].size() > Recievers[0].size()) Recievers[0] = Recievers[NoNodes-1];
-    else Recievers[NoNodes-1] = Recievers[0];
+    if (Recievers[NoNodes-1].size() > Recievers[0].size()) Recievers.CopyCell(0, NoNodes-1);
+    else Recievers.CopyCell(NoNodes-1, 0);
   }
 
+  //pack the cell lists in node order
+  Vertices.Compact();
+  Recievers.Compact();
+
   //Write mesh properties to file for debugging purposes
-  WriteXYFile();
-  WriteNodesFile();
+  //WriteXYFile();
+  //WriteNodesFile();
   //WriteRecieversFile();
 }
 
-void Coastline::DetermineBeachWidth(Cliffline MyCliffline)
+void Coastline::DetermineBeachWidth(const Cliffline& MyCliffline)
 {
 	//If the cliffline is an empty object then set beachwidth to NDV and break
 	if (MyCliffline.BeachWidth.size() == 0)
@@ -3493,120 +3526,132 @@ void Coastline::DetermineBeachWidth(Cliffline MyCliffline)
 		return;
 	}
 
-	//Declare parameters
-	//StartSearch and EndSearch define where to look up and down the vector from the last
-	//successful measurement to find the shortest beach width
-	int SearchDistance = 10;
-	int StartSearch = 0;
-	int EndSearch = 0;
+	//Parameters for the nearest point on the cliff
 	int NearestCliffIndex;
-	int BeachFlag = 0;
-
-	//Parameters for dot product search
-	double dX, dY, dX12, dY12, dX13, dY13, DotProduct, t, lastt, DistanceToLine, XLine, YLine, SpatialGradient, Azimuth;
+	int LastCliffSegment = MyCliffline.NoNodes-2;
+	double dX, dY, dX12, dY12, t, DistanceToLine, XLine, YLine, SpatialGradient, Azimuth;
 
-	//Reset beach width
+	//Reset beach width, nodes beyond the ends of the cliff keep this
 	fill(BeachWidth.begin(),BeachWidth.end(),100);
 
-	//loop through cliffline and compare to coastline to get beachwidth
+	//measure every node in a single pass, a node moved back onto the cliff turns its
+	//neighbours, so their orientations are updated in place and the node behind is
+	//measured again before carrying on
+	int NodesMoved = 0;
 	for (int i=0; i<NoNodes; ++i)
 	{
-		if (i == 0) NearestCliffIndex = i;
-		if (NearestCliffIndex > MyCliffline.NoNodes-SearchDistance) StartSearch = NearestCliffIndex, EndSearch = MyCliffline.NoNodes-1;
-		else StartSearch = NearestCliffIndex, EndSearch = NearestCliffIndex+SearchDistance;
+		NearestCliffIndex = MyCliffline.SegmentIndex.Nearest(MyCliffline.X.data(), MyCliffline.Y.data(), X[i], Y[i], DistanceToLine, t);
+
+		//no cliff behind nodes beyond its ends
+		if (NearestCliffIndex < 0) continue;
+		if ((NearestCliffIndex == 0 && t < 0.) || (NearestCliffIndex == LastCliffSegment && t > 1.)) continue;
+
+		//Find point along line
+		if (t < 0.) t = 0.;
+		else if (t > 1.) t = 1.;
+		dX12 = MyCliffline.X[NearestCliffIndex+1]-MyCliffline.X[NearestCliffIndex];
+		dY12 = MyCliffline.Y[NearestCliffIndex+1]-MyCliffline.Y[NearestCliffIndex];
+		XLine = MyCliffline.X[NearestCliffIndex] + t*dX12;
+		YLine = MyCliffline.Y[NearestCliffIndex] + t*dY12;
+
+		//find distance to point
+		dX = XLine-X[i];
+		dY = YLine-Y[i];
+		if ((fabs(dX) < 0.01) && (fabs(dY) < 0.01))
+		{
+			BeachWidth[i] = 0;
+			X[i] = XLine;
+			Y[i] = YLine;
+			continue;
+		}
 
-		//reset t
-		t = 0;
+		//Find aximuth to point to check for negative beach width and set to 0
+		SpatialGradient = dY/dX;
+		//convert to azimuths
+		if (dX == 0 && dY < 0) Azimuth = 180.;
+		else if (dX == 0 && dY > 0) Azimuth = 0.;
+		else if (dX > 0) Azimuth = (180./M_PI)*(M_PI*0.5 - atan(SpatialGradient));
+		else Azimuth = (180./M_PI)*(M_PI*1.5 - atan(SpatialGradient));
 
-		for (int j=StartSearch; j<EndSearch; ++j)
+		if ((Azimuth < Orientation[i]) && (Azimuth > Orientation[i]-180.) && (DistanceToLine < 5.))
 		{
-			//Get vector x and y
-			dX12 = MyCliffline.X[j+1]-MyCliffline.X[j];
-			dY12 = MyCliffline.Y[j+1]-MyCliffline.Y[j];
-
-			//Get 2nd Vector properties
-			dX13 = X[i]-MyCliffline.X[j];
-			dY13 = Y[i]-MyCliffline.Y[j];
-
-			//Find Dot Product
-			DotProduct = dX12*dX13 + dY12*dY13;
-			//if (DotProduct == 0) {BeachWidth[i] = 0; break;}
-
-			//calculate fraction of distance along line
-			lastt = t;
-			t = DotProduct/(dX12*dX12 + dY12*dY12);
-			if ((lastt < 0. && t > 1.) || (lastt > 1. && t < 0))
-			{
-				XLine = MyCliffline.X[j];
-				YLine = MyCliffline.Y[j];
-			}
-			else if (t < 0. || t > 1.) continue;
-			else
-			{
-				//Find point along line
-				XLine = MyCliffline.X[j] + t*dX12;
-				YLine = MyCliffline.Y[j] + t*dY12;
-			}
-
-			//find distance to point
-			dX = XLine-X[i];
-			dY = YLine-Y[i];
-			DistanceToLine = sqrt(dX*dX + dY*dY);
-			if ((fabs(dX) < 0.01) && (fabs(dY) < 0.01))
-			{
-				BeachWidth[i] = 0;
-				NearestCliffIndex = j;
-				X[i] = XLine;
-				Y[i] = YLine;
-				break;
-			}
+			X[i] = XLine;
+			Y[i] = YLine;
+			BeachWidth[i] = 0;
+			++NodesMoved;
+
+			//moving the node changes the orientation of its neighbours and, through the
+			//boundaries, of the end nodes
+			if (i > 0) UpdateOrientation(i-1);
+			if (i < NoNodes-1) UpdateOrientation(i+1);
+			UpdateOrientation(0);
+			UpdateOrientation(NoNodes-1);
+			if (i > 0 && BeachWidth[i-1] != 0) i -= 2;
+		}
+		else BeachWidth[i] = DistanceToLine;
+	}
+	if (NodesMoved == 0) return;
 
-			//Find aximuth to point to check for negative beach width and set to 0
-			SpatialGradient = dY/dX;
-			//convert to azimuths
-			if (dX == 0 && dY < 0) Azimuth = 180.;
-			else if (dX == 0 && dY > 0) Azimuth = 0.;
-			else if (dX > 0) Azimuth = (180./M_PI)*(M_PI*0.5 - atan(SpatialGradient));
-			else if (dX < 0) Azimuth = (180./M_PI)*(M_PI*1.5 - atan(SpatialGradient));
+	//rebuild the morphology and cells round the moved nodes once, keeping the widths
+	MeasuredBeachWidth.assign(BeachWidth.begin(), BeachWidth.end());
+	CalculateMorphology();
+	copy(MeasuredBeachWidth.begin(), MeasuredBeachWidth.end(), BeachWidth.begin());
+}
 
-			if ((Azimuth < Orientation[i]) && (Azimuth > Orientation[i]-180.) && (DistanceToLine < 5.))
-			{
-				if ((X[i] != XLine) || (Y[i] != YLine))
-				{
-					BeachFlag = 1;
-					X[i] = XLine;
-					Y[i] = YLine;
-					BeachWidth[i] = 0;
-				}
-			}
-      else
-      {
-        BeachWidth[i] = DistanceToLine;
-        NearestCliffIndex = j;
-      }
-      break;
+void Coastline::UpdateOrientation(int i)
+{
+	//direction from the node before to the node after, as in CalculateMorphology
+	double dX, dY;
+	if (i == 0)
+	{
+		dX = X[1]-X[0];
+		dY = Y[1]-Y[0];
+		if (StartBoundary == 1)
+		{
+			dX += X[NoNodes-1]-X[NoNodes-2];
+			dY += Y[NoNodes-1]-Y[NoNodes-2];
 		}
-  }
-  if (BeachFlag == 1)
-  {
-    CalculateMorphology();
-    DetermineBeachWidth(MyCliffline);
-  }
+		else if (StartBoundary == 2)
+		{
+			dX = 2*dX;
+			dY = 2*dY;
+		}
+	}
+	else if (i == NoNodes-1)
+	{
+		if (EndBoundary == 1) Orientation[i] = Orientation[0];
+		else if (EndBoundary == 2) Orientation[i] = Orientation[i-1];
+		return;
+	}
+	else
+	{
+		dX = X[i+1]-X[i-1];
+		dY = Y[i+1]-Y[i-1];
+	}
+
+	//convert to azimuths
+	if (dX == 0 && dY < 0) Orientation[i] = 180.;
+	else if (dX == 0 && dY > 0) Orientation[i] = 0.;
+	else if (dX > 0) Orientation[i] = (180./M_PI)*(M_PI*0.5 - atan(dY/dX));
+	else if (dX < 0) Orientation[i] = (180./M_PI)*(M_PI*1.5 - atan(dY/dX));
 }
 
 
 void Coastline::CalculateMinVolumeChange()
 {
  	//calculates the minimum volume change based on the current beach width
+ 	//stopping at the first node without a beach width
+ 	int NoBeachNodes = 0;
+ 	while ((NoBeachNodes < NoNodes) && (BeachWidth[NoBeachNodes] != -9999)) ++NoBeachNodes;
+ 	if (NoBeachNodes < NoNodes) MinVolumeChange[NoBeachNodes] = -9999;
+
  	double a,b,c;
- 	for (int i=0; i<NoNodes; ++i)
+#ifdef _OPENMP
+ 	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static) private(a, b, c)
+#endif
+ 	for (int i=0; i<NoBeachNodes; ++i)
 	{
-	  if (BeachWidth[i] == -9999)
-	  {
-	  	MinVolumeChange[i] = -9999;
-	  	break;
-	  }
-	  else if (Dsf[i] < ClosureDepth)
+	  if (Dsf[i] < ClosureDepth)
 	  {
 	    //define coefficients
 	    a = -ShorefaceSlope*(1./6.)*(tan((M_PI/180.)*e1[i]) + tan((M_PI/180.)*e2[i]));
@@ -3628,15 +3673,13 @@ void Coastline::TransportSediment(double &TimeDelta, Wave TheWave)
   Cliffline CliffVector;
   TransportSediment(TimeDelta, TheWave, CliffVector);
 }
-void Coastline::TransportSediment(double &TimeDelta, Wave TheWave, Cliffline CliffVector)
+void Coastline::TransportSediment(double &TimeDelta, Wave TheWave, const Cliffline& CliffVector)
 {
 	//Declare temporary variables
 	//double G, dt;
-	double VolChange, Excess; //, AreaChange; //PositionChange[i],
-	CoastNode RecieverNode;
+	//double AreaChange; //PositionChange[i],
 	int i; //iterators
 	//double PositionChange[i];
-	int ReduceTimeDelta = 0;
 	//int InitFlag = 50;
 	//double BeachArea;
 	//get wave properties to individual variables
@@ -3667,6 +3710,9 @@ void Coastline::TransportSediment(double &TimeDelta, Wave TheWave, Cliffline Cli
 //		BuildCellsFlag += 1;
 //	}
 
+  //Choose the per-node loops compiled for the current settings
+  SelectPolicies();
+
   //Calculate Morphology and Build Cells!
   CalculateMorphology();
 
@@ -3676,61 +3722,34 @@ void Coastline::TransportSediment(double &TimeDelta, Wave TheWave, Cliffline Cli
 	//CALCULATE MAX POSSIBLE VOLUME CHANGE
 	CalculateMinVolumeChange();
 
-	//Find Shadow
-	GetShadows();
-
-	//refraction and Diffraction
-	//RefDiffFlag = 1;
-	if (ShadowFlag == 1 && RefDiffFlag == 1) RefractDiffractShadowZone();
+	//Find Shadow, unless neither the coast nor the waves have changed since the last step
+	if (ShadowsAreCurrent() == 1) ++NoShadowCacheHits;
 	else
 	{
-	  vector<double> TempWaveDirection(NoNodes,OffshoreWaveDirection);
-	  ShadowZoneWaveDirection = TempWaveDirection;
+		GetShadows();
+
+		//refraction and Diffraction
+		//RefDiffFlag = 1;
+		if (ShadowFlag == 1 && RefDiffFlag == 1) RefractDiffractShadowZone();
+		else
+		{
+		  fill(ShadowZoneWaveDirection.begin(), ShadowZoneWaveDirection.end(), OffshoreWaveDirection);
+		}
+		SaveShadowState();
+		++NoShadowCacheMisses;
 	}
 
 	//Transform Waves
 	TransformWaves();
 
 	//CALCULATE LONGSHORE FLUX
-	CalculateFlux(FluxType);
+	(this->*FluxFunction)();
 
 	//Calculate beach area
 	//BeachArea = CalculateArea(CliffVector);
 
 	//HANDLE BOUNDARY CONDITIONS
-	for (i=0; i<NoNodes; ++i)
-	{
-		//HANDLE BOUNDARY CONDITIONS
-		//PERIODIC BOUNDARY CONDITIONS
-		if ((i==0) && (StartBoundary == 1 && EndBoundary == 1)) continue;
-
-		//FIXED BOUNDARY CONDITIONS
-		else if ((i == 0) && (StartBoundary == 2 && EndBoundary == 2))
-		{
-			if (LongshoreFlux[i] > 0) LongshoreFlux[i] = FluxFraction*(LongshoreFlux[0] + 10.*(-0.5+((double)rand()/RAND_MAX)));
-			else if (Shadows[i] == 2) LongshoreFlux[i] = 0;
-		}
-		else if ((i == 1) && (StartBoundary == 2 && EndBoundary == 2))
-		{
-			if ((LongshoreFlux[1] > 0) && (LongshoreFlux[0] <= 0)) LongshoreFlux[1] = 0;
-			else if (LongshoreFlux[1] > 0) LongshoreFlux[1] = FluxFraction*(LongshoreFlux[1] + 10.*(-0.5+((double)rand()/RAND_MAX)));
-		}
-		else if ((i==NoNodes-2) && (StartBoundary == 2 && EndBoundary == 2))
-		{
-			if (LongshoreFlux[i] < 0) LongshoreFlux[i] = FluxFraction*(LongshoreFlux[NoNodes-1] + 10.*(-0.5+((double)rand()/RAND_MAX)));
-			LongshoreFlux[NoNodes-1] = LongshoreFlux[NoNodes-2];
-		}
-		else if ((i==NoNodes-3) && (StartBoundary == 2 && EndBoundary == 2))
-		{
-			if (LongshoreFlux[i] < 0) LongshoreFlux[i] = FluxFraction*(LongshoreFlux[NoNodes-1] + 10.*(-0.5+((double)rand()/RAND_MAX)));
-			else if (Shadows[i] == 4) LongshoreFlux[i] = 0;
-		}
-		//HANDLE FIXED CELLS (e.g. DEFENCES)
-		else if (Fixed[i] == 1)
-		{
-			VolumeChange[i] = 0;
-		}
-	}
+	(this->*BoundaryFunction)();
 
 //		//THIS IS FROM THE RELEASE VERSION
 //		//HANDLE ALL NORMAL CELLS
@@ -3766,130 +3785,99 @@ void Coastline::TransportSediment(double &TimeDelta, Wave TheWave, Cliffline Cli
 			//if ((StartBoundary == 2) && (i < 2) && (LongshoreFlux[i] > 0)) LongshoreFlux[i] = 0;
 			//else if ((EndBoundary == 2) && (i > NoNodes-3) && (LongshoreFlux[i] < 0)) LongshoreFlux[i] = 0;
 	
-//CALCULATE VOLUME CHANGE
-	for (i=0; i<NoNodes; ++i)
+//CALCULATE VOLUME CHANGE AND MOVE THE COAST
+	//The timestep is chosen by StepControl (see TimeStepController). Nothing is
+	//moved until a step is accepted, so a rejected step is rolled back to the start
+	//of the step by clearing the volume exchanged, and the exchange redone with a
+	//shorter timestep from the same fluxes. TimeDelta returns the step taken, it is
+	//kept as a reference because drivers advance their clock and erode the cliff by
+	//the TimeStep they passed in, and would silently run ahead of the coast otherwise.
+	//MDH 16/10/26
+	double RequestedTimeDelta = TimeDelta;
+	TimeDelta = StepControl.Start(RequestedTimeDelta, StableTimeDelta, AdaptiveTimeStep);
+
+	//the cell geometry doesn't change while the timestep is reduced, so the
+	//parts of the cubic and quadratic solutions that don't depend on volume
+	//change are only found once (see PositionSolver) MDH 16/10/26
+	CellSolver.Setup(NoNodes, e1.data(), e2.data(), CellWidth.data(), Area.data(), Dsf.data(), Fixed.data(), ClosureDepth, ShorefaceSlope);
+	if (SemiImplicitDiffusion == 1)
 	{
-		//HANDLE BOUNDARY CONDITIONS
-		//PERIODIC BOUNDARY CONDITIONS
-		if ((i==0) && (StartBoundary == 1 && EndBoundary == 1)) continue;
-
-		double TempDepth = 0;
-		int NoRecievers = Recievers[i].size();
+		Diffusion.Setup(NoNodes, X.data(), Y.data(), CellWidth.data(), SegmentDiffusivity.data(), Fixed.data(), ClosureDepth, StartBoundary, EndBoundary);
+	}
+	double SupplyDelivered = 1.;
+	int StepAccepted = 0;
+	while (StepAccepted == 0)
+	{
+		ExchangeVolumes(TimeDelta);
 
-		for (int j=0; j<NoRecievers; ++j)
+		//add sediment supplied from outside the coast (e.g. by cliff erosion) since the last step,
+		//in proportion to the part of the requested step taken
+		SupplyDelivered = (TimeDelta < RequestedTimeDelta) ? TimeDelta/RequestedTimeDelta : 1.;
+		for (i=0; i<NoNodes; ++i)
 		{
-			//get reciever
-			RecieverNode = Recievers[i][j];
-
-			//need to handle round the back here!!
-			if (RecieverNode.i == 0) VolChange = LongshoreFlux[NoNodes-2]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*(1.-LostFluxFraction)*TimeDelta;
-
-			//If passing to a cell that is beyond the boundary
-			else if ((LongshoreFlux[i] > 0) && (RecieverNode.i > NoNodes-3)) VolChange = -LongshoreFlux[i]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
-			
-			else if ((LongshoreFlux[i] > 0) && (LongshoreFlux[RecieverNode.i-1] < 0)) VolChange = (LongshoreFlux[i]+LongshoreFlux[RecieverNode.i-1])*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
-
-			//If sediment is moving up coast (negative flux) get flux from reciever
-			//Flux is negative but we are recieving sed so hence the negative sign
-			else if (LongshoreFlux[i] < 0) VolChange = -LongshoreFlux[RecieverNode.i-1]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
-
-			//Otherwise pass sediment to reciever from source node
-			else VolChange = -LongshoreFlux[i]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
+			VolumeChange[i] = VolumeIn[i]+VolumeOut[i]+SedimentSupply[i]*SupplyDelivered;
+			if ((i == NoNodes-1) && (StartBoundary == 1 && EndBoundary == 1)) VolumeChange[0] = VolumeChange[i];
+			else if ((i < 2) && (StartBoundary == 2)) VolumeChange[i] = 0;
+			else if ((i > NoNodes-3) && (EndBoundary == 2)) VolumeChange[i] = 0;
+		}
 
-			//Check if there is enough sediment to pass, and if not, put it back
-			if (VolChange < 0)
+		//solve every node, then make the diffusive part of the flux implicit if
+		//asked. Large changes and NaNs are found after all nodes are solved, and
+		//the first (in coast order) decides what is reported
+		//Will need to handle different boundary conditions here?
+		double MaxPositionChange = StepControl.get_MaxPositionChange();
+		CellSolver.Solve(VolumeChange.data(), PositionChange.data(), GetNoThreads());
+		if (SemiImplicitDiffusion == 1) Diffusion.Apply(TimeDelta, PositionChange.data());
+		int FirstBadNode = CellSolver.CheckChanges(BeachWidth.data(), PositionChange.data(), MaxPositionChange);
+		StepAccepted = StepControl.Check(CellSolver.get_LargestChange(), CellSolver.get_NoNaN());
+		if (StepAccepted == 1) break;
+
+		//flag to rebuild cells
+		BuildCellsFlag = 20;
+
+		if (StepAccepted == -1)
+		{
+			//can't go any shorter, so the volume exchanged over the minimum timestep is
+			//halved until no node moves too far and the rest is lost, as the model did
+			//before steps were controlled. Nodes still NaN after that are held in place
+			double ExchangeFraction = 1.;
+			while (CellSolver.get_NoBadNodes() > 0 && ExchangeFraction > 1.e-6)
 			{
-			  VolumeOut[i] += VolChange;
-			  VolumeIn[RecieverNode.i] -= VolChange;
-			  //temp commented out for testing
-			  if (VolumeOut[i] < MinVolumeChange[i])
-			  {
-			    Excess = VolumeOut[i] - MinVolumeChange[i];
-			    VolumeOut[i] -= Excess;
-			    VolumeIn[RecieverNode.i] += Excess;
-			  }
+				ExchangeFraction /= 2.;
+				for (i=0; i<NoNodes; ++i) VolumeChange[i] /= 2.;
+				CellSolver.Solve(VolumeChange.data(), PositionChange.data(), GetNoThreads());
+				if (SemiImplicitDiffusion == 1) Diffusion.Apply(TimeDelta*ExchangeFraction, PositionChange.data());
+				CellSolver.CheckChanges(BeachWidth.data(), PositionChange.data(), MaxPositionChange);
 			}
-			else if (VolChange > 0)
+			cout << "In " << __func__ << " at line " << __LINE__ << ": Large Position Change or NaN at minimum timestep of "
+			     << TimeDelta << " days, exchanged " << ExchangeFraction << " of the volume";
+			if (CellSolver.get_NoBadNodes() > 0) cout << ", holding " << CellSolver.get_NoBadNodes() << " nodes in place";
+			cout << endl;
+			for (i=0; i<NoNodes; ++i)
 			{
-				//Check for boundary conditions
-				//if ((EndBoundary == 2) && (RecieverNode.i > NoNodes-3)) continue;
-
-				VolumeIn[i] += VolChange;
-				VolumeOut[RecieverNode.i] -= VolChange;
-			  
-				//temp commented out for testing
-				if (VolumeOut[RecieverNode.i] < MinVolumeChange[RecieverNode.i])
-				{
-					Excess = VolumeOut[RecieverNode.i] - MinVolumeChange[RecieverNode.i];
-					VolumeOut[RecieverNode.i] -= Excess;
-					VolumeIn[i] += Excess;
-				}
+				if ((fabs(PositionChange[i]) > MaxPositionChange) || (PositionChange[i] != PositionChange[i])) PositionChange[i] = 0;
 			}
-
-			TempDepth = RecieverNode.ShorefaceDepth;
+			break;
 		}
-	}
-
-	for (i=0; i<NoNodes; ++i)
-	{
-		VolumeChange[i] = VolumeIn[i]+VolumeOut[i];
-		if ((i == NoNodes-1) && (StartBoundary == 1 && EndBoundary == 1)) VolumeChange[0] = VolumeChange[i];
-		else if ((i < 2) && (StartBoundary == 2)) VolumeChange[i] = 0;
-		else if ((i > NoNodes-3) && (EndBoundary == 2)) VolumeChange[i] = 0;
-	}
-
-	//MOVE THE COAST
-	//CALCULATE VOLUME CHANGE
-	ReduceTimeDelta = 1;
-	while (ReduceTimeDelta == 1)
-	{
-		ReduceTimeDelta = 0;
 
-		for (i=0; i<NoNodes; ++i)
+		if (fabs(PositionChange[FirstBadNode]) > MaxPositionChange)
 		{
-			//neglect tiny tiny changes, can't recall the reason for this, perhaps solution errors?
-			if (fabs(VolumeChange[i]) < 0.001) PositionChange[i] = 0;
-
-			//Will need to handle different boundary conditions here?
-			if (Fixed[i] == 1) {}
-			else if (Dsf[i] < ClosureDepth) PositionChange[i] = SolveCubic(i);
-			else PositionChange[i] = SolveQuadratic(i);
-			//check for large changes
-			if (fabs(PositionChange[i]) > 10.)
-			{
-				cout << "In " << __func__ << " at line " << __LINE__ << ": Large Position Change, reducing timestep!" << endl;
-
-				//flag to rebuild cells
-				BuildCellsFlag = 20;
-
-				//flag to reduce timestep
-				TimeDelta /= 2.;
-				ReduceTimeDelta = 1;
-				break;
-			}
-			else if (PositionChange[i] != PositionChange[i])
-			{
-				//just interpolate and assume the rest lost
-				cout << "In " << __func__ << " at line " << __LINE__ << ": Found NaN in Position Change! Debug needed!" << endl;
-
-				BuildCellsFlag = 20;
-
-				//flag to reduce timestep
-				TimeDelta /= 2.;
-				ReduceTimeDelta = 1;
-				break;
-			}
-			//more needed here!
-			//else if (PositionChange[i] < -(BeachWidth[i]+MinBeachWidth)))
-			else if ((BeachWidth[i] != -9999) && (PositionChange[i] < -(BeachWidth[i])))
-			{
-			  PositionChange[i] = BeachWidth[i];
-      }
+			cout << "In " << __func__ << " at line " << __LINE__ << ": Large Position Change, reducing timestep!" << endl;
+		}
+		else
+		{
+			//just interpolate and assume the rest lost
+			cout << "In " << __func__ << " at line " << __LINE__ << ": Found NaN in Position Change! Debug needed!" << endl;
 		}
-		if (ReduceTimeDelta == 1) for (i=0; i<NoNodes; ++i) VolumeChange[i] /= 2.;
-		if (TimeDelta < 0.001) TimeDelta = 0.001;
+
+		//roll back to the start of the step and try a shorter one
+		TimeDelta = StepControl.get_TimeDelta();
+		RollbackStep();
 	}
 
+	//whatever supply wasn't delivered because the timestep was reduced waits for the next step
+	for (i=0; i<NoNodes; ++i) SedimentSupply[i] *= (1.-SupplyDelivered);
+
   //Effectively just comment this bit out to run diffusivity only
 	for (i=0; i<NoNodes; ++i)
 	{
@@ -3955,6 +3943,234 @@ void Coastline::TransportSediment(double &TimeDelta, Wave TheWave, Cliffline Cli
 	//CheckRecievers();
 }
 
+void Coastline::SelectPolicies()
+{
+	if ((FluxType == PolicyFluxType) && (StartBoundary == PolicyStartBoundary) && (EndBoundary == PolicyEndBoundary)
+			&& (WaveTransformMethod == PolicyWaveTransformMethod)) return;
+
+	//boundary conditions
+	if (StartBoundary == 1 && EndBoundary == 1)
+	{
+		AlphaFunction = &Coastline::GetAlphaWith<PeriodicBoundary>;
+		BoundaryFunction = &Coastline::ApplyBoundaryConditions<PeriodicBoundary>;
+	}
+	else if (StartBoundary == 2 && EndBoundary == 2)
+	{
+		AlphaFunction = &Coastline::GetAlphaWith<FixedBoundary>;
+		BoundaryFunction = &Coastline::ApplyBoundaryConditions<FixedBoundary>;
+	}
+	else
+	{
+		AlphaFunction = &Coastline::GetAlphaWith<OpenBoundary>;
+		BoundaryFunction = &Coastline::ApplyBoundaryConditions<OpenBoundary>;
+	}
+
+	//breaking waves, see SetWaveTransformMethod
+	if (WaveTransformMethod == 1) BreakingFunction = &Coastline::BreakWaves<TableBreaking>;
+	else if (WaveTransformMethod == 2) BreakingFunction = &Coastline::BreakWaves<NewtonBreaking>;
+	else BreakingFunction = &Coastline::BreakWaves<MarchBreaking>;
+
+	//flux law, CalculateFlux reports flux types that don't exist and exits
+	FluxFunction = GetFluxFunction(FluxType);
+	if (FluxFunction == 0) CalculateFlux(FluxType);
+
+	PolicyFluxType = FluxType;
+	PolicyStartBoundary = StartBoundary;
+	PolicyEndBoundary = EndBoundary;
+	PolicyWaveTransformMethod = WaveTransformMethod;
+}
+
+template <class Boundary> void Coastline::ApplyBoundaryConditions()
+{
+	for (int i=0; i<NoNodes; ++i)
+	{
+		//PERIODIC BOUNDARY CONDITIONS
+		if ((i==0) && (Boundary::Periodic)) continue;
+
+		//FIXED BOUNDARY CONDITIONS
+		else if ((i == 0) && (Boundary::Fixed))
+		{
+			if (LongshoreFlux[i] > 0) LongshoreFlux[i] = FluxFraction*(LongshoreFlux[0] + 10.*(-0.5+((double)rand()/RAND_MAX)));
+			else if (Shadows[i] == 2) LongshoreFlux[i] = 0;
+		}
+		else if ((i == 1) && (Boundary::Fixed))
+		{
+			if ((LongshoreFlux[1] > 0) && (LongshoreFlux[0] <= 0)) LongshoreFlux[1] = 0;
+			else if (LongshoreFlux[1] > 0) LongshoreFlux[1] = FluxFraction*(LongshoreFlux[1] + 10.*(-0.5+((double)rand()/RAND_MAX)));
+		}
+		else if ((i==NoNodes-2) && (Boundary::Fixed))
+		{
+			if (LongshoreFlux[i] < 0) LongshoreFlux[i] = FluxFraction*(LongshoreFlux[NoNodes-1] + 10.*(-0.5+((double)rand()/RAND_MAX)));
+			LongshoreFlux[NoNodes-1] = LongshoreFlux[NoNodes-2];
+		}
+		else if ((i==NoNodes-3) && (Boundary::Fixed))
+		{
+			if (LongshoreFlux[i] < 0) LongshoreFlux[i] = FluxFraction*(LongshoreFlux[NoNodes-1] + 10.*(-0.5+((double)rand()/RAND_MAX)));
+			else if (Shadows[i] == 4) LongshoreFlux[i] = 0;
+		}
+		//HANDLE FIXED CELLS (e.g. DEFENCES)
+		else if (Fixed[i] == 1)
+		{
+			VolumeChange[i] = 0;
+		}
+	}
+}
+
+void Coastline::RollbackStep()
+{
+	//the coast only moves once a step is accepted, so the start of the
+	//step is no volume exchanged and no change in position MDH 16/10/26
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static)
+#endif
+	for (int i=0; i<NoNodes; ++i)
+	{
+		VolumeChange[i] = 0;
+		VolumeIn[i] = 0;
+		VolumeOut[i] = 0;
+		PositionChange[i] = 0;
+	}
+}
+
+void Coastline::ExchangeVolumes(double TimeDelta)
+{
+	/* Passes sediment from each node to its recievers. Each transfer has a donor
+	that loses sediment (the source if the flux is leaving it, otherwise the reciever)
+	and a taker. Donors may not lose more than MinVolumeChange so the order transfers
+	are applied in matters. It is always source node order, then reciever order, as if
+	the coast was swept from start to end.
+	MDH 16/10/26 */
+
+	int i, t, r;
+
+	//number the transfers from each source node
+	//PERIODIC BOUNDARY CONDITIONS, the first node is a copy of the last
+	TransferStart.resize(NoNodes+1);
+	TransferStart[0] = 0;
+	for (i=0; i<NoNodes; ++i)
+	{
+		if ((i==0) && (StartBoundary == 1 && EndBoundary == 1)) TransferStart[i+1] = TransferStart[i];
+		else TransferStart[i+1] = TransferStart[i] + Recievers[i].size();
+	}
+	int NoTransfers = TransferStart[NoNodes];
+
+	//most nodes pass sediment to one or two recievers, so room is kept for two per
+	//node and the transfer workspaces don't grow as the recievers change
+	size_t TransferRoom = max((size_t)NoTransfers, 2*(size_t)NoNodes);
+	ReserveWorkspace(TransferSource, TransferRoom), ReserveWorkspace(TransferReciever, TransferRoom);
+	ReserveWorkspace(TransferVolume, TransferRoom), ReserveWorkspace(TransferExcess, TransferRoom);
+	ReserveWorkspace(IncomingTransfers, TransferRoom);
+	TransferSource.resize(NoTransfers);
+	TransferReciever.resize(NoTransfers);
+	TransferVolume.resize(NoTransfers);
+	ResetWorkspace(TransferExcess, (size_t)NoTransfers, 0.);
+
+	//index the transfers into each node from other sources, in source order
+	ResetWorkspace(IncomingStart, (size_t)NoNodes+1, 0);
+	for (i=0; i<NoNodes; ++i)
+	{
+		for (t=TransferStart[i]; t<TransferStart[i+1]; ++t)
+		{
+			r = Recievers[i][t-TransferStart[i]].i;
+			TransferSource[t] = i;
+			TransferReciever[t] = r;
+			if (r != i) ++IncomingStart[r+1];
+		}
+	}
+	for (i=0; i<NoNodes; ++i) IncomingStart[i+1] += IncomingStart[i];
+	IncomingTransfers.resize(IncomingStart[NoNodes]);
+	for (t=0; t<NoTransfers; ++t) if (TransferReciever[t] != TransferSource[t]) IncomingTransfers[IncomingStart[TransferReciever[t]]++] = t;
+	for (i=NoNodes; i>0; --i) IncomingStart[i] = IncomingStart[i-1];
+	IncomingStart[0] = 0;
+
+	//volume of each transfer by proportion of shoreface
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static) private(t)
+#endif
+	for (i=0; i<NoNodes; ++i)
+	{
+		double TempDepth = 0;
+		double VolChange;
+
+		for (t=TransferStart[i]; t<TransferStart[i+1]; ++t)
+		{
+			//get reciever
+			const CoastNode& RecieverNode = Recievers[i][t-TransferStart[i]];
+
+			//need to handle round the back here!!
+			if (RecieverNode.i == 0) VolChange = LongshoreFlux[NoNodes-2]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*(1.-LostFluxFraction)*TimeDelta;
+
+			//If passing to a cell that is beyond the boundary
+			else if ((LongshoreFlux[i] > 0) && (RecieverNode.i > NoNodes-3)) VolChange = -LongshoreFlux[i]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
+
+			else if ((LongshoreFlux[i] > 0) && (LongshoreFlux[RecieverNode.i-1] < 0)) VolChange = (LongshoreFlux[i]+LongshoreFlux[RecieverNode.i-1])*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
+
+			//If sediment is moving up coast (negative flux) get flux from reciever
+			//Flux is negative but we are recieving sed so hence the negative sign
+			else if (LongshoreFlux[i] < 0) VolChange = -LongshoreFlux[RecieverNode.i-1]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
+
+			//Otherwise pass sediment to reciever from source node
+			else VolChange = -LongshoreFlux[i]*((RecieverNode.ShorefaceDepth-TempDepth)/ClosureDepth)*TimeDelta;
+
+			TransferVolume[t] = VolChange;
+			TempDepth = RecieverNode.ShorefaceDepth;
+		}
+	}
+
+	//debit donors, checking there is enough sediment to pass, and if not, put it back
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static)
+#endif
+	for (i=0; i<NoNodes; ++i) ApplyNodeTransfers(i, 0);
+
+	//credit takers with what was passed
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static)
+#endif
+	for (i=0; i<NoNodes; ++i) ApplyNodeTransfers(i, 1);
+}
+
+void Coastline::ApplyNodeTransfers(int i, int Stage)
+{
+	//the node's own transfers come after those from sources before it and before
+	//those from sources after it
+	int OwnDone = 0;
+	for (int k=IncomingStart[i]; k<=IncomingStart[i+1]; ++k)
+	{
+		if ((OwnDone == 0) && ((k == IncomingStart[i+1]) || (TransferSource[IncomingTransfers[k]] > i)))
+		{
+			for (int t=TransferStart[i]; t<TransferStart[i+1]; ++t) ApplyTransfer(i, t, Stage);
+			OwnDone = 1;
+		}
+		if (k < IncomingStart[i+1]) ApplyTransfer(i, IncomingTransfers[k], Stage);
+	}
+}
+
+void Coastline::ApplyTransfer(int i, int t, int Stage)
+{
+	//negative volume leaves the source for the reciever, positive comes back from the reciever
+	double VolChange = TransferVolume[t];
+	int Donor, Taker;
+	if (VolChange < 0) Donor = TransferSource[t], Taker = TransferReciever[t];
+	else if (VolChange > 0) Donor = TransferReciever[t], Taker = TransferSource[t];
+	else return;
+
+	if ((Stage == 0) && (Donor == i))
+	{
+		VolumeOut[i] -= fabs(VolChange);
+		if (VolumeOut[i] < MinVolumeChange[i])
+		{
+			TransferExcess[t] = VolumeOut[i] - MinVolumeChange[i];
+			VolumeOut[i] -= TransferExcess[t];
+		}
+	}
+	else if ((Stage == 1) && (Taker == i))
+	{
+		VolumeIn[i] += fabs(VolChange);
+		if (TransferExcess[t] != 0) VolumeIn[i] += TransferExcess[t];
+	}
+}
+
 void Coastline::CheckRecievers()
 {
   int AdjacentFlag, jj;
@@ -3980,14 +4196,14 @@ void Coastline::CheckRecievers()
 	}
 }
 
-double Coastline::CalculateArea(Cliffline CliffVector)
+double Coastline::CalculateArea(const Cliffline& CliffVector)
 {
   vector<double> XX, YY;
-  XX = X;
+  XX.assign(X.begin(), X.end());
   reverse(XX.begin(),XX.end());
   XX.insert(XX.end(), CliffVector.X.begin(),CliffVector.X.end());
   XX.push_back(XX[0]);
-  YY = Y;
+  YY.assign(Y.begin(), Y.end());
   reverse(YY.begin(),YY.end());
   YY.insert(YY.end(),CliffVector.Y.begin(),CliffVector.Y.end());
   YY.push_back(YY[0]);
@@ -4051,94 +4267,16 @@ void Coastline::CalculateFlux(int FluxType)
 
 	*/
 
-	for (int i=0; i<NoNodes; ++i)
+	//the flux laws are policies in transportpolicies.hpp
+	PolicyFunction FluxLaw = GetFluxFunction(FluxType);
+	if (FluxLaw != 0)
 	{
-		VolumeChange[i] = 0;
-		VolumeIn[i] = 0;
-	  VolumeOut[i] = 0;
-		PositionChange[i] = 0;
-
-	  if (FluxType == 0)
-	  {
-		  //Simple Diffusion this will need fixing
-		  double DiffCoef = 1.0;
-		  LongshoreFlux[i] = DiffCoef*FluxOrientation[i];
-		  //cout << "FluxType doesn't exist yet" << endl;
-		  //exit(EXIT_FAILURE);
-	  }
-	  else if (FluxType == 1)
-	  {
-		  //CERC Equation
-		  LongshoreFlux[i] = 86400.*0.41
-						  *pow(BreakingWaveHeight[i],2.5)
-						  *sin((M_PI/180.0)*BreakingWaveAngle[i])
-						  *cos((M_PI/180.0)*BreakingWaveAngle[i]);
-
-		  if (LongshoreFlux[i] != LongshoreFlux[i])
-		  {
-			  //Check for NaN in PositionChange[i]
-			  cout << "I am not equal to myself!!" << endl;
-			  cout << "Found NaN in Position Change: Node is " << i << endl;
-		  }
-	  }
-	  else if (FluxType == 2)
-	  {
-		  //CERC Equation for gravel
-		  LongshoreFlux[i] = 86400.*0.054
-						  *pow(BreakingWaveHeight[i],2.5)
-						  *sin((M_PI/180.0)*BreakingWaveAngle[i])
-						  *cos((M_PI/180.0)*BreakingWaveAngle[i]);
-
-		  if (LongshoreFlux[i] != LongshoreFlux[i])
-		  {
-			  //Check for NaN in PositionChange[i]
-			  cout << "I am not equal to myself!!" << endl;
-			  cout << "Found NaN in Position Change: Node is " << i << endl;
-		  }
-	  }
-
-	  else if (FluxType == 9)
-	  {
-	    /*CERC gravel equation with porosity term (Brown et al. 2016), and reduction factor of 18 following Soulsby and Damgaard (2005)
-	      2000 = wet gravel density (kg per cubic metre)
-	      0.45 = porosity factor for gravel
-	      19002.33 = 2^3.5 * sqrt(9.81) * (2000-1025) * (1-0.45)
-	     */
-	    //LongshoreFlux[i] = 86400.*0.054*(rho_w*pow(BreakingWaveHeight[i],2.5)*sin(2*((M_PI/180)*BreakingWaveAngle[i]))/19002.33);
-	    LongshoreFlux[i] = 86400.*0.054*(rho_w*pow(BreakingWaveHeight[i],2.5)*sin(2*((M_PI/180)*BreakingWaveAngle[i]))/(pow(2,3.5)*pow(g,0.5)*(2000-rho_w)*(1-0.45)));
-	    //LongshoreFlux[i] = LongshoreFlux[i]/18;
-
-		  if (LongshoreFlux[i] != LongshoreFlux[i])
-		  {
-			  //Check for NaN in PositionChange[i]
-			  cout << "I am not equal to myself!!" << endl;
-			  cout << "Found NaN in Position Change: Node is " << i << endl;
-		  }
-	  }
-
-
-		else if (FluxType == 11)
-	  {
-		  //CERC Equation, Ozasa & Brampton (1980) style! (see also van den Berg 2012).
-		  //Justification still unclear as noted by Ashton et al 2006.
-		  double dX = X[i+1]-X[i];
-		  double dY = Y[i+1]-Y[i];
-		  double Distance = sqrt(dX*dX + dY*dY);
-		  double K1 = 0.054;
-		  double K2 = 2.*K1/ShorefaceSlope;
-		  LongshoreFlux[i] = 86400.*(BreakingWaveHeight[i],2.5)
-							  *(K1*sin(2.*BreakingWaveAngle[i])
-							  - K2*cos(BreakingWaveAngle[i])*((BreakingWaveAngle[i+1]-BreakingWaveAngle[i])/Distance));
-
-		  if (LongshoreFlux[i] != LongshoreFlux[i])
-		  {
-			  //Check for NaN in PositionChange[i]
-			  cout << "I am not equal to myself!!" << endl;
-			  cout << "Found NaN in Position Change: Node is " << i << endl;
-		  }
-	  }
+		(this->*FluxLaw)();
+		return;
+	}
 
-    else if (FluxType == 3)
+	//Flux types that haven't been implemented yet
+	  if (FluxType == 3)
 	  {
 		  //Bailard Equation
 		  //This aint ready yet, what are u_mb and W?
@@ -4224,6 +4362,93 @@ void Coastline::CalculateFlux(int FluxType)
 		  cout << "FluxType not recognised" << endl;
 		  exit(EXIT_FAILURE);
 	  }
+}
+
+Coastline::PolicyFunction Coastline::GetFluxFunction(int Type)
+{
+	//To add a flux law, write a policy in transportpolicies.hpp and give it a FluxType here
+	struct FluxLaw { int FluxType; PolicyFunction Function; };
+	static const FluxLaw FluxLaws[] =
+	{
+		{0, &Coastline::CalculateFluxWith<DiffusionFlux>},
+		{1, &Coastline::CalculateFluxWith<CercSand>},
+		{2, &Coastline::CalculateFluxWith<CercGravel>},
+		{9, &Coastline::CalculateFluxWith<CercGravelPorosity>},
+		{11, &Coastline::CalculateFluxWith<OzasaBramptonFlux>}
+	};
+	int NoFluxLaws = sizeof(FluxLaws)/sizeof(FluxLaws[0]);
+	for (int j=0; j<NoFluxLaws; ++j) if (FluxLaws[j].FluxType == Type) return FluxLaws[j].Function;
+	return 0;
+}
+
+template <class FluxLaw> void Coastline::CalculateFluxWith()
+{
+	//reset the volume changes
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static)
+#endif
+	for (int i=0; i<NoNodes; ++i)
+	{
+		VolumeChange[i] = 0;
+		VolumeIn[i] = 0;
+	  VolumeOut[i] = 0;
+		PositionChange[i] = 0;
+	}
+
+	FluxInputs In;
+	In.X = X.data();
+	In.Y = Y.data();
+	In.FluxOrientation = FluxOrientation.data();
+	In.BreakingWaveHeight = BreakingWaveHeight.data();
+	In.BreakingWaveAngle = BreakingWaveAngle.data();
+	In.Alpha_0 = Alpha_0.data();
+	In.WavePeriod = OffshoreWavePeriod;
+	In.ShorefaceSlope = ShorefaceSlope;
+	In.rho_w = rho_w;
+	In.g = g;
+
+	//each node's flux only depends on its own breaking wave, blocks of nodes are done at a time
+	const int BlockSize = 1024;
+	int NoBlocks = (NoNodes+BlockSize-1)/BlockSize;
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(GetNoThreads()) schedule(static)
+#endif
+	for (int b=0; b<NoBlocks; ++b) FluxLaw::Evaluate(In, LongshoreFlux.data(), b*BlockSize, min((b+1)*BlockSize, NoNodes));
+
+	//diffusivity of the flux and the stability limit on the timestep dx^2/(2D)
+	//for adaptive steps, flux at node i is between nodes i and i+1. Diffusive
+	//segments have no limit when they are solved semi-implicitly MDH 16/10/26
+	if (AdaptiveTimeStep == 1 || SemiImplicitDiffusion == 1)
+	{
+		SegmentDiffusivity.resize(NoNodes);
+		double MinStableTimeDelta = 9999.;
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(GetNoThreads()) schedule(static) reduction(min:MinStableTimeDelta)
+#endif
+		for (int i=0; i<NoNodes-1; ++i)
+		{
+			SegmentDiffusivity[i] = FluxLaw::Diffusivity(In, i);
+			double D = fabs(SegmentDiffusivity[i])/ClosureDepth;
+			if (D == 0 || (SegmentDiffusivity[i] > 0 && SemiImplicitDiffusion == 1)) continue;
+			double dX = X[i+1]-X[i];
+			double dY = Y[i+1]-Y[i];
+			double StableDelta = (dX*dX + dY*dY)/(2.*D);
+			if (StableDelta < MinStableTimeDelta) MinStableTimeDelta = StableDelta;
+		}
+		StableTimeDelta = MinStableTimeDelta;
+	}
+
+	//Check for NaN
+	if (FluxKernels::CountNaN(LongshoreFlux.data(), NoNodes) > 0)
+	{
+		for (int i=0; i<NoNodes; ++i)
+		{
+			if (LongshoreFlux[i] != LongshoreFlux[i])
+			{
+				cout << "I am not equal to myself!!" << endl;
+				cout << "Found NaN in Position Change: Node is " << i << endl;
+			}
+		}
 	}
 }
 
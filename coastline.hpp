@@ -71,6 +71,15 @@ More instructions for using the model can be found the project website. <-- Add
 #include <vector>
 #include <cstring>
 #include <queue>
+#include <algorithm>
+#include "nodestore.hpp"
+#include "segmentgrid.hpp"
+#include "breakingwavetable.hpp"
+#include "positionsolver.hpp"
+#include "stepcontroller.hpp"
+#include "shorelinediffusion.hpp"
+#include "ghostlayers.hpp"
+#include "shadowsweep.hpp"
 #include "waveclimate.hpp"
 #include "cliffline.hpp"
 
@@ -89,52 +98,12 @@ class Cliffline;
 /// position during a model timestep.
 /// @author Martin D. Hurst
 /// @date 28/10/2015
-class Coastline
+class Coastline : private NodeStore
 {
   friend class Cliffline;
 
 	private:
 	//data members
-	int NoNodes; //Number of nodes along coastline
-	vector<double> X; //position in x (m) (private)
-	vector<double> Y; //position in y (m) (private)
-	vector<double> Distance; //Distance along the vector
-	vector<double> Orientation; //orientation/azimuth of shoreline across i-1, i+1 (private)
-	vector<double> FluxOrientation; //shoreline orientation bewteen i, i+1 (private)
-	vector<double> LeftOrientation; //orientation for meshing left boundary
-	vector<double> RightOrientation; //orientation for meshing right boundary
-	vector<double> CellWidth; //Width of individual cells parallel to orientation
-	vector<double> BreakingWaveHeight; //Heights of breaking waves
-	vector<double> BreakingWaveAngle; //Angle of breaking waves
-	vector<double> Shadows; //Shadow Zone Vector
-	vector<double> ShadowZoneWaveDirection; //Wave direction modified for ref/diff in shadow zone
-	vector<double> ShadowZoneWaveHeight; //Wave height modified for ref/diff in shadow zone
-	vector<double> MinVolumeChange; //Maximium possible negative volume change based on beach width
-	vector<double> LongshoreFlux; //Volume of sediment transported alongshore (in m3)
-	vector<double> VolumeChange; //Volume change in each cell during a particular timestep (m3)
-	vector<double> VolumeOut; //Volume leaving (m3)
-	vector<double> VolumeIn; //Volume entering (m3)
-	vector<double> PositionChange; //Magnitude of change in shoreline position (m)
-	vector<double> BeachWidth; //Width of beach to nearest cliff segment (m)
-	vector<double> Volume; //Total volume of sediment available for transport (m3)
-	vector<double> Area; //Surface area of shoreface cell (m2)
-	vector<double> e1; //angle of upcoast cell boundary to cell orientation normal (o)
-	vector<double> e2; //angle of downcoast cell boundary to cell orientation normal (o)
-	vector<double> XMidPoints; //X position of downcoast midpoint to next node
-	vector<double> YMidPoints; //Y position of downcoast midpoint to next node
-	vector<double> X0; //X position of cell boundary tip
-	vector<double> Y0; //Y position of cell boundary tip
-	vector<double> XL; //X position of cell boundary left edge
-	vector<double> YL; //Y position of cell boundary left edge
-	vector<double> XR; //X position of cell boundary right edge
-	vector<double> YR; //Y position of cell boundary right edge
-	vector<double> Dsf; //Shoreface Depth at cell bottom
-	vector<double> Alpha_0; //Angle of offshore wave
-
-
-	vector<int> Fixed; //Is coastline fixed? 1 = yes, 0 = np
-	vector<int> NodesToRemove; //Flag for removing nodes that are getting squashed
-
 	int StartBoundary; //Boundary type periodic=1 /no flux=2 /continous flux=3 /sinks=4 (private)
 	int EndBoundary; //Boundary type periodic=1 /no flux=2 /continous flux=3 /sinks=4 (private)
 	int MeanNodeSpacing; //average spacing between nodes (m) (private)
@@ -159,6 +128,112 @@ class Coastline
 
 	double LastVolume;//may be redundant now
 
+	//Per-node workspace kept between calls so that a timestep doesn't allocate
+	vector<int> CellType; //Cell processing state for BuildCellGeometries
+	vector<int> Weighting; //Number of mesh edges updated for each cell in BuildCellGeometries
+	vector<int> Recieved; //Has the cell been given a reciever yet in BuildCellGeometries
+	int NoGhostLayers; //Ghost nodes at each end of the per-stage ghost columns, at least 1
+	GhostColumn<double> FluxOrientationGhost; //FluxOrientation with the end values repeated, for GetAlpha
+	GhostColumn<int> NeighbourIndex; //Node indices wrapped round the coast, i-1 and i+1 are the neighbours of i, for BuildCellGeometries
+	GhostColumn<double> ShadowXPadded; //X with periodic copies for GetShadows
+	GhostColumn<double> ShadowYPadded; //Y with periodic copies for GetShadows
+	ShadowSweep ShadowFinder; //Broad phase for the rays cast by GetShadows
+	vector<int> ShadowCandidates; //Segments that might shadow the node being checked in GetShadows
+	vector<double> ShadowsCopy; //Shadows padded with periodic copies for GetShadows
+	SegmentGrid IntersectionGrid; //Broad phase for IntersectionAnalysis
+	vector<int> SegmentCandidates; //Segments that might cross the one being checked in IntersectionAnalysis
+	vector<double> MeasuredBeachWidth; //Beach widths kept across the CalculateMorphology after DetermineBeachWidth moves nodes
+
+	//Shoreface mesh reuse
+	double MeshTolerance; //Distance any node may move before the shoreface cells are rebuilt (m), 0 = rebuild on any movement
+	int MeshDebugFlag; //Check every reused mesh against a full rebuild? 1 = yes
+	int MeshTopologyVersion; //NodeStore TopologyVersion when the cells were last built, -1 = never built
+	int NoMeshBuilds; //Number of times the shoreface cells have been built
+	int NoMeshReuses; //Number of times a rebuild was skipped because no node was dirty
+	int MeshHalo; //Nodes either side of the dirty nodes whose cells are rebuilt with them, <0 = always rebuild every cell
+	int NoWindowedMeshBuilds; //Number of times only the cells round the dirty nodes were rebuilt
+	double MaxWindowDsfError, MaxWindowAreaError; //Largest differences in Dsf (m) and relative Area between windowed and full rebuilds found by CheckMeshReuse
+	int NoWindowRecieverErrors; //Number of reciever lists that differed between windowed and full rebuilds in CheckMeshReuse
+	vector<int> MeshWindows; //First and last node of each window of cells to rebuild
+	enum { NoMeshColumns = 16, NoMeshInputColumns = 12 };
+	static NodeColumn<double> NodeStore::* const MeshColumns[NoMeshColumns]; //Columns read by BuildCellGeometries, then those it builds
+	NodeColumn<double> WindowColumns[NoMeshColumns]; //MeshColumns of the window being rebuilt
+	CellArena<CoastNode> WindowRecievers; //Reciever lists of the window being rebuilt
+	CellArena<Node> WindowVertices; //Vertex lists of the window being rebuilt
+	int NoRemeshOperations; //Number of nodes added or removed by the last CheckNodeSpacing
+
+	//Wave transformation
+	int WaveTransformMethod; //How breaking waves are found, 0 = march down in depth, 1 = lookup table, 2 = Newton
+	double WaveTableTolerance; //Relative error in breaking wave height allowed in the lookup table
+	BreakingWaveTable WaveTable; //Breaking wave lookup table, built on first use
+
+	//Reuse of wave transformation between calls
+	double WaveCacheTolerance; //Change in Alpha_0 (degrees) allowed before a node's breaking wave is found again, <0 = off
+	double WaveCachePeriod; //Wave period the cached breaking waves were found for
+	int WaveCacheMethod; //WaveTransformMethod the cached breaking waves were found with
+	double WaveCacheTableTolerance; //WaveTableTolerance the cached breaking waves were found with
+	int ShadowTopologyVersion; //NodeStore TopologyVersion when the shadows were last found, -1 = never
+	double ShadowWaveHeight, ShadowWavePeriod, ShadowWaveDirection; //Offshore wave the shadows were last found for
+	int ShadowRefDiffFlag; //RefDiffFlag the shadows were last found with
+	int NoWaveCacheHits, NoWaveCacheMisses; //Nodes whose breaking wave was reused / found again
+	int NoShadowCacheHits, NoShadowCacheMisses; //Calls where the shadows were reused / found again
+
+	//Parallel per-node loops
+	int NoThreads; //OpenMP threads for the per-node loops, 0 = OpenMP default
+	vector<int> TransferStart; //Start of each source node's transfers to its recievers, NoNodes+1
+	vector<int> TransferSource; //Source node of each transfer
+	vector<int> TransferReciever; //Reciever node of each transfer
+	vector<double> TransferVolume; //Volume change at the source from each transfer (m3), negative = passed to the reciever
+	vector<double> TransferExcess; //Volume put back because the donor would have lost more than MinVolumeChange (m3)
+	vector<int> IncomingStart; //Start of each node's row in IncomingTransfers, NoNodes+1
+	vector<int> IncomingTransfers; //Transfers from other source nodes into each node, in source order
+	PositionSolver CellSolver; //Position change of every node from its volume change, set up once per step
+
+	//Timestep control
+	int AdaptiveTimeStep; //1 = TransportSediment chooses the timestep, 0 = tries the timestep it is given
+	double StableTimeDelta; //Diffusive stability limit on the timestep from the last flux calculation (days)
+	TimeStepController StepControl; //Accepts or rejects each timestep and proposes the next
+	int SemiImplicitDiffusion; //1 = diffusive part of the flux is implicit (see ShorelineDiffusion), 0 = explicit
+	vector<double> SegmentDiffusivity; //dQ/dtheta of the flux between nodes i and i+1 (m3/day per radian)
+	ShorelineDiffusion Diffusion; //Implicit correction of the change in position, set up once per step
+
+	//Compiled per-node loops chosen for the current settings, see SelectPolicies
+	typedef void (Coastline::*PolicyFunction)();
+	PolicyFunction FluxFunction; //CalculateFluxWith for FluxType
+	PolicyFunction AlphaFunction; //GetAlphaWith for StartBoundary and EndBoundary
+	PolicyFunction BoundaryFunction; //ApplyBoundaryConditions for StartBoundary and EndBoundary
+	PolicyFunction BreakingFunction; //BreakWaves for WaveTransformMethod
+	int PolicyFluxType, PolicyStartBoundary, PolicyEndBoundary, PolicyWaveTransformMethod; //Settings the functions were chosen for
+
+	/* @brief Resets a per-node workspace vector in place
+	@details Sets Workspace to NoNodes copies of Value without releasing its
+	storage. Capacity is only ever grown, and then geometrically, so once the
+	coast has settled on a number of nodes the morphology and mesh updates
+	carried out every timestep do not touch the heap.
+	@param Workspace, the per-node vector or NodeColumn to reset
+	@param Value, the value every element is set to
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	template <class Container, class T> void ResetWorkspace(Container& Workspace, T Value)
+	{
+		ResetWorkspace(Workspace, (size_t)NoNodes, Value);
+	}
+
+	/* @brief Resets a workspace vector in place to Size copies of Value
+	@details As above, for workspaces that aren't per node, such as those per
+	transfer of sediment, whose size changes from step to step. */
+	template <class Container, class T> void ResetWorkspace(Container& Workspace, size_t Size, T Value)
+	{
+		ReserveWorkspace(Workspace, Size);
+		Workspace.assign(Size, Value);
+	}
+
+	/* @brief Makes room in a workspace for at least Size elements, growing its capacity geometrically */
+	template <class Container> void ReserveWorkspace(Container& Workspace, size_t Size)
+	{
+		if (Workspace.capacity() < Size) Workspace.reserve(max(Size, 2*Workspace.capacity()));
+	}
+
 	/** @brief Calculates the morphological properties of the coastline
 	@details Resets the coastline morphological vectors and recalculates a variety
 	of geometric properties and metrics. Calculates Distance along the coast, Orientation
@@ -169,6 +244,16 @@ class Coastline
   @date 29/10/2015 */
 	void CalculateMorphology();
 
+	/* @brief Calculates the morphological properties of a single interior node
+	@details The interior node branch of CalculateMorphology. Uses X and Y at i-1,
+	i and i+1 and FluxOrientation[i-1], so nodes must be done in ascending order.
+	Lets CheckNodeSpacing refresh the cell edges around a new or removed node
+	without recalculating the whole coastline.
+	@param i int, the node index, 0 < i < NoNodes-1
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void CalculateNodeMorphology(int i);
+
   /* @brief Updates the morphological properties of the coastline
 	@details Updates the coastline morphological vectors and recalculates a variety
 	of geometric properties and metrics. This is called when wqe don't want to build
@@ -177,10 +262,118 @@ class Coastline
   @date 29/10/2015 */
 	void UpdateMorphology();
 
+	/* @brief Sets the default values of the optional model settings
+	@details Called at the start of each Initialise function. Settings that can be
+	changed from a driver with the set functions get their default values here.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetDefaults();
+
+	/* @brief Rebuilds the shoreface cells that no longer hold
+	@details Called by CalculateMorphology. Every cell is rebuilt the first time, when
+	nodes have been added or removed, when MeshHalo is negative, or when the windows
+	round the dirty nodes (see FindMeshWindows) would cover most of the coast or reach
+	either end of it. Otherwise only the windows are rebuilt (see BuildMeshWindow),
+	and if no node is dirty the cells are reused. */
+	void UpdateMesh();
+
+	/* @brief Finds the windows of cells to rebuild round the dirty nodes
+	@details A node is dirty if it has moved more than MeshTolerance in x or y since
+	its cell was last built, or the convexity of its cell (the signs of e1 and e2)
+	has changed. Each run of dirty nodes is widened by 2*MeshHalo nodes either side,
+	and windows that overlap or touch are merged. Must be called after the morphology
+	is updated.
+	@return int, the number of nodes in the windows, NoNodes if a window reaches an
+	end of the coast */
+	int FindMeshWindows();
+
+	/* @brief Rebuilds the shoreface cells of the nodes First to Last
+	@details The window's nodes are swapped in for the whole coast and built by
+	BuildCellGeometries as a coast with no flux boundaries. The cells within MeshHalo
+	nodes of the window's ends are built without the rest of the coast and are thrown
+	away, the cells in between (the dirty nodes and MeshHalo nodes either side) replace
+	those of the last build. The cell lists aren't packed, so call Compact on Vertices
+	and Recievers once every window is done.
+	@param First, Last int, first and last nodes of the window */
+	void BuildMeshWindow(int First, int Last);
+
+	/* @brief Records the state of the nodes First to Last that the shoreface cells were built from
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SaveMeshState(int First, int Last);
+
+	/* @brief Compares the current mesh with a full rebuild
+	@details Debug check (see SetMeshDebugFlag). Rebuilds every cell, reports the
+	largest differences in shoreface depth, cell area and reciever lists to screen,
+	then puts the reused or partly rebuilt cells back so the run is unchanged by the check.
+	Cells rebuilt in the windows (MeshWindows) are reported separately from those
+	kept from earlier builds: both builds see the same nodes in a window, so
+	differences there come from building the window without the rest of the coast.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void CheckMeshReuse();
+
+	/* @brief Checks whether the shadows from the last call still hold
+	@details Shadows and the refracted/diffracted waves in them depend on the whole
+	coast and the offshore wave, so they are only reused if the offshore wave and the
+	RefDiffFlag are exactly as they were when they were found, no nodes have been
+	added or removed, and no node has moved more than MeshTolerance in x or y.
+	@return int, 1 if the shadows can be reused, 0 if they must be found again
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	int ShadowsAreCurrent();
+
+	/* @brief Records the coast and offshore wave the shadows were found for
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SaveShadowState();
+
+	/* @brief Number of threads to use for a per-node loop
+	@details 1 if the coast is too short to be worth splitting or the model was
+	built without OpenMP, otherwise the number set with SetNumThreads.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	int GetNoThreads() const;
+
+	/* @brief Passes sediment from each node to its recievers
+	@details Fills VolumeIn and VolumeOut from LongshoreFlux in three passes that
+	can each be split between threads. First the volume of every transfer from a
+	source node to one of its recievers is found. Then each node debits the transfers
+	it donates to, in the order the source nodes pass them, putting back anything
+	that would take it below MinVolumeChange. Finally each node gathers the transfers
+	it takes from in the same order. Every VolumeIn and VolumeOut is built from the
+	same operations in the same order as a single pass down the coast, so the result
+	does not depend on the number of threads.
+	@param TimeDelta double, the timestep (days)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void ExchangeVolumes(double TimeDelta);
+
+	/* @brief Returns the coast to the start of a timestep after a rejected step
+	@details Clears the volumes exchanged and changes in position, leaving the fluxes
+	so that the exchange can be redone with a shorter timestep.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void RollbackStep();
+
+	/* @brief Applies the transfers involving node i for one pass of ExchangeVolumes
+	@param i int, the node
+	@param Stage int, 0 = debit the transfers i donates to, 1 = gather the transfers i takes from
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void ApplyNodeTransfers(int i, int Stage);
+
+	/* @brief Applies transfer t to node i if i is its donor (Stage 0) or taker (Stage 1)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void ApplyTransfer(int i, int t, int Stage);
+
 	/* @brief Checks nodes haven't got too close together or too far apart.
 	@details Checks to see whether there are nodes too close together
 	(<0.66*DesiredNodeSpacing) or too far apart (>1.5*DesiredNodeSpacing).
-	Nodes are added by interpolation or deleted as appropriate
+	Nodes are added by interpolation or deleted as appropriate. The coast is
+	checked in a single sweep, stepping back one node after each change, and the
+	full morphology and cells are recalculated once at the end.
 	@author Martin D. Hurst
   @date 29/10/2015 */
 	void CheckNodeSpacing();
@@ -188,6 +381,8 @@ class Coastline
 	void Sinks();
 
 	/* @brief Checks the coastline doesn't intersect itself anywhere.
+	@details Segments are binned in a SegmentGrid first so that each one is only
+	tested against the segments whose bounding boxes it might overlap.
 	@author Martin D. Hurst
   @date 29/10/2015 */
 	void IntersectionAnalysis();
@@ -196,15 +391,52 @@ class Coastline
 	following Ashton and Murray (2006), including dealing with the shadow zone. Different
 	discretisation schemes for shoreline angle depending on whether waves are high angle
 	and whether we're dealing with shadows.
+	@details Compiled for each boundary policy in transportpolicies.hpp.
 	@author Martin D. Hurst
   @date 16/12/2015 */
-	void GetAlpha();
+	template <class Boundary> void GetAlphaWith();
+
+	/* @brief Finds the breaking wave at every node with a breaking wave policy
+	@details The per-node loop of TransformWaves. Breaking is one of the breaking wave
+	policies in transportpolicies.hpp.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	template <class Breaking> void BreakWaves();
+
+	/* @brief Resets the volume changes and fills LongshoreFlux with a flux law policy
+	@details FluxLaw is one of the flux law policies in transportpolicies.hpp.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	template <class FluxLaw> void CalculateFluxWith();
+
+	/* @brief Adjusts the flux at the ends of the coast and at fixed nodes
+	@details Boundary is one of the boundary policies in transportpolicies.hpp.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	template <class Boundary> void ApplyBoundaryConditions();
+
+	/* @brief Chooses the compiled per-node loops for the current settings
+	@details Does nothing unless FluxType, StartBoundary, EndBoundary or
+	WaveTransformMethod have changed since the loops were last chosen, so the
+	settings are only looked at once rather than at every node.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SelectPolicies();
+
+	/* @brief The CalculateFluxWith compiled for a flux type
+	@param Type int, the FluxType
+	@return PolicyFunction, 0 if there is no flux law for Type
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	static PolicyFunction GetFluxFunction(int Type);
 
 	/* @brief Transforms wave from offshore to nearshore following Airy wave theory.
 	@details Assumes shore parallel contours and calculates refraction and shoaling
 	coefficients then updates wave hieght and angle. Wave breaking occurs when wave
 	height exceeds 0.8*WaterDepth. Breaking wave conditions (height and angle) are
 	stored to be fed to the alongshore seidment tranpsort equation (see CalculateFlux).
+	The breaking depth is found by one of the methods in BreakingWaveTable, chosen
+	with SetWaveTransformMethod.
 	@author Martin D. Hurst
   @date 29/10/2015 */
   void TransformWaves();
@@ -257,16 +489,9 @@ class Coastline
   @date 29/10/2015 */
 	void BuildCellGeometries();
 	void CalculateMinVolumeChange();
-	double CalculateArea(Cliffline CliffVector);
+	double CalculateArea(const Cliffline& CliffVector);
 	void CheckRecievers();
 
-	//Use priority queue to deal with triangle nodes in order of increasing shoreface depth?
-	struct CoastNode
-	{
-		double ShorefaceDepth;
-		int i;
-	};
-
 	class CompareNodes
 	{
 		public:
@@ -277,20 +502,13 @@ class Coastline
 		}
 	};
 
+	//Use priority queue to deal with triangle nodes in order of increasing shoreface depth?
 	priority_queue<CoastNode, vector<CoastNode>, CompareNodes> CoastlineQueue;
-	vector< vector<CoastNode> > Recievers;
-
-	//Structure to handle single nodes
-	struct Node
-	{
-		double X, Y;
-	};
-	vector< vector<Node> > Vertices;
 
 	void Initialise();
 	void Initialise(string xyfilename);
 	void Initialise(string xyfilename, float StartTime);
-	void Initialise(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary);
+	void Initialise(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary, unsigned long long NoiseSeed);
 
   void WriteXYFile();
   void WriteNodesFile();
@@ -334,12 +552,13 @@ class Coastline
 	/// @param Trend Double, the azimuth direction in which to create the coast.
 	/// @param StartBoundary, the boundary condition at the start of the line (1=fixed, 2=periodic)
 	/// @param EndBoundary, the boundary condition at the end of the line (1=fixed, 2=periodic), must be same as StartBoundary (for the moment).
+	/// @param NoiseSeed, seed of the noise added to the node positions, the same seed always gives the same line
 	/// @author Martin D. Hurst
 	/// @date 28/10/2015
 	///Initialise coastline as a straight line.
-	Coastline(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary)  : FluxType(1), RefDiffFlag(0), FluxFraction(0.), LostFluxFraction(0.)
+	Coastline(int MeanNodeSpacing, double CoastLength, double Trend, int StartBoundary, int EndBoundary, unsigned long long NoiseSeed = 1)  : FluxType(1), RefDiffFlag(0), FluxFraction(0.), LostFluxFraction(0.)
 	{
-		Initialise(MeanNodeSpacing, CoastLength, Trend, StartBoundary, EndBoundary);
+		Initialise(MeanNodeSpacing, CoastLength, Trend, StartBoundary, EndBoundary, NoiseSeed);
 	}
 
 	/// @brief Function to read a coastline from a file at a given time.
@@ -368,10 +587,20 @@ class Coastline
 
   /// @brief Measure beach width to a cliffline object
 	/// @details Function to quantify beach width by measuring shortest distance
-	/// to a nearby cliffline vector object.
+	/// to a nearby cliffline vector object. The nearest cliff segment to each node
+	/// is found from the cliff's SegmentGrid, so it is found wherever it is along
+	/// the cliff. Nodes that have moved behind the cliff are put back on it in a
+	/// single pass along the coast. Since that turns their neighbours, the
+	/// neighbours' orientations are updated as it goes and the node behind is
+	/// measured again, then the morphology is recalculated once at the end.
 	/// @author Martin D. Hurst
 	/// @date 13/1/2016
-  void DetermineBeachWidth(Cliffline MyCliffline);
+  void DetermineBeachWidth(const Cliffline& MyCliffline);
+
+	/// @brief Recalculates the orientation of node i from its neighbours
+	/// @details Same rules as CalculateMorphology, including the boundaries, but
+	/// only Orientation is changed. Used by DetermineBeachWidth as nodes move.
+	void UpdateOrientation(int i);
 
 	/* @brief Perform sediment transport and evolve coast
 	@details This is the main function call in the model, all else is called from inside
@@ -385,17 +614,22 @@ class Coastline
 	SolveQuadratic. Finally IntersectionAnalysis checks for intersections in the coast (e.g.
 	breaching/reattaching) and then the model checks that the spacing of coastal nodes hasn't
   gotten too big or small (CheckNodeSpacing).
-  @param TimeDelta Double, the model timestep (days)
+  @param TimeDelta Double, the model timestep (days). If a step moves the coast too far it is
+  tried again with a shorter timestep (see SetTimeStepLimits and SetAdaptiveTimeStep), and the
+  timestep taken is returned in TimeDelta. Callers advance their clock and erode the cliff by
+  the returned TimeDelta, so it must be reset to the step wanted before the next call.
   @param TheWave Wave Object sampled from a waveclimate object.
   @param FluxType Int, 1 = CERC equation, others are yet to be implemented, default is 1.
   @param RefDiffFlag Int, 0 = Off, 1 = On, default is 1.
   @param FluxFraction Double, Proportion of sediment input at boundaries when fixed (untested, default is 0).
   @param LostFluxFraction Double, Proportion of sediment lost offshore during flux (default is 0).
+  @param CliffVector Cliffline, the cliff backing the beach, used to measure beach width. Sediment
+  supplied by the cliff since the last call (see SupplySediment) is added to the volume change.
   @author Martin D. Hurst
 	@date 29/10/2015
 	*/
 	void TransportSediment(double &TimeDelta, Wave TheWave);
-	void TransportSediment(double &TimeDelta, Wave TheWave, Cliffline CliffVector);
+	void TransportSediment(double &TimeDelta, Wave TheWave, const Cliffline& CliffVector);
 
 	/*Flux Type
                0 = Simple Diffusion
@@ -406,7 +640,9 @@ class Coastline
 	*/
 
   /// @brief Calculate volumetric sediment fluxes
-  /// @details Evaluates the chosen sediment flux law at node i
+  /// @details Evaluates the chosen sediment flux law at node i. The CERC
+  /// equations (FluxType 1, 2 and 9) are evaluated over the whole coast at once
+  /// with FluxKernels.
   /// @param i Int, the node index
   /// @param FluxType Int, 1 = CERC equation, others are yet to be implemented, default is 1.
   /// @author Martin D. Hurst
@@ -441,6 +677,18 @@ class Coastline
   /// @date 13/1/2016
 	void AddVolume(double Volume, int i);
 
+	/// @brief Supply sediment to a coastline cell from outside the coastline
+	/// @details Adds a volume to the sediment supply exchange buffer of a cell
+	/// (e.g. material from cliff erosion). The coast does not move here, the
+	/// volume is added to the cell's volume change in the next call to
+	/// TransportSediment, so supply from any number of sources is mass balanced
+	/// with the longshore fluxes and the timestep control.
+	/// @param Volume double, the volume to supply (m3)
+	/// @param i int, the index of the cell recieving the sediment
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void SupplySediment(double Volume, int i) { SedimentSupply[i] += Volume; }
+
 	/*****************************************\
 	| Set Functions to assign private members |
 	\*****************************************/
@@ -488,6 +736,134 @@ class Coastline
 	@date 07/07/2016 */
   void SetShorefaceSlope(double NewShorefaceSlope)	{ShorefaceSlope = NewShorefaceSlope;};
 
+	/* @brief Set the tolerance for reusing the shoreface mesh
+	@details The shoreface cells (BuildCellGeometries) round a node are only rebuilt once
+	it has moved more than this distance in x or y since its cell was built or the
+	convexity of its cell changes, and every cell is rebuilt when nodes are added or
+	removed (see SetMeshHalo). Default is 0, so cells are rebuilt whenever their nodes
+	move; a small tolerance (e.g. a few percent of the node spacing) trades mesh
+	accuracy for fewer rebuilds. The same
+	tolerance decides when the shadows can be reused for a repeated wave (see
+	ShadowsAreCurrent).
+	@param NewMeshTolerance double, the tolerance (m)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetMeshTolerance(double NewMeshTolerance) {MeshTolerance = NewMeshTolerance;}
+
+	/* @brief Set the number of nodes either side of the dirty nodes whose cells are rebuilt with them
+	@details When only part of the coast is dirty (see SetMeshTolerance) only the cells
+	of the dirty nodes and the Halo nodes either side are rebuilt, from a window of the
+	coast a further Halo nodes wider each side. The priority-queue build passes
+	orientations along the coast from cell to cell, so a window gives the same cells as
+	a full rebuild only if the halo is wider than this reaches; check with
+	SetMeshDebugFlag. Default is 10, a negative value rebuilds every cell whenever any
+	node is dirty.
+	@param Halo int, the halo (nodes) */
+	void SetMeshHalo(int Halo) {MeshHalo = Halo;}
+
+	/* @brief Turn on checking of reused and partly rebuilt meshes
+	@details When set to 1, every time the shoreface cells are reused or only rebuilt
+	round the dirty nodes, a full rebuild is also carried out and the differences are
+	written to screen (see CheckMeshReuse).
+	@param NewFlag int, 0 = Off, 1 = On, default is 0.
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetMeshDebugFlag(int NewFlag) {MeshDebugFlag = NewFlag;}
+
+	/* @brief Set how TransformWaves finds the breaking wave height and angle
+	@details 0 = step down from a depth of 3*H_0 in 0.05 m steps until the wave
+	breaks (the original method, default), 1 = interpolate a precomputed
+	nondimensional table of breaking depth (see SetWaveTableTolerance), 2 = solve
+	for the breaking depth by Newton's method. Methods 1 and 2 don't carry the
+	0.05 m depth discretisation of method 0, so breaking wave heights differ from
+	it by a few percent for small waves and by less for large ones.
+	@param NewMethod int, 0, 1 or 2
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetWaveTransformMethod(int NewMethod) {WaveTransformMethod = NewMethod;}
+
+	/* @brief Set the accuracy of the breaking wave lookup table
+	@details The table is refined until breaking wave heights interpolated from it are
+	within this relative error of the Newton solution. Default is 0.001.
+	@param NewTolerance double, relative error
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetWaveTableTolerance(double NewTolerance) {WaveTableTolerance = NewTolerance;}
+
+	/* @brief Set how far a node's wave angle may change before its breaking wave is found again
+	@details The breaking wave at a node only depends on the wave height approaching it,
+	the wave period and its angle to the coast Alpha_0. TransformWaves keeps the last
+	breaking wave found at each node and reuses it while the height and period are
+	unchanged and Alpha_0 has changed by no more than this. Default is 0, so only
+	exact repeats are reused and results are unchanged. A negative value turns reuse
+	of breaking waves and shadows off.
+	@param NewTolerance double, the tolerance (degrees)
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetWaveCacheTolerance(double NewTolerance) {WaveCacheTolerance = NewTolerance;}
+
+	/* @brief Set the number of threads for the per-node loops
+	@details GetAlpha, TransformWaves, CalculateFlux, CalculateMinVolumeChange, the
+	exchange of sediment between nodes and the solution for the change in position
+	are split between this many OpenMP threads. Each node's results are found by the
+	same operations whatever the number of threads, so runs are identical for any
+	setting. Short coasts are always run on one thread. Has no effect unless the
+	model is compiled with -fopenmp.
+	@param NewNoThreads int, number of threads, 0 = OpenMP default (OMP_NUM_THREADS), default is 0
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetNumThreads(int NewNoThreads) {NoThreads = NewNoThreads;}
+
+	/* @brief Set the number of ghost layers
+	@details Per-node arrays that a stage reads the neighbours of are copied once per
+	stage into columns padded with this many ghost nodes at each end (see ghostlayers.hpp),
+	so that the stage's loop needs no special cases at the ends of the coast. Stages only
+	read one neighbour each way at present, so more layers are only useful to wider stencils.
+	@param NewNoGhostLayers int, number of ghost nodes at each end, at least 1, default is 1
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetNoGhostLayers(int NewNoGhostLayers) {NoGhostLayers = (NewNoGhostLayers < 1) ? 1 : NewNoGhostLayers;}
+
+	/* @brief Let TransportSediment choose its own timestep
+	@details When on, the timestep given to TransportSediment is the longest it may
+	take (e.g. the time to the next wave) and the step taken is returned in it. The
+	step is the one proposed by the last accepted step, which grows while nodes move
+	less than the largest change allowed, and is kept below the diffusive stability
+	limit of the flux law. When off (default) the timestep given is tried first.
+	Either way a step that moves a node too far is rolled back and tried again with a
+	shorter timestep, and the step taken is returned.
+	@param NewFlag int, 1 = on, 0 = off
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetAdaptiveTimeStep(int NewFlag) {AdaptiveTimeStep = NewFlag;}
+
+	/* @brief Set the limits used to choose timesteps
+	@param MinTimeDelta double, shortest step (days), default is 0.001. Steps this short are
+	never rejected. If nodes still move too far the volume exchanged is halved until they
+	don't, and any node still NaN is held in place.
+	@param MaxTimeDelta double, longest step when adaptive (days), default is 1
+	@param MaxPositionChange double, largest change in position of a node in one step (m), default is 10
+	@param CFLNumber double, fraction of the diffusive stability limit adaptive steps may use, default is 0.5
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetTimeStepLimits(double MinTimeDelta, double MaxTimeDelta, double MaxPositionChange, double CFLNumber)
+	{
+		StepControl.SetLimits(MinTimeDelta, MaxTimeDelta, MaxPositionChange, CFLNumber);
+	}
+
+	/* @brief Solve the diffusive part of longshore transport semi-implicitly
+	@details The flux law is linearised about the current orientation of the coast
+	and the change in flux over the step is taken at the end of the step for segments
+	where it is diffusive, i.e. where waves approach at low angles (see
+	ShorelineDiffusion). Segments where high angle waves are anti-diffusive stay
+	explicit. Adaptive timesteps are then only limited by the anti-diffusive segments
+	and the largest change in position, so can be much longer under low angle wave
+	climates. Default is off.
+	@param NewFlag int, 1 = on, 0 = off
+	@author Martin D. Hurst
+	@date 16/10/2026 */
+	void SetSemiImplicitDiffusion(int NewFlag) {SemiImplicitDiffusion = NewFlag;}
+
 	/*****************************************\
 	| Get Functions to return private members |
 	\*****************************************/
@@ -505,14 +881,14 @@ class Coastline
 	/// @returns vector<double>, X coordinate values of the coastline
 	/// @author Martin D. Hurst
   /// @date 7/1/2014
-  vector<double> get_X() const				{return X;}					//get X vector position in x (m)
+  vector<double> get_X() const				{return vector<double>(X.begin(), X.end());}					//get X vector position in x (m)
 
 	/// @brief Return coastline Y-values.
   /// @details Function to return the private member Y values
 	/// @returns vector<double>, Y coordinate values of the coastline
 	/// @author Martin D. Hurst
   /// @date 7/1/2014
-	vector<double> get_Y() const				{return Y;}					//get Y vectir position in y (m)
+	vector<double> get_Y() const				{return vector<double>(Y.begin(), Y.end());}					//get Y vectir position in y (m)
 
 	/// @brief Return coastline orientation.
 	/// @details Function to return the private member Orientation,
@@ -522,7 +898,7 @@ class Coastline
 	/// @returns vector<double>, Orientation values of the coastline
 	/// @author Martin D. Hurst
   /// @date 6/1/2014
-	vector<double> get_Orientation() const 	 	{return Orientation;}		//get orientation of shoreline between i-1 and i+1
+	vector<double> get_Orientation() const 	 	{return vector<double>(Orientation.begin(), Orientation.end());}		//get orientation of shoreline between i-1 and i+1
 
 	/// @brief Return coastline flux orientation.
 	/// @details Function to return the private member FluxOrientation,
@@ -533,7 +909,7 @@ class Coastline
 	/// @returns vector<double>, FluxOrientation values of the coastline
 	/// @author Martin D. Hurst
   /// @date 6/1/2014
-	vector<double> get_FluxOrientation() const 	{return FluxOrientation;}	//get shoreline orientation bewteen i and i+1
+	vector<double> get_FluxOrientation() const 	{return vector<double>(FluxOrientation.begin(), FluxOrientation.end());}	//get shoreline orientation bewteen i and i+1
 
   /// @brief Return coastal shadows.
 	/// @details Function to return the private member Shadows, an integer
@@ -542,7 +918,7 @@ class Coastline
 	/// @returns vector<double>, Shadows values of the coastline
 	/// @author Martin D. Hurst
   /// @date 6/1/2014
-	vector<double> get_Shadows() const			{return Shadows;}			//get Shadows
+	vector<double> get_Shadows() const			{return vector<double>(Shadows.begin(), Shadows.end());}			//get Shadows
 
 	/// @brief Return start boundary condition.
 	/// @Function to return the private member StartBoundary, the boundary
@@ -572,6 +948,88 @@ class Coastline
   /// @date 8/1/2014
 	int get_MeanNodeSpacing() const				{return MeanNodeSpacing;}	//get average spacing between nodes (m)
 
+	/// @brief Return the number of times the shoreface cells have been built.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoMeshBuilds() const				{return NoMeshBuilds;}
+
+	/// @brief Return the number of times an existing mesh was reused instead of rebuilt.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoMeshReuses() const				{return NoMeshReuses;}
+
+	/// @brief Return the number of times only the cells round the dirty nodes were rebuilt.
+	int get_NoWindowedMeshBuilds() const				{return NoWindowedMeshBuilds;}
+
+	/// @brief Return the largest difference in shoreface depth (m) between a windowed and a full rebuild, found with SetMeshDebugFlag.
+	double get_MaxWindowDsfError() const				{return MaxWindowDsfError;}
+
+	/// @brief Return the largest relative difference in cell area between a windowed and a full rebuild, found with SetMeshDebugFlag.
+	double get_MaxWindowAreaError() const				{return MaxWindowAreaError;}
+
+	/// @brief Return the number of reciever lists that differed between windowed and full rebuilds, found with SetMeshDebugFlag.
+	int get_NoWindowRecieverErrors() const				{return NoWindowRecieverErrors;}
+
+	/// @brief Return the number of nodes added or removed by the last node spacing check.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoRemeshOperations() const				{return NoRemeshOperations;}
+
+	/// @brief Return the number of node breaking waves reused from an earlier call to TransformWaves.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoWaveCacheHits() const				{return NoWaveCacheHits;}
+
+	/// @brief Return the number of node breaking waves TransformWaves had to find again.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoWaveCacheMisses() const				{return NoWaveCacheMisses;}
+
+	/// @brief Return the number of timesteps that reused the shadows from the step before.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoShadowCacheHits() const				{return NoShadowCacheHits;}
+
+	/// @brief Return the number of timesteps that had to find the shadows again.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoShadowCacheMisses() const				{return NoShadowCacheMisses;}
+
+	/// @brief Return the number of threads set for the per-node loops, 0 = OpenMP default.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NumThreads() const				{return NoThreads;}
+
+	/// @brief Return the number of timesteps taken by TransportSediment.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoAcceptedSteps() const				{return StepControl.get_NoAcceptedSteps();}
+
+	/// @brief Return the number of timesteps rejected and tried again with a shorter timestep.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoRejectedSteps() const				{return StepControl.get_NoRejectedSteps();}
+
+	/// @brief Return the number of steps taken at the minimum timestep with less than the full volume exchanged.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoForcedSteps() const				{return StepControl.get_NoForcedSteps();}
+
+	/// @brief Return the timestep proposed for the next step (days), -9999 before the first step.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	double get_NextTimeDelta() const				{return StepControl.get_NextTimeDelta();}
+
+	/// @brief Return the diffusive stability limit on the timestep (days), only found when adaptive or semi-implicit.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	double get_StableTimeDelta() const				{return StableTimeDelta;}
+
+	/// @brief Return the number of segments solved implicitly in the last step.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	int get_NoImplicitSegments() const				{return Diffusion.get_NoImplicitSegments();}
+
 };
 
 #endif
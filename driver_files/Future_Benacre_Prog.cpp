@@ -130,6 +130,9 @@ int main(int argc, char* argv[])
 	GaussianWaveClimate WaveClimate1(OffshoreMeanWavePeriod1,OffshoreStDWavePeriod1,OffshoreMeanWaveDirection1,OffshoreStDWaveDirection1,OffshoreMeanWaveHeight1, OffshoreStDWaveHeight1);
 
 	GaussianWaveClimate WaveClimate2(OffshoreMeanWavePeriod2,OffshoreStDWavePeriod2,OffshoreMeanWaveDirection2,OffshoreStDWaveDirection2,OffshoreMeanWaveHeight2, OffshoreStDWaveHeight2);
+	
+	//random numbers for choosing between the wave climates, separate from the climates' own
+	RandomStream ClimateChooser(1);
   
   //declare wave	
 	Wave MyWave = Wave();
@@ -193,7 +196,7 @@ int main(int argc, char* argv[])
 		if (Time > GetWaveTime) 
 		{
 			// Use a random sampler to chose between wave climates
-			rand1 = (double)rand()/RAND_MAX;
+			rand1 = ClimateChooser.Uniform();
 			if (rand1 < 0.5) MyWave = WaveClimate1.Get_Wave();
 			else MyWave = WaveClimate2.Get_Wave();
 			GetWaveTime += WaveTimeDelta/365.;
@@ -0,0 +1,177 @@
+/*==============================================================
+
+adaptive_timestep_driver.cpp
+
+A driver function to compare fixed and adaptive timesteps, with
+explicit and semi-implicit diffusion, in
+Coastline::TransportSediment on a straight periodic coast.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file adaptive_timestep_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief compares fixed and adaptive timesteps
+@details Evolves the same straight periodic coast under the same sequence of
+UA waves, a new wave every WaveTimeDelta days, with a short fixed timestep
+(the reference), the usual fixed timestep of 0.1 days, a long fixed timestep
+and adaptive timesteps, the last two also with semi-implicit diffusion. For
+each it reports the number of steps taken and rejected, the run time and the
+rms difference in shoreline position from the reference run. This is done for
+several wave sequences, each from its own seed, and the driver fails if an
+adaptive or semi-implicit run takes a step at the minimum timestep or ends
+more than 5 m from the reference. The fraction of high angle waves can be
+given, semi-implicit diffusion helps most when it is low and the coast is
+diffusive, and the node spacing, explicit steps have to be shorter the closer
+the nodes are.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+/// @brief Shoreline position (m) at regular intervals along the coast
+/// @details A straight coast with a trend of 180 runs south from the origin,
+/// so X is interpolated at Y = 0, -Spacing, -2*Spacing, ...
+vector<double> Shoreline(const vector<double>& X, const vector<double>& Y, double Length, double Spacing)
+{
+	vector<double> Profile;
+	int j = 0, n = X.size();
+	for (double y=0; y>=-Length; y-=Spacing)
+	{
+		while (j < n-2 && Y[j+1] > y) ++j;
+		double Fraction = (Y[j+1] != Y[j]) ? (y-Y[j])/(Y[j+1]-Y[j]) : 0;
+		Profile.push_back(X[j] + Fraction*(X[j+1]-X[j]));
+	}
+	return Profile;
+}
+
+int main(int argc, char* argv[])
+{
+	//run length (days), fraction of high angle waves, node spacing (m) and number of
+	//wave sequences can be given as arguments
+	double EndTime = 200.;
+	double HighAngleFraction = 0.3;
+	int NodeSpacing = 100;
+	int NoSequences = 3;
+	if (argc > 1) EndTime = atof(argv[1]);
+	if (argc > 2) HighAngleFraction = atof(argv[2]);
+	if (argc > 3) NodeSpacing = atoi(argv[3]);
+	if (argc > 4) NoSequences = atoi(argv[4]);
+
+	double CoastLength = 10000.;
+	double Trend = 180.;
+	double WaveTimeDelta = 5.;
+	int NoRuns = 6;
+	const char* RunNames[] = {"fixed 0.02 days", "fixed 0.1 days", "fixed 2 days", "adaptive",
+	                          "fixed 2 days semi-implicit", "adaptive semi-implicit"};
+	double FixedTimeDelta[] = {0.02, 0.1, 2., 0, 2., 0};
+	int SemiImplicit[] = {0, 0, 0, 0, 1, 1};
+
+	//runs that should be stable, i.e. take no steps at the minimum timestep and
+	//stay within Tolerance of the reference. A long explicit step is not expected to
+	double Tolerance = 5.;
+	int Checked[] = {0, 0, 0, 1, 1, 1};
+	int NoFailures = 0;
+
+	for (int Sequence=1; Sequence<=NoSequences; ++Sequence)
+	{
+		cout << "Wave sequence " << Sequence << endl;
+		vector<double> Reference;
+		for (int n=0; n<NoRuns; ++n)
+		{
+			//same coast for every run, and a new climate samples the same sequence of waves
+			Coastline CoastVector(NodeSpacing, CoastLength, Trend, 1, 1, Sequence);
+			Cliffline CliffVector;
+			CoastVector.SetFluxType(1);
+			if (FixedTimeDelta[n] == 0) CoastVector.SetAdaptiveTimeStep(1);
+			CoastVector.SetTimeStepLimits(0.001, WaveTimeDelta, 10., 0.5);
+			CoastVector.SetSemiImplicitDiffusion(SemiImplicit[n]);
+			UAWaveClimate WaveClimate(HighAngleFraction, 0.6, Trend, 6., 1., 1., 0.1);
+			WaveClimate.SetSeed(Sequence);
+			Wave MyWave = WaveClimate.Get_Wave();
+
+			clock_t Start = clock();
+			double Time = 0, GetWaveTime = 0;
+			int NoSteps = 0;
+			while (Time < EndTime)
+			{
+				if (Time >= GetWaveTime)
+				{
+					MyWave = WaveClimate.Get_Wave();
+					GetWaveTime += WaveTimeDelta;
+				}
+
+				//adaptive steps may be as long as the time to the next wave
+				double TimeStep = (FixedTimeDelta[n] > 0) ? FixedTimeDelta[n] : GetWaveTime-Time;
+				if (TimeStep > GetWaveTime-Time) TimeStep = GetWaveTime-Time;
+				CoastVector.TransportSediment(TimeStep, MyWave, CliffVector);
+				Time += TimeStep;
+				++NoSteps;
+			}
+			double RunTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+
+			//compare with the reference run
+			vector<double> Profile = Shoreline(CoastVector.get_X(), CoastVector.get_Y(), CoastLength, NodeSpacing);
+			if (n == 0) Reference = Profile;
+			double SumSquares = 0;
+			for (int i=0, m=Profile.size(); i<m; ++i) SumSquares += (Profile[i]-Reference[i])*(Profile[i]-Reference[i]);
+			double RMS = sqrt(SumSquares/Profile.size());
+
+			cout << "\t" << RunNames[n] << ": " << NoSteps << " steps, " << CoastVector.get_NoRejectedSteps() << " rejected, "
+			     << CoastVector.get_NoForcedSteps() << " at minimum, " << RunTime << " s, rms difference "
+			     << RMS << " m";
+			if (Checked[n] == 1 && (CoastVector.get_NoForcedSteps() > 0 || !(RMS < Tolerance)))
+			{
+				cout << " FAILED";
+				++NoFailures;
+			}
+			cout << endl;
+		}
+	}
+
+	if (NoFailures > 0)
+	{
+		cout << NoFailures << " runs were unstable or more than " << Tolerance << " m from the reference" << endl;
+		exit(EXIT_FAILURE);
+	}
+	cout << "Adaptive and semi-implicit runs were stable and within " << Tolerance << " m of the reference" << endl;
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*==============================================================
+
+beach_width_driver.cpp
+
+A driver function to check the nearest segment queries
+of SegmentGrid, used to measure beach width, against a search of
+every segment, on the Benacre coastline and cliffline.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file beach_width_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief checks SegmentGrid nearest segment queries against brute force
+@details Indexes the Benacre cliffline and coastline with SegmentGrid and, for
+the nodes of the other line and for points scattered around them, finds the
+nearest segment with SegmentGrid::Nearest and by testing every segment.
+Reports any queries that disagree and the time taken each way. Copy the Benacre files from example_inputs to the working directory
+before running.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../segmentgrid.hpp"
+
+using namespace std;
+
+/// @brief Nearest segment of the line X, Y to the point PX, PY by testing every segment
+int BruteNearest(const vector<double>& X, const vector<double>& Y, double PX, double PY, double& Distance)
+{
+	int Best = -1;
+	double BestDistance2 = 0;
+	for (int j=0, n=X.size(); j<n-1; ++j)
+	{
+		double dX = X[j+1]-X[j], dY = Y[j+1]-Y[j];
+		double Length2 = dX*dX + dY*dY;
+		double t = (Length2 > 0) ? ((PX-X[j])*dX + (PY-Y[j])*dY)/Length2 : 0;
+		if (t < 0) t = 0;
+		else if (t > 1) t = 1;
+		double ex = X[j]+t*dX-PX, ey = Y[j]+t*dY-PY;
+		if (Best < 0 || ex*ex + ey*ey < BestDistance2) Best = j, BestDistance2 = ex*ex + ey*ey;
+	}
+	Distance = sqrt(BestDistance2);
+	return Best;
+}
+
+/// @brief Checks queries on the line X, Y from points around the nodes of the line PX, PY
+/// @return int, number of queries that disagree
+int CheckLine(const char* Name, const vector<double>& X, const vector<double>& Y, const vector<double>& PX, const vector<double>& PY,
+		int NoRepeats, double Scatter)
+{
+	SegmentGrid Grid;
+	Grid.Build(&X[0], &Y[0], X.size()-1);
+
+	//points at the nodes and scattered around them
+	vector<double> QX, QY;
+	for (int r=0; r<NoRepeats; ++r)
+	{
+		for (int i=0, n=PX.size(); i<n; ++i)
+		{
+			double Spread = (r == 0) ? 0 : Scatter;
+			QX.push_back(PX[i] + Spread*(2.*rand()/RAND_MAX-1.));
+			QY.push_back(PY[i] + Spread*(2.*rand()/RAND_MAX-1.));
+		}
+	}
+	int NoQueries = QX.size();
+
+	//nearest segment
+	int NoMismatches = 0;
+	vector<int> GridResult(NoQueries), BruteResult(NoQueries);
+	vector<double> GridDistance(NoQueries), BruteDistance(NoQueries);
+	double t;
+	clock_t Start = clock();
+	for (int q=0; q<NoQueries; ++q) GridResult[q] = Grid.Nearest(&X[0], &Y[0], QX[q], QY[q], GridDistance[q], t);
+	double GridTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	Start = clock();
+	for (int q=0; q<NoQueries; ++q) BruteResult[q] = BruteNearest(X, Y, QX[q], QY[q], BruteDistance[q]);
+	double BruteTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	for (int q=0; q<NoQueries; ++q)
+	{
+		if (GridResult[q] != BruteResult[q] || GridDistance[q] != BruteDistance[q]) ++NoMismatches;
+	}
+	cout << Name << ": " << X.size()-1 << " segments, " << NoQueries << " nearest queries, "
+	     << NoMismatches << " differ, grid " << GridTime << " s, all segments " << BruteTime << " s" << endl;
+
+	return NoMismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	//number of scattered copies of each node and how far they are scattered (m) can be given as arguments
+	int NoRepeats = 20;
+	double Scatter = 200.;
+	if (argc > 1) NoRepeats = atoi(argv[1]);
+	if (argc > 2) Scatter = atof(argv[2]);
+
+	srand(1);
+	Cliffline CliffVector("Benacre_Cliffline_Points.xy", 0);
+	Coastline CoastVector("Benacre_Coastline_Points.xy", 0);
+	vector<double> CoastX = CoastVector.get_X(), CoastY = CoastVector.get_Y();
+	vector<double> CliffX = CliffVector.get_X(), CliffY = CliffVector.get_Y();
+
+	cout << endl;
+	int NoMismatches = CheckLine("Cliff from the beach", CliffX, CliffY, CoastX, CoastY, NoRepeats, Scatter);
+	NoMismatches += CheckLine("Beach from the cliff", CoastX, CoastY, CliffX, CliffY, NoRepeats, Scatter);
+
+	if (NoMismatches > 0)
+	{
+		cout << "SegmentGrid queries differ from a search of every segment" << endl;
+		exit(EXIT_FAILURE);
+	}
+	cout << "SegmentGrid queries match a search of every segment" << endl;
+	return 0;
+}
@@ -58,6 +58,7 @@ boundaries are periodic. Sediment is passed from one end to the other.
 #include "../coastline.hpp"
 #include "../cliffline.hpp"
 #include "../waveclimate.hpp"
+#include "../coastcliffsystem.hpp"
 
 using namespace std;
 
@@ -105,6 +106,9 @@ int main(int argc, char* argv[])
 	double OffshoreMeanWaveHeight2 = 1.1;
 	double OffshoreStDWaveHeight2 = 0.2;
 	GaussianWaveClimate WaveClimate2(OffshoreMeanWavePeriod2,OffshoreStDWavePeriod2,OffshoreMeanWaveDirection2,OffshoreStDWaveDirection2,OffshoreMeanWaveHeight2, OffshoreStDWaveHeight2);
+	
+	//random numbers for choosing between the wave climates, separate from the climates' own
+	RandomStream ClimateChooser(1);
   
   //declare wave	
 	Wave MyWave = Wave();
@@ -152,6 +156,13 @@ int main(int argc, char* argv[])
 	int FluxType = 2;
 	CoastVector.SetFluxType(FluxType);
 	
+	// Couple the beach and cliff so they are stepped together
+	// The cliff can be moved less often than the beach is stepped, set CliffTimeDelta (days)
+	// to e.g. 10 to move it every 10 days rather than every step
+	double CliffTimeDelta = 0.;
+	CoastCliffSystem CoastAndCliff(CoastVector, CliffVector, ErosionType);
+	CoastAndCliff.SetCliffTimeDelta(CliffTimeDelta);
+
 	// Holder for random number sampling
 	double rand1;
 	
@@ -162,21 +173,21 @@ int main(int argc, char* argv[])
 		if (Time > GetWaveTime) 
 		{
 			// Use a random sampler to chose between wave climates
-			rand1 = (double)rand()/RAND_MAX;
+			rand1 = ClimateChooser.Uniform();
 			if (rand1 < 0.5) MyWave = WaveClimate1.Get_Wave();
 			else MyWave = WaveClimate2.Get_Wave();
 			GetWaveTime += WaveTimeDelta/365.;
 		}
 		
 		//Evolve coast
-		CoastVector.TransportSediment(TimeStep, MyWave, CliffVector);
-		CliffVector.ErodeCliff(TimeStep, CoastVector, ErosionType);
+		CoastAndCliff.Step(TimeStep, MyWave);
 		Time += TimeStep/365.;
 		TimeStep = MaxTimeStep;
 		
 		//print to file?
 		if (Time >= PrintTime)
 		{
+			CoastAndCliff.UpdateCliff();
 			CoastVector.WriteCoast(WriteCoastFile, PrintTime);
 			CliffVector.WriteCliff(WriteCliffFile, PrintTime);
 			PrintTime += PrintTimeDelta;
@@ -185,6 +196,7 @@ int main(int argc, char* argv[])
   //WriteWaveOut.close();
     
   //write final coastline to file
+	CoastAndCliff.UpdateCliff();
 	CoastVector.WriteCoast(WriteCoastFile, EndTime);
 	CliffVector.WriteCliff(WriteCliffFile, EndTime);
 	cout << endl << "Coastline/Cliffline: Model run complete." << endl << endl;
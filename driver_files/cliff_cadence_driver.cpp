@@ -0,0 +1,195 @@
+/*==============================================================
+
+cliff_cadence_driver.cpp
+
+A driver function to compare the Benacre example run with the
+cliff moved every step against runs with the cliff moved less
+often than the beach is stepped.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file cliff_cadence_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief multi-rate stepping of the beach and cliff
+@details Runs the Benacre example (as benacre_driver) through CoastCliffSystem
+from the same sequence of waves, first moving the cliff every 0.2 day step (the
+reference) and then every 1, 5, 10 and 30 days (CoastCliffSystem::SetCliffTimeDelta).
+For each it reports the number of cliff moves at the interval and at print times
+(to bring the cliff up to date), how many times fewer that is than the reference,
+the run time, the largest rms distance between its coastline and cliff line and
+those of the reference at the print times, and the volume supplied by the cliff
+to the beach. Copy the Benacre
+files from example_inputs to the working directory before running.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+#include "./../coastcliffsystem.hpp"
+
+using namespace std;
+
+/// @brief rms distance from the nodes of line 1 to line 2 (m)
+double LineDistance(const vector<double>& X1, const vector<double>& Y1, const vector<double>& X2, const vector<double>& Y2)
+{
+	double SumSquares = 0;
+	int n1 = X1.size(), n2 = X2.size();
+	for (int i=0; i<n1; ++i)
+	{
+		double MinDistance2 = 1e30;
+		for (int j=0; j<n2-1; ++j)
+		{
+			//nearest point on segment j
+			double dX = X2[j+1]-X2[j], dY = Y2[j+1]-Y2[j];
+			double Length2 = dX*dX + dY*dY;
+			double t = (Length2 > 0) ? ((X1[i]-X2[j])*dX + (Y1[i]-Y2[j])*dY)/Length2 : 0;
+			if (t < 0) t = 0;
+			else if (t > 1) t = 1;
+			double ex = X2[j]+t*dX-X1[i], ey = Y2[j]+t*dY-Y1[i];
+			if (ex*ex + ey*ey < MinDistance2) MinDistance2 = ex*ex + ey*ey;
+		}
+		SumSquares += MinDistance2;
+	}
+	return sqrt(SumSquares/n1);
+}
+
+/// @brief rms distance between two lines, the mean of the distances each way (m)
+double Drift(const vector<double>& X1, const vector<double>& Y1, const vector<double>& X2, const vector<double>& Y2)
+{
+	return 0.5*(LineDistance(X1, Y1, X2, Y2) + LineDistance(X2, Y2, X1, Y1));
+}
+
+/// @brief Area between a cliff line and its starting position (m2), the cliff lost times its height is the volume eroded
+double AreaChange(const vector<double>& X0, const vector<double>& Y0, const vector<double>& X1, const vector<double>& Y1)
+{
+	//shoelace formula around the polygon of the new line and the old line reversed
+	vector<double> XX(X1), YY(Y1);
+	XX.insert(XX.end(), X0.rbegin(), X0.rend());
+	YY.insert(YY.end(), Y0.rbegin(), Y0.rend());
+	double Area = 0;
+	for (int i=0, n=XX.size(); i<n; ++i) Area += XX[i]*YY[(i+1)%n] - XX[(i+1)%n]*YY[i];
+	return fabs(0.5*Area);
+}
+
+int main(int argc, char* argv[])
+{
+	//run length (years) can be given as an argument
+	double EndTime = 2.;
+	if (argc > 1) EndTime = atof(argv[1]);
+
+	double TimeDelta = 0.2; //(days), a new wave every step
+	int StepsPerPrint = 183; //print about every 36.5 days, as benacre_driver
+	int ErosionType = 1;
+	double CliffHeight = 10.;
+
+	//the same waves for every run, sampled at random from two climates
+	RandomStream ClimateChooser(1);
+	GaussianWaveClimate WaveClimate1(6., 2., 45., 20., 0.8, 0.2);
+	GaussianWaveClimate WaveClimate2(5., 1., 140., 20., 1.1, 0.2);
+	int NoSteps = (int)(EndTime*365./TimeDelta + 0.5);
+	vector<Wave> Waves(NoSteps);
+	for (int k=0; k<NoSteps; ++k)
+	{
+		double rand1 = ClimateChooser.Uniform();
+		Waves[k] = (rand1 < 0.5) ? WaveClimate1.Get_Wave() : WaveClimate2.Get_Wave();
+	}
+
+	//run 0 is the reference, moving the cliff every step
+	int NoRuns = 5;
+	double CliffTimeDelta[] = {0, 1., 5., 10., 30.};
+	vector< vector<double> > CoastX, CoastY, CliffX, CliffY;
+	double ReferenceTime = 0;
+	int ReferenceMoves = 0;
+
+	for (int n=0; n<NoRuns; ++n)
+	{
+		Cliffline CliffVector("Benacre_Cliffline_Points.xy", 0);
+		Coastline CoastVector("Benacre_Coastline_Points.xy", 0);
+		CliffVector.ReadCliffType("Benacre_Fixed_Cliffs.data");
+		CliffVector.SetMaxRetreatRate(5.);
+		CliffVector.SetCliffHeight(CliffHeight);
+		CliffVector.SetCriticalWidth(5.);
+		CliffVector.SetLostFraction(0.2);
+		CoastVector.SetFluxType(2);
+		CoastCliffSystem CoastAndCliff(CoastVector, CliffVector, ErosionType);
+		CoastAndCliff.SetCliffTimeDelta(CliffTimeDelta[n]);
+		vector<double> CliffX0 = CliffVector.get_X(), CliffY0 = CliffVector.get_Y();
+
+		clock_t Start = clock();
+		int NoPrints = 0;
+		double MaxCoastDrift = 0, MaxCliffDrift = 0;
+		for (int k=0; k<NoSteps; ++k)
+		{
+			double TimeStep = TimeDelta;
+			CoastAndCliff.Step(TimeStep, Waves[k]);
+			if ((k+1) % StepsPerPrint != 0 && k != NoSteps-1) continue;
+
+			//compare at print times, with the cliff brought up to date as it would be to write it
+			CoastAndCliff.UpdateCliff();
+			if (n == 0)
+			{
+				CoastX.push_back(CoastVector.get_X()), CoastY.push_back(CoastVector.get_Y());
+				CliffX.push_back(CliffVector.get_X()), CliffY.push_back(CliffVector.get_Y());
+			}
+			else
+			{
+				double CoastDrift = Drift(CoastVector.get_X(), CoastVector.get_Y(), CoastX[NoPrints], CoastY[NoPrints]);
+				double CliffDrift = Drift(CliffVector.get_X(), CliffVector.get_Y(), CliffX[NoPrints], CliffY[NoPrints]);
+				if (CoastDrift > MaxCoastDrift) MaxCoastDrift = CoastDrift;
+				if (CliffDrift > MaxCliffDrift) MaxCliffDrift = CliffDrift;
+			}
+			++NoPrints;
+		}
+		double RunTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+		double Eroded = CliffHeight*AreaChange(CliffX0, CliffY0, CliffVector.get_X(), CliffVector.get_Y());
+
+		int NoMoves = CoastAndCliff.get_NoCliffUpdates()+CoastAndCliff.get_NoCliffSyncs();
+		if (n == 0) ReferenceTime = RunTime, ReferenceMoves = NoMoves;
+		cout << "Cliff moved every " << ((n == 0) ? TimeDelta : CliffTimeDelta[n]) << " days: "
+		     << CoastAndCliff.get_NoCliffUpdates() << " cliff moves and " << CoastAndCliff.get_NoCliffSyncs()
+		     << " at print times, " << (double)ReferenceMoves/NoMoves << " times fewer, " << RunTime << " s, speedup "
+		     << ReferenceTime/RunTime << ", volume eroded " << Eroded << " m3" << endl;
+		if (n > 0)
+		{
+			cout << "    largest rms drift from the reference, coast " << MaxCoastDrift
+			     << " m, cliff " << MaxCliffDrift << " m" << endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,146 @@
+/*==============================================================
+
+flux_kernel_driver.cpp
+
+A driver function to check the batched longshore flux kernels
+against the original node by node CERC equations used in
+Coastline::CalculateFlux, and to time both.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file flux_kernel_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief regression check and timing for the batched flux kernels
+@details Fills arrays of 1e3 to 1e6 random breaking wave heights and angles
+and evaluates the CERC equation (FluxType 1) with FluxKernels and with the
+original node by node expression, including its per-node FluxType branch and
+NaN check. Reports the time per node for each and exits with failure if any
+flux differs by more than a few rounding errors.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../fluxkernels.hpp"
+
+using namespace std;
+
+/// @brief The original node by node CERC equation from Coastline::CalculateFlux
+void ScalarFlux(int FluxType, const vector<double>& H, const vector<double>& Angle, vector<double>& Flux)
+{
+	int N = H.size();
+	for (int i=0; i<N; ++i)
+	{
+		if (FluxType == 1)
+		{
+			Flux[i] = 86400.*0.41
+							*pow(H[i],2.5)
+							*sin((M_PI/180.0)*Angle[i])
+							*cos((M_PI/180.0)*Angle[i]);
+
+			if (Flux[i] != Flux[i])
+			{
+				cout << "I am not equal to myself!!" << endl;
+				cout << "Found NaN in Position Change: Node is " << i << endl;
+			}
+		}
+		else if (FluxType == 2)
+		{
+			Flux[i] = 86400.*0.054
+							*pow(H[i],2.5)
+							*sin((M_PI/180.0)*Angle[i])
+							*cos((M_PI/180.0)*Angle[i]);
+		}
+	}
+}
+
+int main()
+{
+	srand(1);
+	int NoFailures = 0;
+	int FluxType = 1;
+
+	for (int N=1000; N<=1000000; N*=10)
+	{
+		vector<double> H(N), Angle(N), ScalarResult(N), KernelResult(N);
+		for (int i=0; i<N; ++i)
+		{
+			H[i] = 4.*rand()/RAND_MAX;
+			Angle[i] = -60.+120.*rand()/RAND_MAX;
+		}
+
+		//repeat so that every size does about 2e7 nodes
+		int NoRepeats = 20000000/N;
+		double Sum = 0;
+
+		clock_t Start = clock();
+		for (int r=0; r<NoRepeats; ++r)
+		{
+			ScalarFlux(FluxType, H, Angle, ScalarResult);
+			Sum += ScalarResult[r%N];
+		}
+		double ScalarTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+
+		Start = clock();
+		for (int r=0; r<NoRepeats; ++r)
+		{
+			FluxKernels::CERC(86400.*0.41/2., &H[0], &Angle[0], &KernelResult[0], N);
+			if (FluxKernels::CountNaN(&KernelResult[0], N) > 0) cout << "Found NaN in flux" << endl;
+			Sum += KernelResult[r%N];
+		}
+		double KernelTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+
+		//relative to the largest flux, sin(2x)/2 and sin(x)cos(x) differ most near zero
+		double MaxFlux = 0, MaxDiff = 0;
+		for (int i=0; i<N; ++i)
+		{
+			MaxFlux = max(MaxFlux, fabs(ScalarResult[i]));
+			MaxDiff = max(MaxDiff, fabs(KernelResult[i]-ScalarResult[i]));
+		}
+		if (MaxDiff > 1e-14*MaxFlux) ++NoFailures;
+
+		cout << "N = " << N << ": scalar " << 1e9*ScalarTime/((double)NoRepeats*N) << " ns/node, kernel "
+		     << 1e9*KernelTime/((double)NoRepeats*N) << " ns/node, speedup " << ScalarTime/KernelTime
+		     << ", max difference " << MaxDiff/MaxFlux << " of max flux (" << Sum << ")" << endl;
+	}
+
+	if (NoFailures > 0)
+	{
+		cout << "Kernel fluxes differ from the scalar equation" << endl;
+		exit(EXIT_FAILURE);
+	}
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*==============================================================
+
+mesh_window_driver.cpp
+
+A driver function to check that rebuilding the shoreface cells
+only round the dirty nodes gives the same cells as rebuilding
+them all, and to time the two.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file mesh_window_driver.cpp
+@brief checks windowed rebuilds of the shoreface mesh against full rebuilds
+@details Evolves a straight periodic coast under mostly low angle and mostly
+high angle UA waves, with a mesh tolerance so that only part of the coast is
+dirty at a time. With the mesh debug flag on, every
+windowed rebuild is compared with a full rebuild, and the driver exits with
+failure if any rebuilt cell differs or no windowed rebuilds were made. Each
+coast is then run again without the check, rebuilding windows and rebuilding
+every cell whenever a node is dirty, and the times are reported.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+//Mesh counts and errors from a run
+struct MeshRun
+{
+	int NoNodes, NoBuilds, NoWindowed, RecieverErrors;
+	double DsfError, AreaError, Time;
+};
+
+//Evolves one of the test coasts
+MeshRun Run(int Case, double MeshTolerance, int MeshHalo, int DebugFlag, int NoSteps)
+{
+	Coastline CoastVector(50, 10000., 180., 1, 1);
+	Cliffline CliffVector;
+	CoastVector.SetFluxType(1);
+	CoastVector.SetMeshTolerance(MeshTolerance);
+	CoastVector.SetMeshHalo(MeshHalo);
+	CoastVector.SetMeshDebugFlag(DebugFlag);
+
+	//mostly low angle waves, or mostly high angle waves that grow cuspate features
+	UAWaveClimate WaveClimate((Case == 0) ? 0.3 : 0.55, 0.6, 180., 6., 1., 1., 0.1);
+	Wave MyWave = WaveClimate.Get_Wave();
+
+	double WaveTimeDelta = 5., GetWaveTime = WaveTimeDelta, Time = 0;
+	clock_t Start = clock();
+	for (int Step=0; Step<NoSteps; ++Step)
+	{
+		if (Time >= GetWaveTime)
+		{
+			MyWave = WaveClimate.Get_Wave();
+			GetWaveTime += WaveTimeDelta;
+		}
+		double TimeStep = 0.1;
+		CoastVector.TransportSediment(TimeStep, MyWave, CliffVector);
+		Time += TimeStep;
+	}
+
+	MeshRun Result;
+	Result.Time = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	Result.NoNodes = CoastVector.get_NoNodes();
+	Result.NoBuilds = CoastVector.get_NoMeshBuilds();
+	Result.NoWindowed = CoastVector.get_NoWindowedMeshBuilds();
+	Result.DsfError = CoastVector.get_MaxWindowDsfError();
+	Result.AreaError = CoastVector.get_MaxWindowAreaError();
+	Result.RecieverErrors = CoastVector.get_NoWindowRecieverErrors();
+	return Result;
+}
+
+int main(int argc, char* argv[])
+{
+	//mesh tolerance (m), halo (nodes) and number of steps can be given as arguments
+	double MeshTolerance = 0.5;
+	int MeshHalo = 10;
+	int NoSteps = 2000;
+	if (argc > 1) MeshTolerance = atof(argv[1]);
+	if (argc > 2) MeshHalo = atoi(argv[2]);
+	if (argc > 3) NoSteps = atoi(argv[3]);
+
+	const char* Names[2] = {"low angle waves", "high angle waves"};
+	int Failed = 0;
+	for (int Case=0; Case<2; ++Case)
+	{
+		MeshRun Checked = Run(Case, MeshTolerance, MeshHalo, 1, NoSteps);
+		int Pass = (Checked.NoWindowed > 0 && Checked.DsfError < 1.e-6 && Checked.AreaError < 1.e-6 && Checked.RecieverErrors == 0);
+		if (Pass == 0) Failed = 1;
+		cout << (Pass ? "pass  " : "FAIL  ") << Names[Case] << ", " << Checked.NoNodes << " nodes" << endl;
+		cout << "      " << Checked.NoWindowed << " windowed rebuilds: max Dsf difference " << Checked.DsfError << " m, max relative Area difference "
+			<< Checked.AreaError << ", " << Checked.RecieverErrors << " reciever lists differ" << endl;
+
+		MeshRun Windowed = Run(Case, MeshTolerance, MeshHalo, 0, NoSteps);
+		MeshRun Full = Run(Case, MeshTolerance, -1, 0, NoSteps);
+		cout << "      windows: " << Windowed.NoBuilds << " full and " << Windowed.NoWindowed << " windowed rebuilds, " << Windowed.Time << " s" << endl;
+		cout << "      no windows: " << Full.NoBuilds << " full rebuilds, " << Full.Time << " s" << endl;
+	}
+
+	if (Failed)
+	{
+		cout << "Windowed rebuilds differ from full rebuilds" << endl;
+		exit(EXIT_FAILURE);
+	}
+	return 0;
+}
@@ -0,0 +1,227 @@
+/*==============================================================
+
+morfac_driver.cpp
+
+A driver function to compare the Benacre example run with waves
+applied one at a time against the same run with consecutive
+similar waves merged into wave events (morphological acceleration).
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file morfac_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief drift of a morphologically accelerated run from the reference
+@details Runs the Benacre example (as Future_Benacre_Prog, with the bimodal
+wave climate of its comments) from the same sequence of waves, a new wave
+every 0.2 days. The reference run calls TransportSediment once per wave. The
+accelerated runs merge consecutive similar waves into events with
+WaveEventAggregator and call TransportSediment once per event with adaptive
+timesteps, first with the tolerances given and then with them doubled, and so
+on. For each it reports the acceleration factor (waves per event), steps and
+run time, and the largest rms distance between its coastline and cliff line
+and those of the reference at the print times. Copy the Benacre files from
+example_inputs to the working directory before running.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+#include "./../waveevents.hpp"
+
+using namespace std;
+
+/// @brief rms distance from the nodes of line 1 to line 2 (m)
+double LineDistance(const vector<double>& X1, const vector<double>& Y1, const vector<double>& X2, const vector<double>& Y2)
+{
+	double SumSquares = 0;
+	int n1 = X1.size(), n2 = X2.size();
+	for (int i=0; i<n1; ++i)
+	{
+		double MinDistance2 = 1e30;
+		for (int j=0; j<n2-1; ++j)
+		{
+			//nearest point on segment j
+			double dX = X2[j+1]-X2[j], dY = Y2[j+1]-Y2[j];
+			double Length2 = dX*dX + dY*dY;
+			double t = (Length2 > 0) ? ((X1[i]-X2[j])*dX + (Y1[i]-Y2[j])*dY)/Length2 : 0;
+			if (t < 0) t = 0;
+			else if (t > 1) t = 1;
+			double ex = X2[j]+t*dX-X1[i], ey = Y2[j]+t*dY-Y1[i];
+			if (ex*ex + ey*ey < MinDistance2) MinDistance2 = ex*ex + ey*ey;
+		}
+		SumSquares += MinDistance2;
+	}
+	return sqrt(SumSquares/n1);
+}
+
+/// @brief rms distance between two lines, the mean of the distances each way (m)
+double Drift(const vector<double>& X1, const vector<double>& Y1, const vector<double>& X2, const vector<double>& Y2)
+{
+	return 0.5*(LineDistance(X1, Y1, X2, Y2) + LineDistance(X2, Y2, X1, Y1));
+}
+
+/// @brief Evolves the coast and cliffs through a wave event
+/// @details TransportSediment may take a shorter step than asked for when
+/// adaptive, so it is called until the whole event has been applied.
+/// @return int, number of steps taken
+int ApplyEvent(WaveEvent Event, Coastline& CoastVector, Cliffline& CliffVector, int ErosionType)
+{
+	int NoSteps = 0;
+	double Remaining = Event.Duration;
+	while (Remaining > 1e-9)
+	{
+		double TimeStep = Remaining;
+		CoastVector.TransportSediment(TimeStep, Event.TheWave, CliffVector);
+		CliffVector.ErodeCliff(TimeStep, CoastVector, ErosionType);
+		Remaining -= TimeStep;
+		++NoSteps;
+	}
+	return NoSteps;
+}
+
+int main(int argc, char* argv[])
+{
+	//run length (years) and event tolerances can be given as arguments
+	double EndTime = 1.;
+	double HeightTolerance = 0.1, PeriodTolerance = 1., DirectionTolerance = 10., MaxEventDuration = 5.;
+	if (argc > 1) EndTime = atof(argv[1]);
+	if (argc > 2) HeightTolerance = atof(argv[2]);
+	if (argc > 3) PeriodTolerance = atof(argv[3]);
+	if (argc > 4) DirectionTolerance = atof(argv[4]);
+	if (argc > 5) MaxEventDuration = atof(argv[5]);
+
+	double WaveTimeDelta = 0.2; //(days)
+	int WavesPerPrint = 183; //print about every 36.5 days, as Future_Benacre_Prog
+	int ErosionType = 1;
+
+	//the same waves for every run, sampled at random from two climates
+	RandomStream ClimateChooser(1);
+	GaussianWaveClimate WaveClimate1(6., 2., 45., 20., 0.8, 0.2);
+	GaussianWaveClimate WaveClimate2(5., 1., 140., 20., 1.1, 0.2);
+	int NoWaves = (int)(EndTime*365./WaveTimeDelta + 0.5);
+	vector<Wave> Waves(NoWaves);
+	for (int k=0; k<NoWaves; ++k)
+	{
+		double rand1 = ClimateChooser.Uniform();
+		Waves[k] = (rand1 < 0.5) ? WaveClimate1.Get_Wave() : WaveClimate2.Get_Wave();
+	}
+
+	//run 0 is the reference, the others are accelerated with the tolerances scaled up
+	int NoRuns = 5;
+	double ToleranceScale[] = {0, 1., 2., 4., 8.};
+	vector< vector<double> > CoastX, CoastY, CliffX, CliffY;
+	double ReferenceTime = 0;
+
+	for (int n=0; n<NoRuns; ++n)
+	{
+		Cliffline CliffVector("Benacre_Cliffline_Points.xy", 0);
+		Coastline CoastVector("Benacre_Coastline_Points.xy", 0);
+		CliffVector.ReadCliffType("Benacre_Fixed_Cliffs.data");
+		CliffVector.SetMaxRetreatRate(5.);
+		CliffVector.SetCliffHeight(10.);
+		CliffVector.SetCriticalWidth(5.);
+		CliffVector.SetLostFraction(0.2);
+		CoastVector.SetFluxType(2);
+		if (n > 0)
+		{
+			CoastVector.SetAdaptiveTimeStep(1);
+			CoastVector.SetTimeStepLimits(0.001, MaxEventDuration, 10., 0.5);
+		}
+		WaveEventAggregator Events(ToleranceScale[n]*HeightTolerance, ToleranceScale[n]*PeriodTolerance,
+		                           ToleranceScale[n]*DirectionTolerance, MaxEventDuration);
+
+		clock_t Start = clock();
+		int NoSteps = 0, NoPrints = 0;
+		double MaxCoastDrift = 0, MaxCliffDrift = 0;
+		for (int k=0; k<NoWaves; ++k)
+		{
+			int PrintNow = ((k+1) % WavesPerPrint == 0 || k == NoWaves-1) ? 1 : 0;
+			if (n == 0)
+			{
+				//reference, one step per wave
+				double TimeStep = WaveTimeDelta;
+				CoastVector.TransportSediment(TimeStep, Waves[k], CliffVector);
+				CliffVector.ErodeCliff(TimeStep, CoastVector, ErosionType);
+				++NoSteps;
+			}
+			else
+			{
+				//accelerated, one call per event, events end at print times so the runs can be compared
+				if (Events.Add(Waves[k], WaveTimeDelta) == 1)
+				{
+					NoSteps += ApplyEvent(Events.Get_Event(), CoastVector, CliffVector, ErosionType);
+				}
+				if (PrintNow == 1 && Events.Flush() == 1)
+				{
+					NoSteps += ApplyEvent(Events.Get_Event(), CoastVector, CliffVector, ErosionType);
+				}
+			}
+			if (PrintNow == 0) continue;
+
+			if (n == 0)
+			{
+				CoastX.push_back(CoastVector.get_X()), CoastY.push_back(CoastVector.get_Y());
+				CliffX.push_back(CliffVector.get_X()), CliffY.push_back(CliffVector.get_Y());
+			}
+			else
+			{
+				double CoastDrift = Drift(CoastVector.get_X(), CoastVector.get_Y(), CoastX[NoPrints], CoastY[NoPrints]);
+				double CliffDrift = Drift(CliffVector.get_X(), CliffVector.get_Y(), CliffX[NoPrints], CliffY[NoPrints]);
+				if (CoastDrift > MaxCoastDrift) MaxCoastDrift = CoastDrift;
+				if (CliffDrift > MaxCliffDrift) MaxCliffDrift = CliffDrift;
+			}
+			++NoPrints;
+		}
+		double RunTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+
+		if (n == 0)
+		{
+			ReferenceTime = RunTime;
+			cout << endl << "Reference: " << NoWaves << " waves, " << NoSteps << " steps, " << RunTime << " s" << endl << endl;
+			continue;
+		}
+		cout << "Tolerances x" << ToleranceScale[n] << ": " << Events.get_NoEvents() << " events, "
+		     << (double)Events.get_NoWaves()/Events.get_NoEvents() << " waves per event, "
+		     << NoSteps << " steps (" << CoastVector.get_NoRejectedSteps() << " rejected), "
+		     << RunTime << " s, speedup " << ReferenceTime/RunTime << endl
+		     << "    largest rms drift from the reference, coast " << MaxCoastDrift
+		     << " m, cliff " << MaxCliffDrift << " m" << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,131 @@
+/*==============================================================
+
+omp_scaling_driver.cpp
+
+A driver function to time the OpenMP parallel per-node loops in
+Coastline::TransportSediment on a long straight periodic coast,
+and check that results don't depend on the number of threads.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file omp_scaling_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief scaling benchmark for the OpenMP per-node loops
+@details Evolves the same straight periodic coast under the same UA wave
+climate with 1, 2, 4, 8 and 16 threads, reports the run time and speedup
+over one thread, and exits with failure if any run ends with a coast that
+differs from the one thread run. Must be compiled with -fopenmp (see
+omp_scaling_make.make) for the thread count to have any effect.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+/// @brief Wall clock time in seconds, clock() counts the time of every thread
+double WallTime()
+{
+#ifdef _OPENMP
+	return omp_get_wtime();
+#else
+	return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+	//coast length (m) and number of timesteps can be given as arguments
+	double CoastLength = 100000.;
+	int NoSteps = 200;
+	if (argc > 1) CoastLength = atof(argv[1]);
+	if (argc > 2) NoSteps = atoi(argv[2]);
+
+#ifndef _OPENMP
+	cout << "Warning: compiled without OpenMP, every run will use one thread" << endl;
+#endif
+
+	int NodeSpacing = 100;
+	double Trend = 180.;
+	int NoThreadCounts = 5;
+	int ThreadCounts[] = {1, 2, 4, 8, 16};
+	double Time[5];
+	vector<double> X1, Y1;
+	int NoDifferent = 0;
+
+	for (int n=0; n<NoThreadCounts; ++n)
+	{
+		//same coast for every thread count, and a new climate samples the same sequence of waves
+		Coastline CoastVector(NodeSpacing, CoastLength, Trend, 1, 1);
+		Cliffline CliffVector;
+		CoastVector.SetFluxType(1);
+		CoastVector.SetNumThreads(ThreadCounts[n]);
+		UAWaveClimate WaveClimate(0.6, 0.7, Trend, 6., 1., 1., 0.1);
+		Wave MyWave = WaveClimate.Get_Wave();
+
+		double Start = WallTime();
+		for (int Step=0; Step<NoSteps; ++Step)
+		{
+			double TimeStep = 0.1;
+			MyWave = WaveClimate.Get_Wave();
+			CoastVector.TransportSediment(TimeStep, MyWave, CliffVector);
+		}
+		Time[n] = WallTime()-Start;
+
+		//compare with the one thread run
+		vector<double> X = CoastVector.get_X();
+		vector<double> Y = CoastVector.get_Y();
+		if (n == 0) X1 = X, Y1 = Y;
+		else if (X != X1 || Y != Y1)
+		{
+			cout << ThreadCounts[n] << " threads: coast differs from the one thread run!" << endl;
+			++NoDifferent;
+		}
+
+		cout << ThreadCounts[n] << " threads: " << CoastVector.get_NoNodes() << " nodes, " << NoSteps << " steps in "
+		     << Time[n] << " s, speedup " << Time[0]/Time[n] << endl;
+	}
+
+	if (NoDifferent > 0) exit(EXIT_FAILURE);
+	return 0;
+}
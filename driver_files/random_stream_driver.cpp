@@ -0,0 +1,188 @@
+/*==============================================================
+
+random_stream_driver.cpp
+
+A driver function to check the counter-based random numbers used
+by the wave climates and to time them against rand().
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file random_stream_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief checks and times RandomStream
+@details Checks RandomStream against the Philox4x32-10 known answers of
+Random123, that the batch samplers give the same numbers as single calls, that
+moving to a position gives the numbers that would have been generated there,
+the mean and variance of its uniform and normal deviates, and that wave
+climates give the same waves whatever order they are made and sampled in. Then
+times normal deviates from rand(), as the climates used to, from
+RandomStream::Normal and from RandomStream::Normals. Exits with failure if any
+check fails.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../waveclimate.hpp"
+#include "./../randomstream.hpp"
+
+using namespace std;
+
+int NoFailures = 0;
+
+void Check(const char* Name, int Passed)
+{
+	cout << (Passed ? "pass  " : "FAIL  ") << Name << endl;
+	if (!Passed) ++NoFailures;
+}
+
+int SameWave(Wave A, Wave B)
+{
+	return A.Get_WaveHeight() == B.Get_WaveHeight() && A.Get_WavePeriod() == B.Get_WavePeriod()
+	       && A.Get_WaveDirection() == B.Get_WaveDirection();
+}
+
+int main(int argc, char* argv[])
+{
+	//number of deviates to time can be given as an argument
+	int NoDeviates = 10000000;
+	if (argc > 1) NoDeviates = atoi(argv[1]);
+
+	//known answers, Random123 kat_vectors
+	uint32_t Counters[3][4] = {{0, 0, 0, 0}, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	                           {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+	uint32_t Keys[3][2] = {{0, 0}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}};
+	uint32_t Answers[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+	                          {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+	                          {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+	int KnownAnswers = 1;
+	for (int k=0; k<3; ++k)
+	{
+		uint32_t Out[4];
+		RandomStream::Philox(Counters[k], Keys[k], Out);
+		for (int c=0; c<4; ++c) if (Out[c] != Answers[k][c]) KnownAnswers = 0;
+	}
+	Check("Philox4x32-10 known answers", KnownAnswers);
+
+	//batches match single calls, including an odd count after a spare deviate
+	RandomStream Single(7, 3), Batch(7, 3);
+	vector<double> Values(1001);
+	int SameBatch = 1;
+	Single.Normal(), Batch.Normal();
+	Batch.Normals(&Values[0], 1001);
+	for (int k=0; k<1001; ++k) if (Single.Normal() != Values[k]) SameBatch = 0;
+	Batch.Uniforms(&Values[0], 1000);
+	for (int k=0; k<1000; ++k) if (Single.Uniform() != Values[k]) SameBatch = 0;
+	Check("Normals and Uniforms match Normal and Uniform", SameBatch);
+
+	//skipping ahead
+	RandomStream Sequential(11, 5), Skipped(11, 5);
+	for (int k=0; k<4000; ++k) Sequential.Next32();
+	Skipped.SetPosition(1000);
+	int SameSkip = 1;
+	for (int k=0; k<100; ++k) if (Sequential.Next32() != Skipped.Next32()) SameSkip = 0;
+	Check("SetPosition gives the numbers generated there", SameSkip);
+
+	//moments
+	RandomStream Moments(1, 0);
+	int NoSamples = 1000000;
+	double Sum = 0, SumSquares = 0, USum = 0, UMin = 1, UMax = 0;
+	for (int k=0; k<NoSamples; ++k)
+	{
+		double z = Moments.Normal();
+		Sum += z, SumSquares += z*z;
+		double u = Moments.Uniform();
+		USum += u, UMin = min(UMin, u), UMax = max(UMax, u);
+	}
+	double Mean = Sum/NoSamples, Variance = SumSquares/NoSamples - Mean*Mean;
+	cout << "      normal mean " << Mean << " variance " << Variance << ", uniform mean " << USum/NoSamples
+	     << " range " << UMin << " to " << UMax << endl;
+	Check("normal deviates have mean 0 and variance 1", fabs(Mean) < 0.005 && fabs(Variance-1.) < 0.005);
+	Check("uniform deviates are on (0, 1) with mean 0.5", UMin > 0 && UMax < 1 && fabs(USum/NoSamples-0.5) < 0.002);
+
+	//climates are independent of the order they are made and sampled in
+	GaussianWaveClimate First1(6., 2., 45., 20., 0.8, 0.2);
+	GaussianWaveClimate First2(5., 1., 140., 20., 1.1, 0.2);
+	UAWaveClimate FirstUA(0.6, 0.7, 180., 6., 1., 1., 0.1);
+	vector<Wave> Waves1, Waves2, WavesUA;
+	for (int k=0; k<100; ++k) Waves1.push_back(First1.Get_Wave());
+	for (int k=0; k<100; ++k) WavesUA.push_back(FirstUA.Get_Wave());
+	for (int k=0; k<100; ++k) Waves2.push_back(First2.Get_Wave());
+	UAWaveClimate SecondUA(0.6, 0.7, 180., 6., 1., 1., 0.1);
+	GaussianWaveClimate Second2(5., 1., 140., 20., 1.1, 0.2);
+	GaussianWaveClimate Second1(6., 2., 45., 20., 0.8, 0.2);
+	srand(99);
+	int SameWaves = 1;
+	for (int k=0; k<100; ++k)
+	{
+		if (!SameWave(Second2.Get_Wave(), Waves2[k])) SameWaves = 0;
+		if (!SameWave(Second1.Get_Wave(), Waves1[k])) SameWaves = 0;
+		if (!SameWave(SecondUA.Get_Wave(), WavesUA[k])) SameWaves = 0;
+		rand();
+	}
+	Check("climates give the same waves whatever the order", SameWaves);
+	Check("climates with different parameters give different waves", !SameWave(Waves1[0], Waves2[0]));
+	Second1.SetSeed(2, 9), First1.SetSeed(2, 9);
+	Check("SetSeed restarts the stream", SameWave(Second1.Get_Wave(), First1.Get_Wave()));
+
+	//timing
+	vector<double> Out(NoDeviates);
+	clock_t Start = clock();
+	srand(1);
+	for (int k=0; k<NoDeviates; ++k)
+	{
+		double rand1 = (double)rand()/RAND_MAX, rand2 = (double)rand()/RAND_MAX;
+		Out[k] = sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+	}
+	double RandTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	RandomStream Timed(1, 0);
+	Start = clock();
+	for (int k=0; k<NoDeviates; ++k) Out[k] = Timed.Normal();
+	double NormalTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	Start = clock();
+	Timed.Normals(&Out[0], NoDeviates);
+	double NormalsTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	cout << endl << NoDeviates << " normal deviates: rand() " << RandTime << " s, Normal " << NormalTime
+	     << " s, Normals " << NormalsTime << " s" << endl;
+
+	if (NoFailures > 0)
+	{
+		cout << NoFailures << " checks failed" << endl;
+		exit(EXIT_FAILURE);
+	}
+	return 0;
+}
@@ -0,0 +1,171 @@
+/*==============================================================
+
+real_wave_file_driver.cpp
+
+A driver function to check the streaming real wave climate reader
+against the old whole file read, and to time them.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file real_wave_file_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief checks and times RealWaveClimate streaming from text and binary files
+@details Writes a synthetic hourly hindcast (40 years by default) as a wave
+text file, then reads it the way RealWaveClimate used to, into vectors with
+operator>>, as the reference. Samples one and a half times through the file
+from RealWaveClimate on the text file, one wave at a time and in batches,
+converts the file to binary with RealWaveClimate::WriteBinary and samples
+the binary file, and checks all give the reference waves, starting again
+from the first at the end. Reports the time to open each and to sample all
+the waves. Exits with failure if any sequence differs.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+/// @brief Checks that Climate gives the reference waves, cycling through them, and times it
+/// @return int, 1 if the waves differ
+int Check(const char* Name, RealWaveClimate& Climate, vector<float>& Dir, vector<float>& Period, vector<float>& Height, int BatchSize)
+{
+	int NoWaves = Dir.size(), NoSampled = 3*NoWaves/2;
+	int NoMismatches = 0;
+	double Sum = 0;
+	WaveBatch Batch;
+	clock_t Start = clock();
+	for (int k=0; k<NoSampled; ++k)
+	{
+		Wave TheWave;
+		if (BatchSize == 0) TheWave = Climate.Get_Wave();
+		else
+		{
+			if (Batch.Empty()) Climate.Fill(Batch, BatchSize);
+			TheWave = Batch.Next();
+		}
+		int i = k % NoWaves;
+		if (TheWave.Dir != Dir[i] || TheWave.Period != Period[i] || TheWave.Height != Height[i]) ++NoMismatches;
+		Sum += TheWave.Height;
+	}
+	double SampleTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	if (NoMismatches > 0 || Climate.get_NoWaves() != NoWaves)
+	{
+		cout << "FAIL  " << Name << ": " << NoMismatches << " waves differ, " << Climate.get_NoWaves() << " waves in the file" << endl;
+		return 1;
+	}
+	cout << "pass  " << Name << ": " << NoSampled << " waves sampled in " << SampleTime << " s (check " << Sum << ")" << endl;
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	//number of waves (hourly, 40 years by default) can be given as an argument
+	int NoWaves = 40*8766;
+	if (argc > 1) NoWaves = atoi(argv[1]);
+	string TextFileName = "real_wave_file_test.txt", BinaryFileName = "real_wave_file_test.bin";
+
+	//synthetic hindcast, a seasonal cycle with random storms
+	RandomStream Random(1);
+	ofstream WriteFile(TextFileName.c_str());
+	WriteFile << "Dir Period Height" << endl;
+	char Line[64];
+	for (int k=0; k<NoWaves; ++k)
+	{
+		double Season = sin(2.*M_PI*k/8766.);
+		double Height = fabs(1. + 0.5*Season + 0.4*Random.Normal());
+		double Period = 6. + 2.*Height + 0.5*Random.Normal();
+		double Dir = fmod(360. + 90. + 60.*Season + 30.*Random.Normal(), 360.);
+		snprintf(Line, 64, "%.2f %.3f %.4f\n", Dir, Period, Height);
+		WriteFile << Line;
+	}
+	WriteFile.close();
+
+	//reference, read as RealWaveClimate used to (but without the extra record at the end)
+	clock_t Start = clock();
+	vector<float> Dir, Period, Height;
+	ifstream ReadFile(TextFileName.c_str());
+	string Temp;
+	float D, T, H;
+	ReadFile >> Temp >> Temp >> Temp;
+	while (ReadFile >> D >> T >> H)
+	{
+		Dir.push_back(D);
+		Period.push_back(T);
+		Height.push_back(H);
+	}
+	double ReadTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	cout << endl << NoWaves << " waves, whole file read with operator>> in " << ReadTime << " s" << endl << endl;
+	if ((int)Dir.size() != NoWaves)
+	{
+		cout << "FAIL  reference read " << Dir.size() << " waves" << endl;
+		return EXIT_FAILURE;
+	}
+
+	int NoFailures = 0;
+	Start = clock();
+	RealWaveClimate TextClimate(TextFileName);
+	TextClimate.Get_Wave();
+	double OpenTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	cout << "      text file opened and first wave sampled in " << OpenTime << " s" << endl;
+	TextClimate = RealWaveClimate(TextFileName);
+	NoFailures += Check("text file, Get_Wave", TextClimate, Dir, Period, Height, 0);
+	RealWaveClimate BatchedClimate(TextFileName);
+	NoFailures += Check("text file, batches of 1000", BatchedClimate, Dir, Period, Height, 1000);
+
+	Start = clock();
+	long long NoWritten = RealWaveClimate::WriteBinary(TextFileName, BinaryFileName);
+	double ConvertTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	cout << "      " << NoWritten << " waves converted to binary in " << ConvertTime << " s" << endl;
+	Start = clock();
+	RealWaveClimate BinaryClimate(BinaryFileName);
+	BinaryClimate.Get_Wave();
+	OpenTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	cout << "      binary file opened and first wave sampled in " << OpenTime << " s" << endl;
+	BinaryClimate = RealWaveClimate(BinaryFileName);
+	NoFailures += Check("binary file, Get_Wave", BinaryClimate, Dir, Period, Height, 0);
+	RealWaveClimate BatchedBinaryClimate(BinaryFileName);
+	NoFailures += Check("binary file, batches of 1000", BatchedBinaryClimate, Dir, Period, Height, 1000);
+
+	remove(TextFileName.c_str());
+	remove(BinaryFileName.c_str());
+	cout << endl;
+	return (NoFailures == 0) ? 0 : EXIT_FAILURE;
+}
@@ -149,8 +149,8 @@ int main(int argc, char* argv[])
 	double FluxFraction = 0.0;
 	
 	//initiate random seed
-	//srand (time(NULL));
-	srand(2);
+	//WaveClimate.SetSeed(time(NULL));
+	WaveClimate.SetSeed(2);
 	
 	//loop through time and evolve the coast
 	CoastVector.WriteCoast(WriteCoastFile, Time);
@@ -134,10 +134,6 @@ int main(int argc, char* argv[])
 	int RefDiffFlag = 1;
 	CoastVector.SetRefDiffFlag(RefDiffFlag);
 
-	//initiate random seed
-	//srand (time(NULL));
-	srand(3);
-	
 	//Declare parameter for wave conditions
 	double 	OffshoreMeanWavePeriod, OffshoreStDWavePeriod, OffshoreMeanWaveDirection,
 			OffshoreStDWaveDirection, OffshoreMeanWaveHeight, OffshoreStDWaveHeight;
@@ -155,6 +151,10 @@ int main(int argc, char* argv[])
 		OffshoreStDWavePeriod, OffshoreMeanWaveDirection, OffshoreStDWaveDirection,
 		OffshoreMeanWaveHeight, OffshoreStDWaveHeight);
 
+	//initiate random seed
+	//WaveClimate.SetSeed(time(NULL));
+	WaveClimate.SetSeed(3);
+
 	// declare an individual wave (this will be sampled from the wave climate object
 	Wave MyWave = Wave();
 	
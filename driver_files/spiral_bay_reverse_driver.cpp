@@ -101,10 +101,6 @@ int main()
 	int RefDiffFlag = 1;
 	CoastVector.SetRefDiffFlag(RefDiffFlag);
 
-	//initiate random seed
-	//srand (time(NULL));
-	srand(3);
-	
 	//Declare parameter for wave conditions
 	double OffshoreMeanWavePeriod = 6.;
 	double OffshoreStDWavePeriod = 1.;
@@ -118,6 +114,10 @@ int main()
 		OffshoreStDWavePeriod, OffshoreMeanWaveDirection, OffshoreStDWaveDirection,
 		OffshoreMeanWaveHeight, OffshoreStDWaveHeight);
 
+	//initiate random seed
+	//WaveClimate.SetSeed(time(NULL));
+	WaveClimate.SetSeed(3);
+
 	// declare an individual wave (this will be sampled from the wave climate object
 	Wave MyWave = Wave();
 	
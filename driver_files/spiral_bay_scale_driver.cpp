@@ -147,8 +147,8 @@ int main(int argc, char* argv[])
 	double FluxFraction = 0.0;
 	
 	//initiate random seed
-	//srand (time(NULL));
-	srand(1);
+	//WaveClimate.SetSeed(time(NULL));
+	WaveClimate.SetSeed(1);
 	
 	//loop through time and evolve the coast
 	CoastVector.WriteCoast(WriteCoastFile, Time);
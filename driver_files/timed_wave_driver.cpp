@@ -0,0 +1,212 @@
+/*==============================================================
+
+timed_wave_driver.cpp
+
+A driver function to check sampling a timed real wave climate at
+any time, and to time seeking to the start of a restarted run.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file timed_wave_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief checks and times RealWaveClimate::Get_Wave(Time)
+@details Writes a synthetic hourly hindcast (40 years by default) with a time
+column (days), with directions either side of north, and converts it to
+binary. For the text and binary files checks that Get_Wave(Time) gives each
+record at its time, the linear interpolation between records (direction the
+shorter way round) and the last record with no interpolation, and the same waves
+stepping forward by 0.2 and 0.1 days, in random order and a cycle later.
+Then times a restart four fifths of the way through the series, seeking
+straight to the start time against replaying the records before it. Exits
+with failure if any check fails.
+@date 16/10/2026
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+vector<double> Times;
+vector<float> Dirs, Periods, Heights;
+
+/// @brief 1 if the two waves are within Tolerance
+int Near(Wave A, Wave B, double Tolerance)
+{
+	double Turn = fabs(fmod(A.Dir-B.Dir+540., 360.)-180.);
+	return (Turn <= Tolerance && fabs(A.Period-B.Period) <= Tolerance && fabs(A.Height-B.Height) <= Tolerance) ? 1 : 0;
+}
+
+/// @brief The wave expected at Time, in the first cycle
+Wave Expected(double Time, int Interpolation)
+{
+	int n = Times.size();
+	int i = upper_bound(Times.begin(), Times.end(), Time) - Times.begin() - 1;
+	int j = (i+1) % n;
+	if (Interpolation == 0 || Time == Times[i]) return Wave(Periods[i], Heights[i], Dirs[i]);
+	double NextTime = (j > i) ? Times[j] : Times[n-1] + (Times[n-1]-Times[n-2]);
+	double Fraction = (Time-Times[i])/(NextTime-Times[i]);
+	double Turn = fmod(Dirs[j]-Dirs[i]+540., 360.)-180.;
+	double Direction = fmod(Dirs[i]+Fraction*Turn+360., 360.);
+	return Wave(Periods[i]+Fraction*(Periods[j]-Periods[i]), Heights[i]+Fraction*(Heights[j]-Heights[i]), Direction);
+}
+
+/// @brief Runs the checks on one file
+/// @return int, number of checks failed
+int Check(string Name, string FileName)
+{
+	int NoFailures = 0, NoWaves = Times.size();
+	double Cycle = Times[NoWaves-1]-Times[0] + (Times[NoWaves-1]-Times[NoWaves-2]);
+	RandomStream Random(2);
+
+	//records at their times and interpolated between them, in order and in random order
+	for (int Interpolation=0; Interpolation<2; ++Interpolation)
+	{
+		RealWaveClimate Climate(FileName);
+		Climate.SetInterpolation(Interpolation);
+		int NoMismatches = 0;
+		for (int k=0; k<NoWaves; ++k)
+		{
+			if (!Near(Climate.Get_Wave(Times[k]), Expected(Times[k], Interpolation), 0)) ++NoMismatches;
+			double Between = Times[k] + 0.37*(((k+1 < NoWaves) ? Times[k+1] : Times[k]+Cycle-Times[NoWaves-1]+Times[0]) - Times[k]);
+			if (!Near(Climate.Get_Wave(Between), Expected(Between, Interpolation), 1e-4)) ++NoMismatches;
+		}
+		for (int k=0; k<2000; ++k)
+		{
+			double Time = Times[0] + Random.Uniform()*Cycle;
+			if (!Near(Climate.Get_Wave(Time), Expected(Time, Interpolation), 1e-4)) ++NoMismatches;
+		}
+		if (NoMismatches > 0) ++NoFailures;
+		cout << ((NoMismatches == 0) ? "pass  " : "FAIL  ") << Name << ", " << ((Interpolation == 0) ? "last record" : "linear")
+		     << ": " << NoMismatches << " waves differ from the records" << endl;
+	}
+
+	//stepping at 0.2 and 0.1 days, in random order and a cycle on give the same waves
+	RealWaveClimate Step1(FileName), Step2(FileName), Shuffled(FileName), Later(FileName);
+	int NoSteps = (int)(Cycle/0.2);
+	vector<Wave> Waves(NoSteps);
+	for (int k=0; k<NoSteps; ++k) Waves[k] = Step1.Get_Wave(0.2*k);
+	int NoMismatches[3] = {0, 0, 0};
+	for (int k=0; k<2*NoSteps; ++k)
+	{
+		//halving 0.2*k is exact, so even steps are at exactly the times of the 0.2 day steps
+		Wave TheWave = Step2.Get_Wave(0.2*k/2.);
+		if (k % 2 == 0 && !Near(TheWave, Waves[k/2], 0)) ++NoMismatches[0];
+	}
+	for (int k=0; k<NoSteps; ++k)
+	{
+		int i = (int)(Random.Uniform()*NoSteps);
+		if (!Near(Shuffled.Get_Wave(0.2*i), Waves[i], 0)) ++NoMismatches[1];
+		if (!Near(Later.Get_Wave(0.2*k + 3*Cycle), Waves[k], 1e-6)) ++NoMismatches[2];
+	}
+	const char* StepNames[] = {"steps of 0.1 days", "steps in random order", "steps a cycle on"};
+	for (int n=0; n<3; ++n)
+	{
+		if (NoMismatches[n] > 0) ++NoFailures;
+		cout << ((NoMismatches[n] == 0) ? "pass  " : "FAIL  ") << Name << ", " << StepNames[n] << ": "
+		     << NoMismatches[n] << " waves differ from steps of 0.2 days" << endl;
+	}
+
+	//restart four fifths of the way through, seeking against replaying
+	double StartTime = 0.8*Cycle;
+	clock_t Start = clock();
+	RealWaveClimate Restarted(FileName);
+	Wave Seeked = Restarted.Get_Wave(StartTime);
+	double SeekTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	Start = clock();
+	RealWaveClimate Replayed(FileName);
+	Replayed.SetInterpolation(0);
+	Wave Replay;
+	for (int k=0; Times[k] <= StartTime; ++k) Replay = Replayed.Get_Wave();
+	double ReplayTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	Restarted.SetInterpolation(0);
+	if (!Near(Restarted.Get_Wave(StartTime), Replay, 0)) ++NoFailures;
+	cout << "      " << Name << ", restart at day " << StartTime << ": seek " << SeekTime << " s, replay "
+	     << ReplayTime << " s (height " << Seeked.Height << ")" << endl;
+	return NoFailures;
+}
+
+int main(int argc, char* argv[])
+{
+	//number of hourly waves (40 years by default) can be given as an argument
+	int NoWaves = 40*8766;
+	if (argc > 1) NoWaves = atoi(argv[1]);
+	string TextFileName = "timed_wave_test.txt", BinaryFileName = "timed_wave_test.bin";
+
+	//synthetic hindcast, a seasonal cycle with random storms, directions either side of north
+	RandomStream Random(1);
+	ofstream WriteFile(TextFileName.c_str());
+	WriteFile << "Time Dir Period Height" << endl;
+	char Line[96];
+	for (int k=0; k<NoWaves; ++k)
+	{
+		double Season = sin(2.*M_PI*k/8766.);
+		double Height = fabs(1. + 0.5*Season + 0.4*Random.Normal());
+		double Period = 6. + 2.*Height + 0.5*Random.Normal();
+		double Dir = fmod(360. + 10. + 60.*Season + 30.*Random.Normal(), 360.);
+		snprintf(Line, 96, "%.6f %.2f %.3f %.4f\n", k/24., Dir, Period, Height);
+		WriteFile << Line;
+	}
+	WriteFile.close();
+
+	//the records, read as RealWaveClimate used to read them
+	ifstream ReadFile(TextFileName.c_str());
+	string Temp;
+	double Time;
+	float D, T, H;
+	ReadFile >> Temp >> Temp >> Temp >> Temp;
+	while (ReadFile >> Time >> D >> T >> H)
+	{
+		Times.push_back(Time);
+		Dirs.push_back(D);
+		Periods.push_back(T);
+		Heights.push_back(H);
+	}
+	RealWaveClimate::WriteBinary(TextFileName, BinaryFileName);
+	cout << endl << NoWaves << " hourly waves" << endl << endl;
+
+	int NoFailures = Check("text file", TextFileName) + Check("binary file", BinaryFileName);
+
+	remove(TextFileName.c_str());
+	remove(BinaryFileName.c_str());
+	cout << endl;
+	return (NoFailures == 0) ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+/*==============================================================
+
+wave_batch_driver.cpp
+
+A driver function to check that wave climates give the same waves
+in batches of any size as one at a time, and to time batches.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file wave_batch_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief checks and times WaveClimate::Fill
+@details For Gaussian, UA and bimodal wave climates, samples the same number of
+waves one at a time with Get_Wave, in batches of several sizes with Fill, and
+with the two mixed, and checks that every way gives exactly the same sequence
+of waves. Then times sampling a long sequence of waves each way. Exits with
+failure if any sequence differs.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+/// @brief Samples NoWaves waves in batches of BatchSize, BatchSize 0 = one at a time with Get_Wave
+/// @details A negative BatchSize alternates batches of -BatchSize with single waves.
+vector<Wave> Sample(WaveClimate& Climate, int NoWaves, int BatchSize)
+{
+	vector<Wave> Waves;
+	WaveBatch Batch;
+	int Single = 0;
+	while ((int)Waves.size() < NoWaves)
+	{
+		if (BatchSize == 0 || (BatchSize < 0 && Single == 1))
+		{
+			Waves.push_back(Climate.Get_Wave());
+			Single = 0;
+			continue;
+		}
+		int Size = min(abs(BatchSize), NoWaves-(int)Waves.size());
+		Climate.Fill(Batch, Size);
+		while (!Batch.Empty()) Waves.push_back(Batch.Next());
+		Single = 1;
+	}
+	return Waves;
+}
+
+/// @brief 1 if the two sequences of waves are the same
+int Same(vector<Wave>& A, vector<Wave>& B)
+{
+	if (A.size() != B.size()) return 0;
+	for (int k=0, n=A.size(); k<n; ++k)
+	{
+		if (A[k].Period != B[k].Period || A[k].Height != B[k].Height || A[k].Dir != B[k].Dir) return 0;
+	}
+	return 1;
+}
+
+/// @brief Checks a climate made by Make gives the same waves with every batch size, then times it
+/// @return int, number of batch sizes that give different waves
+template <class Climate> int CheckClimate(const char* Name, Climate (*Make)(), int NoTimedWaves)
+{
+	int NoWaves = 10000;
+	int BatchSizes[] = {1, 2, 3, 7, 64, 1000, 4096, -5, -256};
+	int NoBatchSizes = 9;
+	Climate Reference = Make();
+	vector<Wave> ReferenceWaves = Sample(Reference, NoWaves, 0);
+	int NoMismatches = 0;
+	for (int b=0; b<NoBatchSizes; ++b)
+	{
+		Climate Batched = Make();
+		vector<Wave> Waves = Sample(Batched, NoWaves, BatchSizes[b]);
+		if (!Same(Waves, ReferenceWaves))
+		{
+			cout << "FAIL  " << Name << " batches of " << BatchSizes[b] << " give different waves" << endl;
+			++NoMismatches;
+		}
+	}
+	if (NoMismatches == 0) cout << "pass  " << Name << " gives the same waves with every batch size" << endl;
+
+	//timing, waves summed so the loops aren't optimised away
+	Climate Single = Make(), Batched = Make();
+	double Sum = 0;
+	clock_t Start = clock();
+	for (int k=0; k<NoTimedWaves; ++k) Sum += Single.Get_Wave().Height;
+	double SingleTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	WaveBatch Batch;
+	Start = clock();
+	for (int k=0; k<NoTimedWaves; ++k)
+	{
+		if (Batch.Empty()) Batched.Fill(Batch, 4096);
+		Sum -= Batch.Next().Height;
+	}
+	double BatchTime = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	cout << "      " << NoTimedWaves << " waves: Get_Wave " << SingleTime << " s, batches of 4096 "
+	     << BatchTime << " s (check " << Sum << ")" << endl;
+	return NoMismatches;
+}
+
+GaussianWaveClimate MakeGaussian() { return GaussianWaveClimate(6., 2., 45., 20., 0.8, 0.2); }
+UAWaveClimate MakeUA() { return UAWaveClimate(0.6, 0.7, 180., 6., 1., 1., 0.1); }
+BimodalWaveClimate MakeBimodal() { return BimodalWaveClimate(0.5, 45., 20., 6., 2., 0.8, 0.2, 140., 20., 5., 1., 1.1, 0.2); }
+
+int main(int argc, char* argv[])
+{
+	//number of waves to time can be given as an argument
+	int NoTimedWaves = 10000000;
+	if (argc > 1) NoTimedWaves = atoi(argv[1]);
+
+	int NoMismatches = CheckClimate("Gaussian", MakeGaussian, NoTimedWaves);
+	NoMismatches += CheckClimate("UA", MakeUA, NoTimedWaves);
+	NoMismatches += CheckClimate("bimodal", MakeBimodal, NoTimedWaves);
+
+	if (NoMismatches > 0) exit(EXIT_FAILURE);
+	return 0;
+}
@@ -0,0 +1,183 @@
+/*==============================================================
+
+wave_pipeline_driver.cpp
+
+A driver function to check that waves from a WavePipeline come in
+order to every consumer, and to time an ensemble forced through one.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file wave_pipeline_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief checks and times WavePipeline
+@details Reads a million UA waves through a pipeline with a small ring by
+three consumers on threads of their own, each doing a different amount of
+work per wave, and checks each gets exactly the waves the climate gives one
+at a time. Then times sampling on the consumer's thread against reading from
+a pipeline. Last, evolves an ensemble of straight periodic coasts with
+different node spacings under the same waves, one after another sampling the
+climate themselves, and each on a thread of its own reading from one
+pipeline, and checks the coasts end the same. Exits with failure if any
+check fails. Build with -pthread.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+#include "./../wavepipeline.hpp"
+
+using namespace std;
+
+UAWaveClimate MakeClimate() { return UAWaveClimate(0.6, 0.7, 180., 6., 1., 1., 0.1); }
+
+/// @brief Wall clock time (s), the threads run at once so clock() would add them up
+double WallTime()
+{
+	struct timespec Now;
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return Now.tv_sec + 1e-9*Now.tv_nsec;
+}
+
+/// @brief Reads NoWaves waves for Consumer, working Work units per wave, counting those that differ from Waves
+void Consume(WavePipeline& Pipeline, int Consumer, const vector<Wave>& Waves, int Work, int& NoMismatches)
+{
+	double Sum = 0;
+	for (int k=0, n=Waves.size(); k<n; ++k)
+	{
+		Wave TheWave = Pipeline.Get_Wave(Consumer);
+		if (TheWave.Dir != Waves[k].Dir || TheWave.Height != Waves[k].Height || TheWave.Period != Waves[k].Period) ++NoMismatches;
+		for (int i=0; i<Work; ++i) Sum += sin(i+TheWave.Height);
+	}
+	if (Sum == 1e300) cout << Sum;
+}
+
+/// @brief Straight periodic coast, the same every time
+Coastline MakeCoast(int NodeSpacing) { return Coastline(NodeSpacing, 10000., 180., 1, 1); }
+
+/// @brief Evolves a coast for EndTime days with a new wave every WaveTimeDelta days,
+/// from Pipeline if given, otherwise from its own climate
+void Evolve(Coastline& CoastVector, double EndTime, double WaveTimeDelta, WavePipeline* Pipeline, int Consumer)
+{
+	Cliffline CliffVector;
+	UAWaveClimate Climate = MakeClimate();
+	double TimeStep = 0.1;
+	for (double Time=0; Time<EndTime; Time+=WaveTimeDelta)
+	{
+		Wave TheWave = (Pipeline != NULL) ? Pipeline->Get_Wave(Consumer) : Climate.Get_Wave();
+		for (double Step=0; Step<WaveTimeDelta-1e-9; Step+=TimeStep)
+		{
+			CoastVector.TransportSediment(TimeStep, TheWave, CliffVector);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	//run length for the ensemble (days) can be given as an argument
+	double EndTime = 200.;
+	if (argc > 1) EndTime = atof(argv[1]);
+	int NoFailures = 0;
+
+	//every consumer gets the climate's waves in order, whatever its pace
+	int NoWaves = 1000000, NoConsumers = 3;
+	UAWaveClimate Reference = MakeClimate();
+	vector<Wave> Waves(NoWaves);
+	for (int k=0; k<NoWaves; ++k) Waves[k] = Reference.Get_Wave();
+	{
+		UAWaveClimate Climate = MakeClimate();
+		WavePipeline Pipeline(Climate, NoConsumers, 64, 16);
+		vector<int> NoMismatches(NoConsumers, 0);
+		vector<thread> Consumers;
+		for (int j=0; j<NoConsumers; ++j) Consumers.push_back(thread(Consume, ref(Pipeline), j, cref(Waves), 20*j, ref(NoMismatches[j])));
+		for (int j=0; j<NoConsumers; ++j) Consumers[j].join();
+		for (int j=0; j<NoConsumers; ++j)
+		{
+			if (NoMismatches[j] > 0) ++NoFailures;
+			cout << ((NoMismatches[j] == 0) ? "pass  " : "FAIL  ") << "consumer " << j << " doing " << 20*j << " sines per wave: "
+			     << NoMismatches[j] << " of " << NoWaves << " waves differ, waited " << Pipeline.get_NoConsumerWaits(j) << " times" << endl;
+		}
+		cout << "      ring of " << Pipeline.get_Capacity() << " waves, producer waited " << Pipeline.get_NoProducerWaits() << " times" << endl;
+	}
+
+	//sampling on the consumer's thread against reading from a pipeline
+	{
+		UAWaveClimate Climate = MakeClimate(), PipelineClimate = MakeClimate();
+		double Sum = 0;
+		double Start = WallTime();
+		for (int k=0; k<NoWaves; ++k) Sum += Climate.Get_Wave().Height;
+		double InlineTime = WallTime()-Start;
+		Start = WallTime();
+		WavePipeline Pipeline(PipelineClimate);
+		for (int k=0; k<NoWaves; ++k) Sum -= Pipeline.Get_Wave().Height;
+		double PipelineTime = WallTime()-Start;
+		cout << "      " << NoWaves << " waves: Get_Wave " << InlineTime << " s, from the pipeline " << PipelineTime
+		     << " s (check " << Sum << ")" << endl;
+	}
+
+	//an ensemble under the same waves
+	int NoMembers = 4;
+	int NodeSpacings[] = {100, 80, 60, 50};
+	double WaveTimeDelta = 0.5;
+	vector<Coastline> SerialCoasts, PipelineCoasts;
+	for (int m=0; m<NoMembers; ++m)
+	{
+		SerialCoasts.push_back(MakeCoast(NodeSpacings[m]));
+		PipelineCoasts.push_back(MakeCoast(NodeSpacings[m]));
+	}
+	double Start = WallTime();
+	for (int m=0; m<NoMembers; ++m) Evolve(SerialCoasts[m], EndTime, WaveTimeDelta, NULL, 0);
+	double SerialTime = WallTime()-Start;
+	Start = WallTime();
+	{
+		UAWaveClimate Climate = MakeClimate();
+		WavePipeline Pipeline(Climate, NoMembers);
+		vector<thread> Members;
+		for (int m=0; m<NoMembers; ++m) Members.push_back(thread(Evolve, ref(PipelineCoasts[m]), EndTime, WaveTimeDelta, &Pipeline, m));
+		for (int m=0; m<NoMembers; ++m) Members[m].join();
+	}
+	double PipelineTime = WallTime()-Start;
+	int NoDiffering = 0;
+	for (int m=0; m<NoMembers; ++m) if (SerialCoasts[m].get_X() != PipelineCoasts[m].get_X() || SerialCoasts[m].get_Y() != PipelineCoasts[m].get_Y()) ++NoDiffering;
+	if (NoDiffering > 0) ++NoFailures;
+	cout << ((NoDiffering == 0) ? "pass  " : "FAIL  ") << NoMembers << " coasts, " << EndTime << " days: " << NoDiffering
+	     << " end differently, one after another " << SerialTime << " s, on threads from one pipeline " << PipelineTime << " s" << endl;
+
+	return (NoFailures == 0) ? 0 : EXIT_FAILURE;
+}
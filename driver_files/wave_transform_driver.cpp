@@ -0,0 +1,149 @@
+/*==============================================================
+
+wave_transform_driver.cpp
+
+A driver function to check the breaking wave lookup table and
+Newton solution against the original depth marching solution
+used in Coastline::TransformWaves, and to time all three.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file wave_transform_driver.cpp
+@author Martin D. Hurst, University of Glasgow
+@brief regression check and timing for the breaking wave solutions
+@details Sweeps offshore wave height, period and angle and compares the
+breaking wave height and angle from the lookup table and the Newton solution
+with the marching solution. The marching solution steps 0.05 m in depth, so
+the breaking wave heights are expected to agree to within the change in wave
+height over one step plus the table tolerance. Exits with failure if any
+wave falls outside that.
+@date 16/10/2026
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <time.h>
+
+#include "./../breakingwavetable.hpp"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	//Table tolerance can be given as an argument
+	double Tolerance = 0.001;
+	if (argc > 1) Tolerance = atof(argv[1]);
+
+	double g = 9.81;
+	double H_0, T, Alpha_0, C_0, L_0;
+	double H_March, Alpha_March, H_Table, Alpha_Table, H_Newton, Alpha_Newton;
+	double h_b, H_Step, Alpha_Step, Allowed;
+	double MaxTableError = 0, MaxNewtonError = 0, MaxAngleError = 0;
+	int NoWaves = 0, NoFailures = 0;
+
+	//Build the table
+	clock_t Start = clock();
+	BreakingWaveTable Table;
+	Table.Build(Tolerance);
+	cout << "Built " << Table.get_NoSteepness() << " x " << Table.get_NoAngles() << " table in "
+	     << (double)(clock()-Start)/CLOCKS_PER_SEC << " s, max relative error " << Table.get_MaxError() << endl;
+
+	//Compare with the marching solution
+	for (H_0=0.2; H_0<=6.; H_0+=0.2)
+	{
+		for (T=3.; T<=16.; T+=0.5)
+		{
+			C_0 = (g*T)/(2.0*M_PI);
+			L_0 = C_0*T;
+			for (Alpha_0=-80.; Alpha_0<=80.; Alpha_0+=2.5)
+			{
+				if (Alpha_0 == 0) continue;
+				BreakingWaveTable::MarchBreakingWave(H_0, C_0, L_0, Alpha_0, H_March, Alpha_March);
+				BreakingWaveTable::SolveBreakingWave(H_0, C_0, L_0, Alpha_0, H_Newton, Alpha_Newton);
+				Table.GetBreakingWave(H_0, C_0, L_0, Alpha_0, H_Table, Alpha_Table);
+				if (H_March == 0) continue;
+				++NoWaves;
+
+				//the march stops up to one 0.05 m step below the breaking depth
+				h_b = BreakingWaveTable::SolveBreakingDepth(H_0, C_0, L_0, Alpha_0);
+				BreakingWaveTable::ShoalWave(max(h_b-0.05,0.5*h_b), H_0, C_0, L_0, Alpha_0, H_Step, Alpha_Step);
+				Allowed = 1.01*fabs(H_Step-H_Newton) + Tolerance*H_Newton;
+
+				MaxTableError = max(MaxTableError, fabs(H_Table-H_March)/H_March);
+				MaxNewtonError = max(MaxNewtonError, fabs(H_Newton-H_March)/H_March);
+				MaxAngleError = max(MaxAngleError, fabs(Alpha_Table-Alpha_March));
+				if (fabs(H_Table-H_March) > Allowed || fabs(H_Newton-H_March) > Allowed)
+				{
+					++NoFailures;
+					cout << "H_0 " << H_0 << " T " << T << " Alpha_0 " << Alpha_0 << ": march " << H_March
+					     << " table " << H_Table << " Newton " << H_Newton << endl;
+				}
+			}
+		}
+	}
+	cout << NoWaves << " waves, max relative difference from march: table " << MaxTableError
+	     << ", Newton " << MaxNewtonError << ", max angle difference " << MaxAngleError << " degrees" << endl;
+	cout << Table.get_NoFallbacks() << " table lookups fell back to Newton" << endl;
+
+	//Time each method over a typical stormy wave climate
+	int NoRepeats = 20000;
+	double Sum[3] = {0,0,0};
+	double Time[3];
+	for (int Method=0; Method<3; ++Method)
+	{
+		Start = clock();
+		for (int r=0; r<NoRepeats; ++r)
+		{
+			H_0 = 0.5+(r%50)*0.1;
+			T = 5.+(r%17)*0.5;
+			Alpha_0 = -60.+(r%97)*1.25;
+			C_0 = (g*T)/(2.0*M_PI);
+			L_0 = C_0*T;
+			if (Method == 0) BreakingWaveTable::MarchBreakingWave(H_0, C_0, L_0, Alpha_0, H_March, Alpha_March);
+			else if (Method == 1) Table.GetBreakingWave(H_0, C_0, L_0, Alpha_0, H_March, Alpha_March);
+			else BreakingWaveTable::SolveBreakingWave(H_0, C_0, L_0, Alpha_0, H_March, Alpha_March);
+			Sum[Method] += H_March;
+		}
+		Time[Method] = (double)(clock()-Start)/CLOCKS_PER_SEC;
+	}
+	cout << "Time per wave: march " << 1e6*Time[0]/NoRepeats << " us, table " << 1e6*Time[1]/NoRepeats
+	     << " us, Newton " << 1e6*Time[2]/NoRepeats << " us (" << Sum[0]+Sum[1]+Sum[2] << ")" << endl;
+
+	if (NoFailures > 0)
+	{
+		cout << NoFailures << " waves differ from the marching solution by more than one depth step" << endl;
+		exit(EXIT_FAILURE);
+	}
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*==============================================================
+
+workspace_allocation_driver.cpp
+
+A driver function to check that a steady-state call to
+Coastline::TransportSediment does no heap allocation, by counting
+calls to operator new.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2016, Martin Hurst
+
+Developer can be contacted:
+martin.hurst@glasgow.ac.uk
+
+Martin D. Hurst
+University of Glasgow
+Formerly British Geological Survey
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file workspace_allocation_driver.cpp
+@brief counts heap allocations in Coastline::TransportSediment
+@details Replaces the global operator new with one that counts calls, then
+evolves a straight periodic coast under UA waves with fixed 0.1 day steps.
+After a warm up, in which the workspaces reach their size, every step
+on a coast with no more nodes than it has had before should allocate
+nothing. Steps that take the coast to more nodes than ever, and the step
+after, may grow the workspaces and are reported separately. Exits with failure if any steady-state step allocates.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "./../coastline.hpp"
+#include "./../cliffline.hpp"
+#include "./../waveclimate.hpp"
+
+using namespace std;
+
+//calls to operator new, only counted while Counting is set
+static long NoAllocations = 0;
+static bool Counting = false;
+
+void* operator new(size_t Size)
+{
+	if (Counting) ++NoAllocations;
+	void* Pointer = malloc(Size ? Size : 1);
+	if (!Pointer) throw bad_alloc();
+	return Pointer;
+}
+void* operator new[](size_t Size) { return operator new(Size); }
+void operator delete(void* Pointer) noexcept { free(Pointer); }
+void operator delete[](void* Pointer) noexcept { free(Pointer); }
+void operator delete(void* Pointer, size_t) noexcept { free(Pointer); }
+void operator delete[](void* Pointer, size_t) noexcept { free(Pointer); }
+
+int main(int argc, char* argv[])
+{
+	//node spacing (m), warm up and counted steps can be given as arguments
+	int NodeSpacing = 50;
+	int NoWarmUpSteps = 200;
+	int NoSteps = 1000;
+	if (argc > 1) NodeSpacing = atoi(argv[1]);
+	if (argc > 2) NoWarmUpSteps = atoi(argv[2]);
+	if (argc > 3) NoSteps = atoi(argv[3]);
+
+	Coastline CoastVector(NodeSpacing, 10000., 180., 1, 1);
+	Cliffline CliffVector;
+	CoastVector.SetFluxType(1);
+	UAWaveClimate WaveClimate(0.3, 0.6, 180., 6., 1., 1., 0.1);
+	Wave MyWave = WaveClimate.Get_Wave();
+
+	double WaveTimeDelta = 5., GetWaveTime = WaveTimeDelta, Time = 0;
+	long SteadyAllocations = 0, ResizeAllocations = 0;
+	int NoSteadySteps = 0, NoResizeSteps = 0, NoBadSteps = 0;
+	int LargestNoNodes = CoastVector.get_NoNodes();
+	for (int Step=0; Step<NoWarmUpSteps+NoSteps; ++Step)
+	{
+		if (Time >= GetWaveTime)
+		{
+			MyWave = WaveClimate.Get_Wave();
+			GetWaveTime += WaveTimeDelta;
+		}
+
+		int NoNodesBefore = CoastVector.get_NoNodes();
+		double TimeStep = 0.1;
+		NoAllocations = 0;
+		Counting = (Step >= NoWarmUpSteps);
+		CoastVector.TransportSediment(TimeStep, MyWave, CliffVector);
+		Counting = false;
+		Time += TimeStep;
+
+		//workspaces sized for the nodes at the start of a step only grow during
+		//the step if nodes are added, or during the next
+		int NoNodesAfter = CoastVector.get_NoNodes();
+		int Grew = (NoNodesBefore > LargestNoNodes || NoNodesAfter > LargestNoNodes);
+		LargestNoNodes = max(LargestNoNodes, NoNodesBefore);
+		if (Step < NoWarmUpSteps) continue;
+
+		if (Grew == 0)
+		{
+			++NoSteadySteps;
+			SteadyAllocations += NoAllocations;
+			if (NoAllocations > 0) ++NoBadSteps;
+		}
+		else
+		{
+			++NoResizeSteps;
+			ResizeAllocations += NoAllocations;
+		}
+	}
+
+	cout << NoSteadySteps << " steady-state steps: " << SteadyAllocations << " allocations in " << NoBadSteps << " steps" << endl;
+	cout << NoResizeSteps << " steps on more nodes than before: " << ResizeAllocations << " allocations" << endl;
+	cout << CoastVector.get_NoNodes() << " nodes after " << Time << " days" << endl;
+
+	if (NoBadSteps > 0)
+	{
+		cout << "Steady-state steps allocated on the heap" << endl;
+		exit(EXIT_FAILURE);
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*==============================================================
+
+ghostlayers.hpp
+
+Pads a per-node array with ghost nodes beyond each end, so that
+loops over the nodes can read their neighbours without boundary
+branches.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file ghostlayers.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief ghost node layers for the ends of the coast
+@details A GhostColumn holds a copy of a per-node array with NoGhosts extra
+nodes before node 0 and after node N-1, so that element i-1 or i+1 of any
+node can be read without checking for the ends of the coast. It is refreshed
+once per stage, after the array is up to date, in one of three ways.
+GhostWrap is for periodic coasts, where node N-1 repeats node 0: the nodes
+before node 0 are nodes N-2, N-3, ... and those after node N-1 are nodes 1,
+2, ..., shifted by Shift for each time round the coast (the offset from the
+start of the coast to the end, for coordinates). GhostClamp repeats the end
+nodes and GhostExtrapolate continues the line through the two end nodes.
+@date 16/10/2026
+*/
+
+#ifndef ghostlayers_HPP
+#define ghostlayers_HPP
+
+#include <vector>
+
+using namespace std;
+
+/// @brief How ghost nodes are filled
+enum GhostMode { GhostWrap = 1, GhostClamp = 2, GhostExtrapolate = 3 };
+
+/// @brief A per-node array padded with ghost nodes at each end.
+/// @details Element i is valid for -NoGhosts <= i < N+NoGhosts. Storage is kept between refreshes.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+template <class T> class GhostColumn
+{
+	public:
+
+	GhostColumn() : N(0), NoGhosts(0) {}
+
+	/// @brief Copies the nodes and fills the ghosts
+	/// @param Data const T*, the N nodes
+	/// @param NewN int, number of nodes
+	/// @param NewNoGhosts int, number of ghost nodes at each end
+	/// @param Mode int, GhostWrap, GhostClamp or GhostExtrapolate
+	/// @param Shift T, added for each time round a periodic coast (GhostWrap only)
+	void Refresh(const T* Data, int NewN, int NewNoGhosts, int Mode, T Shift = T())
+	{
+		Resize(NewN, NewNoGhosts);
+		for (int i=0; i<N; ++i) Padded[NoGhosts+i] = Data[i];
+		FillGhosts(Mode, Shift);
+	}
+
+	/// @brief Fills the nodes with their own indices and the ghosts with the nodes they stand for
+	/// @details With GhostWrap element i-1 and i+1 are then the neighbours of node i round a periodic coast.
+	/// @param NewN int, number of nodes
+	/// @param NewNoGhosts int, number of ghost nodes at each end
+	/// @param Mode int, GhostWrap or GhostClamp
+	void RefreshIndices(int NewN, int NewNoGhosts, int Mode)
+	{
+		Resize(NewN, NewNoGhosts);
+		for (int i=0; i<N; ++i) Padded[NoGhosts+i] = i;
+		FillGhosts(Mode, T());
+	}
+
+	T& operator[](int i) { return Padded[NoGhosts+i]; }
+	const T& operator[](int i) const { return Padded[NoGhosts+i]; }
+
+	/// @brief Pointer to node 0, valid from -NoGhosts
+	const T* data() const { return &Padded[NoGhosts]; }
+
+	/// @brief Pointer to the first ghost node, i.e. node -NoGhosts
+	const T* begin_padded() const { return &Padded[0]; }
+
+	/// @brief Number of nodes, not counting ghosts
+	int size() const { return N; }
+
+	/// @brief Number of ghost nodes at each end
+	int get_NoGhosts() const { return NoGhosts; }
+
+	private:
+
+	int N;
+	int NoGhosts;
+	vector<T> Padded;
+
+	void Resize(int NewN, int NewNoGhosts)
+	{
+		N = NewN;
+		NoGhosts = NewNoGhosts;
+		Padded.resize(N+2*NoGhosts);
+	}
+
+	/// @brief Fills the ghosts from the nodes
+	void FillGhosts(int Mode, T Shift)
+	{
+		if (N == 0) return;
+		const T* Data = &Padded[NoGhosts];
+		for (int k=1; k<=NoGhosts; ++k)
+		{
+			T& Before = Padded[NoGhosts-k];
+			T& After = Padded[NoGhosts+N-1+k];
+			if (Mode == GhostWrap && N > 1)
+			{
+				//node N-1 is node 0, so the period is N-1 nodes
+				int Index = N-1-k, Laps = 1;
+				while (Index < 0) Index += N-1, ++Laps;
+				Before = Data[Index] - Laps*Shift;
+				Index = k, Laps = 1;
+				while (Index > N-1) Index -= N-1, ++Laps;
+				After = Data[Index] + Laps*Shift;
+			}
+			else if (Mode == GhostExtrapolate && N > 1)
+			{
+				Before = Data[0] - k*(Data[1]-Data[0]);
+				After = Data[N-1] + k*(Data[N-1]-Data[N-2]);
+			}
+			else
+			{
+				Before = Data[0];
+				After = Data[N-1];
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,531 @@
+/*==============================================================
+
+nodestore.hpp
+
+Per-node storage for the coastline object
+Every property the coastline holds for each of its nodes is
+kept here as a contiguous, aligned column so that nodes can be
+added and removed from all of them at once.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file nodestore.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief structure-of-arrays storage for coastline nodes
+@details This file contains the NodeColumn container and the NodeStore
+that the coastline object is built on. Each per-node field of the
+coastline is a NodeColumn, a contiguous buffer aligned to 64 bytes, and
+the NodeStore inserts and erases nodes across all of them together so
+the fields can never drift out of step with one another.
+@date 16/10/2026
+*/
+
+#ifndef nodestore_HPP
+#define nodestore_HPP
+
+#include <cstdlib>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/// @brief Contiguous, 64-byte aligned storage for a single per-node field.
+/// @details Behaves like a cut-down vector for plain data types (double, int).
+/// Capacity only grows, and then geometrically, so resetting or resizing a
+/// column to a similar number of nodes every timestep does not reallocate.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+template <class T> class NodeColumn
+{
+	public:
+
+	NodeColumn() : Memory(0), Data(0), Size(0), Capacity(0) {}
+	NodeColumn(const NodeColumn& Other) : Memory(0), Data(0), Size(0), Capacity(0) { *this = Other; }
+	~NodeColumn() { delete [] Memory; }
+
+	NodeColumn& operator=(const NodeColumn& Other)
+	{
+		if (this == &Other) return *this;
+		if (Capacity < Other.Size) Allocate(Other.Size);
+		copy(Other.Data, Other.Data+Other.Size, Data);
+		Size = Other.Size;
+		return *this;
+	}
+
+	T& operator[](int i) { return Data[i]; }
+	const T& operator[](int i) const { return Data[i]; }
+
+	T* begin() { return Data; }
+	T* end() { return Data+Size; }
+	const T* begin() const { return Data; }
+	const T* end() const { return Data+Size; }
+	T* data() { return Data; }
+	const T* data() const { return Data; }
+
+	size_t size() const { return Size; }
+	size_t capacity() const { return Capacity; }
+	bool empty() const { return Size == 0; }
+
+	/// @brief Makes sure there is room for at least n elements, growing geometrically
+	void reserve(size_t n)
+	{
+		if (n <= Capacity) return;
+		Allocate(max(n, 2*Capacity));
+	}
+
+	void resize(size_t n, T Value)
+	{
+		reserve(n);
+		if (n > Size) fill(Data+Size, Data+n, Value);
+		Size = n;
+	}
+
+	void assign(size_t n, T Value)
+	{
+		reserve(n);
+		fill(Data, Data+n, Value);
+		Size = n;
+	}
+
+	void push_back(T Value)
+	{
+		reserve(Size+1);
+		Data[Size++] = Value;
+	}
+
+	void clear() { Size = 0; }
+
+	/// @brief Exchanges contents with Other without copying
+	void swap(NodeColumn& Other)
+	{
+		std::swap(Memory, Other.Memory), std::swap(Data, Other.Data);
+		std::swap(Size, Other.Size), std::swap(Capacity, Other.Capacity);
+	}
+
+	/// @brief Opens a gap of Count elements at i, filled with Value
+	void insert(int i, int Count, T Value)
+	{
+		reserve(Size+Count);
+		copy_backward(Data+i, Data+Size, Data+Size+Count);
+		fill(Data+i, Data+i+Count, Value);
+		Size += Count;
+	}
+
+	/// @brief Removes the elements [First, Last)
+	void erase(int First, int Last)
+	{
+		copy(Data+Last, Data+Size, Data+First);
+		Size -= Last-First;
+	}
+
+	private:
+
+	static const size_t Alignment = 64;
+
+	//Moves the contents to a new aligned buffer of the given capacity
+	void Allocate(size_t NewCapacity)
+	{
+		char* NewMemory = new char[NewCapacity*sizeof(T) + Alignment];
+		size_t Offset = Alignment - ((size_t)NewMemory % Alignment);
+		T* NewData = (T*)(NewMemory + Offset);
+		if (Size > 0) copy(Data, Data+Size, NewData);
+		delete [] Memory;
+		Memory = NewMemory;
+		Data = NewData;
+		Capacity = NewCapacity;
+	}
+
+	char* Memory; //Raw allocation, Data points at the first aligned address within it
+	T* Data;
+	size_t Size;
+	size_t Capacity;
+};
+
+/// @brief Per-cell lists (e.g. cell vertices, recievers) stored in one flat buffer.
+/// @details Every cell owns a slot in a single payload buffer. Slots are handed
+/// out by bumping a pointer, so filling the lists during a mesh build does not
+/// allocate once the buffer has grown to size, and Reset empties every cell
+/// in one go at the start of the next build. Each slot has free space at both
+/// ends so items can be added to the front (push_front) as well as the back of
+/// a cell; a cell that outgrows its slot is moved to a bigger one at the end of
+/// the buffer. Compact lays the cells out back to back in cell order (a
+/// compressed sparse row layout: cell i is [Begin[i], End[i]) and End[i] is
+/// Begin[i+1]) so loops over all cells read the payload in a single sweep.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+template <class T> class CellArena
+{
+	public:
+
+	/// @brief Handle to the list of a single cell, used like a small vector.
+	/// @details Handles refer to the arena by index, so they stay valid when
+	/// the payload buffer grows, but pointers from begin() and end() do not.
+	class Cell
+	{
+		public:
+		Cell(CellArena* TheArena, int Index) : Arena(TheArena), i(Index) {}
+
+		int size() const { return Arena->End[i]-Arena->Begin[i]; }
+		bool empty() const { return Arena->End[i] == Arena->Begin[i]; }
+		T& operator[](int j) const { return Arena->Payload[Arena->Begin[i]+j]; }
+		T* begin() const { return Arena->Payload.data()+Arena->Begin[i]; }
+		T* end() const { return Arena->Payload.data()+Arena->End[i]; }
+
+		void clear() const { Arena->Clear(i); }
+		void push_back(const T& Item) const { Arena->PushBack(i, Item); }
+		void push_front(const T& Item) const { Arena->PushFront(i, Item); }
+
+		private:
+		Cell& operator=(const Cell&); //cells are copied with CellArena::CopyCell
+		CellArena* Arena;
+		int i;
+	};
+
+	CellArena() : Top(0) {}
+
+	Cell operator[](int i) { return Cell(this, i); }
+	int size() const { return Begin.size(); }
+
+	/// @brief Empties every cell and frees all slots, n cells are kept
+	void Reset(int n)
+	{
+		Begin.assign(n, 0), End.assign(n, 0), SlotStart.assign(n, 0), SlotEnd.assign(n, 0);
+		Top = 0;
+	}
+
+	/// @brief Sets the number of cells, new cells are empty
+	void resize(int n)
+	{
+		Begin.resize(n, 0), End.resize(n, 0), SlotStart.resize(n, 0), SlotEnd.resize(n, 0);
+	}
+
+	/// @brief Adds Count empty cells before cell i
+	void InsertCells(int i, int Count)
+	{
+		Begin.insert(Begin.begin()+i, Count, 0), End.insert(End.begin()+i, Count, 0);
+		SlotStart.insert(SlotStart.begin()+i, Count, 0), SlotEnd.insert(SlotEnd.begin()+i, Count, 0);
+	}
+
+	/// @brief Removes the cells [First, Last), their slots are reclaimed at the next Reset
+	void EraseCells(int First, int Last)
+	{
+		Begin.erase(Begin.begin()+First, Begin.begin()+Last), End.erase(End.begin()+First, End.begin()+Last);
+		SlotStart.erase(SlotStart.begin()+First, SlotStart.begin()+Last), SlotEnd.erase(SlotEnd.begin()+First, SlotEnd.begin()+Last);
+	}
+
+	/// @brief Replaces the list of cell To with a copy of the list of cell From
+	void CopyCell(int To, int From)
+	{
+		if (To == From) return;
+		Clear(To);
+		for (int j=Begin[From]; j<End[From]; ++j) PushBack(To, Payload[j]);
+	}
+
+	/// @brief Replaces the list of cell To with a copy of the list of cell From of another arena
+	void CopyCell(int To, const CellArena& Other, int From)
+	{
+		Clear(To);
+		for (int j=Other.Begin[From]; j<Other.End[From]; ++j) PushBack(To, Other.Payload[j]);
+	}
+
+	/// @brief Exchanges contents with Other without copying
+	void swap(CellArena& Other)
+	{
+		Payload.swap(Other.Payload), Spare.swap(Other.Spare);
+		Begin.swap(Other.Begin), End.swap(Other.End);
+		SlotStart.swap(Other.SlotStart), SlotEnd.swap(Other.SlotEnd);
+		std::swap(Top, Other.Top);
+	}
+
+	/// @brief Packs the cells back to back in cell order with no free space
+	void Compact()
+	{
+		int n = Begin.size();
+		if ((int)Spare.size() < Top) Spare.resize(Payload.size());
+		int Next = 0;
+		for (int i=0; i<n; ++i)
+		{
+			int Size = End[i]-Begin[i];
+			copy(Payload.begin()+Begin[i], Payload.begin()+End[i], Spare.begin()+Next);
+			Begin[i] = SlotStart[i] = Next;
+			Next += Size;
+			End[i] = SlotEnd[i] = Next;
+		}
+		Payload.swap(Spare);
+		Top = Next;
+	}
+
+	private:
+
+	enum
+	{
+		SlotSize = 8, //Size of the first slot given to a cell
+		FrontRoom = 2 //Free space kept at the front of a new slot for push_front
+	};
+
+	void Clear(int i)
+	{
+		int Room = min((int)FrontRoom, SlotEnd[i]-SlotStart[i]);
+		Begin[i] = End[i] = SlotStart[i]+Room;
+	}
+
+	void PushBack(int i, const T& Item)
+	{
+		if (End[i] == SlotEnd[i]) Grow(i);
+		Payload[End[i]++] = Item;
+	}
+
+	void PushFront(int i, const T& Item)
+	{
+		if (Begin[i] == SlotStart[i]) Grow(i);
+		Payload[--Begin[i]] = Item;
+	}
+
+	//Moves cell i to a new slot at least twice the size of its current one
+	void Grow(int i)
+	{
+		int Size = End[i]-Begin[i];
+		int NewSlotSize = max((int)SlotSize, 2*(SlotEnd[i]-SlotStart[i]));
+		int Room = max((int)FrontRoom, (NewSlotSize-Size)/4);
+		int Start = Top;
+		Top += NewSlotSize;
+		if ((int)Payload.size() < Top)
+		{
+			//Compact needs as much room again, so grow that now rather than later
+			Payload.resize(max(Top, 2*(int)Payload.size()));
+			Spare.resize(Payload.size());
+		}
+		copy(Payload.begin()+Begin[i], Payload.begin()+End[i], Payload.begin()+Start+Room);
+		SlotStart[i] = Start;
+		SlotEnd[i] = Start+NewSlotSize;
+		Begin[i] = Start+Room;
+		End[i] = Begin[i]+Size;
+	}
+
+	vector<T> Payload; //Items of every cell
+	vector<T> Spare; //Second buffer used by Compact
+	vector<int> Begin, End; //Items of cell i are Payload[Begin[i]] to Payload[End[i]-1]
+	vector<int> SlotStart, SlotEnd; //Space in Payload owned by cell i
+	int Top; //First unused item in Payload
+};
+
+class NodeView;
+
+/// @brief Structure-of-arrays store of every per-node field of a coastline.
+/// @details The coastline object inherits its per-node data from here. All
+/// of the columns always hold NoNodes values, and nodes are added or removed
+/// with InsertNodes and EraseNodes, which shift every column (including the
+/// per-cell vertex and reciever lists) together. Values in newly inserted
+/// nodes are set to the no data value -9999 (0 for Fixed and SedimentSupply,
+/// -1 for MeshConvex, empty lists for the mesh) until the caller assigns them or
+/// the morphology is recalculated. TopologyVersion changes whenever nodes are
+/// added or removed, so cached per-node results (e.g. the shoreface mesh) can
+/// tell whether their node indices still hold.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class NodeStore
+{
+	friend class NodeView;
+
+	public:
+
+	//Use priority queue to deal with triangle nodes in order of increasing shoreface depth?
+	struct CoastNode
+	{
+		double ShorefaceDepth;
+		int i;
+	};
+
+	//Structure to handle single nodes
+	struct Node
+	{
+		double X, Y;
+	};
+
+	int NoNodes; //Number of nodes along coastline
+	NodeColumn<double> X; //position in x (m)
+	NodeColumn<double> Y; //position in y (m)
+	NodeColumn<double> Distance; //Distance along the vector
+	NodeColumn<double> Orientation; //orientation/azimuth of shoreline across i-1, i+1
+	NodeColumn<double> FluxOrientation; //shoreline orientation bewteen i, i+1
+	NodeColumn<double> LeftOrientation; //orientation for meshing left boundary
+	NodeColumn<double> RightOrientation; //orientation for meshing right boundary
+	NodeColumn<double> CellWidth; //Width of individual cells parallel to orientation
+	NodeColumn<double> BreakingWaveHeight; //Heights of breaking waves
+	NodeColumn<double> BreakingWaveAngle; //Angle of breaking waves
+	NodeColumn<double> Shadows; //Shadow Zone Vector
+	NodeColumn<double> ShadowZoneWaveDirection; //Wave direction modified for ref/diff in shadow zone
+	NodeColumn<double> ShadowZoneWaveHeight; //Wave height modified for ref/diff in shadow zone
+	NodeColumn<double> MinVolumeChange; //Maximium possible negative volume change based on beach width
+	NodeColumn<double> LongshoreFlux; //Volume of sediment transported alongshore (in m3)
+	NodeColumn<double> VolumeChange; //Volume change in each cell during a particular timestep (m3)
+	NodeColumn<double> VolumeOut; //Volume leaving (m3)
+	NodeColumn<double> VolumeIn; //Volume entering (m3)
+	NodeColumn<double> PositionChange; //Magnitude of change in shoreline position (m)
+	NodeColumn<double> BeachWidth; //Width of beach to nearest cliff segment (m)
+	NodeColumn<double> Volume; //Total volume of sediment available for transport (m3)
+	NodeColumn<double> Area; //Surface area of shoreface cell (m2)
+	NodeColumn<double> e1; //angle of upcoast cell boundary to cell orientation normal (o)
+	NodeColumn<double> e2; //angle of downcoast cell boundary to cell orientation normal (o)
+	NodeColumn<double> X0; //X position of cell boundary tip
+	NodeColumn<double> Y0; //Y position of cell boundary tip
+	NodeColumn<double> XL; //X position of cell boundary left edge
+	NodeColumn<double> YL; //Y position of cell boundary left edge
+	NodeColumn<double> XR; //X position of cell boundary right edge
+	NodeColumn<double> YR; //Y position of cell boundary right edge
+	NodeColumn<double> Dsf; //Shoreface Depth at cell bottom
+	NodeColumn<double> Alpha_0; //Angle of offshore wave
+	NodeColumn<double> SedimentSupply; //Volume supplied from outside (e.g. cliff erosion) waiting to be added (m3)
+	NodeColumn<double> MeshX; //X position of the node when the shoreface cells were last built
+	NodeColumn<double> MeshY; //Y position of the node when the shoreface cells were last built
+	NodeColumn<double> ShadowX; //X position of the node when the shadows were last found
+	NodeColumn<double> ShadowY; //Y position of the node when the shadows were last found
+	NodeColumn<double> WaveCacheH_0; //Wave height approaching the node when its breaking wave was last found
+	NodeColumn<double> WaveCacheAlpha_0; //Wave angle approaching the node when its breaking wave was last found
+	NodeColumn<double> WaveCacheHeight; //Breaking wave height last found for the node
+	NodeColumn<double> WaveCacheAngle; //Breaking wave angle last found for the node
+	NodeColumn<int> Fixed; //Is coastline fixed? 1 = yes, 0 = np
+	NodeColumn<int> MeshConvex; //Signs of e1 and e2 when the shoreface cells were last built
+
+	CellArena<CoastNode> Recievers; //Cells recieving sediment from each cell
+	CellArena<Node> Vertices; //Vertices of each shoreface cell
+
+	int TopologyVersion; //Incremented every time nodes are added or removed
+
+	NodeStore() : NoNodes(0), TopologyVersion(0) {}
+
+	/// @brief Sets every column to hold n nodes
+	/// @details Existing values are kept, new nodes get the no data value.
+	/// Used once X and Y have been read to size the remaining columns.
+	void ResizeNodes(int n)
+	{
+		NoNodes = n;
+		++TopologyVersion;
+		NodeColumn<double>* Columns[NoDoubleColumns];
+		GetDoubleColumns(Columns);
+		for (int c=0; c<NoDoubleColumns; ++c) Columns[c]->resize(n, -9999);
+		SedimentSupply.resize(n, 0);
+		Fixed.resize(n, 0);
+		MeshConvex.resize(n, -1);
+		Recievers.resize(n);
+		Vertices.resize(n);
+	}
+
+	/// @brief Inserts Count new nodes before node i in every column
+	void InsertNodes(int i, int Count)
+	{
+		NodeColumn<double>* Columns[NoDoubleColumns];
+		GetDoubleColumns(Columns);
+		for (int c=0; c<NoDoubleColumns; ++c) Columns[c]->insert(i, Count, -9999);
+		SedimentSupply.insert(i, Count, 0);
+		Fixed.insert(i, Count, 0);
+		MeshConvex.insert(i, Count, -1);
+		Recievers.InsertCells(i, Count);
+		Vertices.InsertCells(i, Count);
+		NoNodes += Count;
+		++TopologyVersion;
+	}
+
+	/// @brief Removes the nodes [First, Last) from every column
+	/// @details Any sediment supply still waiting in the removed nodes is
+	/// passed to the node before them so that it is not lost.
+	void EraseNodes(int First, int Last)
+	{
+		if (First > 0) for (int i=First; i<Last; ++i) SedimentSupply[First-1] += SedimentSupply[i];
+		NodeColumn<double>* Columns[NoDoubleColumns];
+		GetDoubleColumns(Columns);
+		for (int c=0; c<NoDoubleColumns; ++c) Columns[c]->erase(First, Last);
+		SedimentSupply.erase(First, Last);
+		Fixed.erase(First, Last);
+		MeshConvex.erase(First, Last);
+		Recievers.EraseCells(First, Last);
+		Vertices.EraseCells(First, Last);
+		NoNodes -= Last-First;
+		++TopologyVersion;
+	}
+
+	/// @brief Returns a view of node i
+	NodeView GetNode(int i);
+
+	private:
+
+	static const int NoDoubleColumns = 40;
+
+	//Lists every double column so that bulk operations touch all of them
+	void GetDoubleColumns(NodeColumn<double>** Columns)
+	{
+		NodeColumn<double>* List[NoDoubleColumns] =
+		{
+			&X, &Y, &Distance, &Orientation, &FluxOrientation, &LeftOrientation, &RightOrientation,
+			&CellWidth, &BreakingWaveHeight, &BreakingWaveAngle, &Shadows, &ShadowZoneWaveDirection,
+			&ShadowZoneWaveHeight, &MinVolumeChange, &LongshoreFlux, &VolumeChange, &VolumeOut, &VolumeIn,
+			&PositionChange, &BeachWidth, &Volume, &Area, &e1, &e2, &X0, &Y0, &XL, &YL, &XR, &YR, &Dsf, &Alpha_0,
+			&MeshX, &MeshY, &ShadowX, &ShadowY, &WaveCacheH_0, &WaveCacheAlpha_0, &WaveCacheHeight, &WaveCacheAngle
+		};
+		copy(List, List+NoDoubleColumns, Columns);
+	}
+};
+
+/// @brief Access to all the fields of a single node in a NodeStore.
+/// @details A lightweight handle (store and index) for code that works on
+/// one node at a time, e.g. when setting up a newly inserted node.
+/// Any field can be reached with View[&NodeStore::Field].
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class NodeView
+{
+	public:
+
+	NodeView(NodeStore& TheStore, int Index) : Store(&TheStore), i(Index) {}
+
+	int Index() const { return i; }
+	double& X() const { return Store->X[i]; }
+	double& Y() const { return Store->Y[i]; }
+	int& Fixed() const { return Store->Fixed[i]; }
+
+	template <class T> T& operator[](NodeColumn<T> NodeStore::*Field) const { return (Store->*Field)[i]; }
+
+	private:
+
+	NodeStore* Store;
+	int i;
+};
+
+inline NodeView NodeStore::GetNode(int i) { return NodeView(*this, i); }
+
+#endif
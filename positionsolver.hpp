@@ -0,0 +1,263 @@
+/*==============================================================
+
+positionsolver.hpp
+
+Solves for the change in position of every coastal node from
+its change in volume, in one pass over the coast.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file positionsolver.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief batch solution of the shoreface cell volume equations
+@details Cells that don't reach closure depth are triangular prisms, so the
+volume change is a cubic in the position change (Coastline::SolveCubic).
+Cells that do are a quadratic (Coastline::SolveQuadratic). Everything in
+those equations except the volume change is fixed by the cell geometry, so
+it is worked out once when the cells change, and each solution (there may be
+several per timestep if the timestep has to be reduced) only has the terms
+with the volume change left to do.
+@date 16/10/2026
+*/
+
+#ifndef positionsolver_HPP
+#define positionsolver_HPP
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/// @brief Solves the cubic and quadratic cell volume equations for every node.
+/// @details Setup sorts the nodes into lists of cubic, quadratic, linear
+/// (degenerate) and fixed cells and stores their geometric coefficients in
+/// separate arrays. Solve then runs down each list without testing the cell
+/// type, and CheckChanges finds the nodes that moved too far in one pass.
+/// The arithmetic is that of Coastline::SolveCubic and SolveQuadratic, in the
+/// same order, so the results are identical to solving node by node.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class PositionSolver
+{
+	public:
+
+	PositionSolver() : NoNodes(0), NoBadNodes(0), NoNaN(0), LargestChange(0) {}
+
+	/// @brief Works out the geometric part of every node's equation
+	/// @param N int, number of nodes
+	/// @param e1, e2 const double*, angles of the cell boundaries (degrees)
+	/// @param CellWidth, Area, Dsf const double*, cell width (m), area (m2) and shoreface depth (m)
+	/// @param Fixed const int*, 1 if the node can't move
+	void Setup(int N, const double* e1, const double* e2, const double* CellWidth, const double* Area,
+			const double* Dsf, const int* Fixed, double ClosureDepth, double ShorefaceSlope)
+	{
+		NoNodes = N;
+		Slope = ShorefaceSlope;
+		Depth = ClosureDepth;
+		SumTanE.resize(N);
+		A.resize(N), A1.resize(N), B1.resize(N), Q.resize(N), Q3.resize(N), R0.resize(N);
+		AOver3.resize(N), Min2RootQ.resize(N), Upcoast.resize(N);
+		QuadraticB.resize(N), QuadraticBB.resize(N), Quadratic4A.resize(N), Quadratic2A.resize(N), LinearScale.resize(N);
+		CubicNodes.clear(), QuadraticNodes.clear(), LinearNodes.clear();
+		CubicNodes.reserve(N), QuadraticNodes.reserve(N), LinearNodes.reserve(N); //any could hold every node
+
+		double epsilon = 0.00001;
+		for (int i=0; i<N; ++i)
+		{
+			SumTanE[i] = tan((M_PI/180.)*e1[i]) + tan((M_PI/180.)*e2[i]);
+			LinearScale[i] = CellWidth[i]*ClosureDepth;
+			if (Fixed[i] == 1) continue;
+			else if (Dsf[i] < ClosureDepth)
+			{
+				//cubic, see Coastline::SolveCubic, only d depends on the volume change
+				double a = -(1./6.)*SumTanE[i];
+				double b = -CellWidth[i]/2.;
+				double c = Area[i];
+				if (fabs(a) < epsilon)
+				{
+					LinearNodes.push_back(i);
+					continue;
+				}
+				A[i] = a;
+				A1[i] = b/a;
+				B1[i] = c/a;
+				Q[i] = (A1[i]*A1[i] - 3.*B1[i]) / 9.;
+				R0[i] = 2*A1[i]*A1[i]*A1[i] - 9.*A1[i]*B1[i];
+				Q3[i] = Q[i]*Q[i]*Q[i];
+				AOver3[i] = A1[i]/3.;
+				Min2RootQ[i] = -2.*sqrt(Q[i]);
+				Upcoast[i] = (e1[i] < 0) ? 1 : 0;
+				CubicNodes.push_back(i);
+			}
+			else
+			{
+				//quadratic, see Coastline::SolveQuadratic, only c depends on the volume change
+				double a = SumTanE[i];
+				if (a == 0)
+				{
+					LinearNodes.push_back(i);
+					continue;
+				}
+				QuadraticB[i] = 2.*CellWidth[i] + (ClosureDepth/ShorefaceSlope)*SumTanE[i];
+				QuadraticBB[i] = QuadraticB[i]*QuadraticB[i];
+				Quadratic4A[i] = 4.*a;
+				Quadratic2A[i] = 2.*a;
+				QuadraticNodes.push_back(i);
+			}
+		}
+	}
+
+	/// @brief Position change of every node for the given volume changes
+	/// @details Fixed nodes keep their position change, or 0 if the volume change
+	/// is tiny. Changes should then be checked with CheckChanges.
+	/// @param VolumeChange const double*, per node (m3)
+	/// @param PositionChange double*, returned position changes (m)
+	/// @param NoThreads int, OpenMP threads to use
+	void Solve(const double* VolumeChange, double* PositionChange, int NoThreads)
+	{
+		int NoCubic = CubicNodes.size(), NoQuadratic = QuadraticNodes.size(), NoLinear = LinearNodes.size();
+
+		//neglect tiny tiny changes, can't recall the reason for this, perhaps solution errors?
+		for (int i=0; i<NoNodes; ++i) if (fabs(VolumeChange[i]) < 0.001) PositionChange[i] = 0;
+
+#ifdef _OPENMP
+		#pragma omp parallel num_threads(NoThreads)
+#endif
+		{
+#ifdef _OPENMP
+			#pragma omp for schedule(static) nowait
+#endif
+			for (int k=0; k<NoCubic; ++k)
+			{
+				int i = CubicNodes[k];
+				double d = -VolumeChange[i]/Slope;
+				double c1 = d/A[i];
+				double R = (R0[i] + 27.*c1) / 54.;
+				double R2 = R*R;
+				if (R2 < Q3[i])
+				{
+					//3 real roots
+					double Theta = acos(R/sqrt(Q3[i]));
+					if (Upcoast[i]) PositionChange[i] = Min2RootQ[i]*cos(Theta/3.) - AOver3[i];
+					else PositionChange[i] = Min2RootQ[i]*cos((Theta-2.*M_PI)/3.) - AOver3[i];
+				}
+				else
+				{
+					//the only real root
+					double RootA = -pow(R + sqrt(R2-Q3[i]),1./3.);
+					double RootB = (RootA == 0) ? 0 : Q[i]/RootA;
+					PositionChange[i] = (RootA + RootB) - AOver3[i];
+				}
+			}
+#ifdef _OPENMP
+			#pragma omp for schedule(static) nowait
+#endif
+			for (int k=0; k<NoQuadratic; ++k)
+			{
+				int i = QuadraticNodes[k];
+				double c = -2.*VolumeChange[i]/Depth;
+				PositionChange[i] = (-QuadraticB[i]+sqrt(QuadraticBB[i]-Quadratic4A[i]*c))/Quadratic2A[i];
+			}
+#ifdef _OPENMP
+			#pragma omp for schedule(static)
+#endif
+			for (int k=0; k<NoLinear; ++k)
+			{
+				int i = LinearNodes[k];
+				PositionChange[i] = VolumeChange[i]/LinearScale[i];
+			}
+		}
+	}
+
+	/// @brief Finds nodes that moved too far and limits erosion of the rest
+	/// @details Nodes that move more than MaxChange or give NaN are counted in
+	/// get_NoBadNodes. Others are stopped from eroding more than their beach
+	/// width, as in Coastline::TransportSediment.
+	/// @param BeachWidth const double*, per node (m)
+	/// @param PositionChange double*, position changes (m)
+	/// @param MaxChange double, largest change in position allowed (m)
+	/// @return int, the first node (in coast order) that moved too far, or the number of nodes if none did
+	int CheckChanges(const double* BeachWidth, double* PositionChange, double MaxChange)
+	{
+		//check for large changes or NaN, the caller reduces the timestep
+		int FirstBadNode = NoNodes, BadCount = 0, NaNCount = 0;
+		double Largest = 0;
+		for (int i=0; i<NoNodes; ++i)
+		{
+			if (PositionChange[i] != PositionChange[i]) ++NaNCount;
+			else if (fabs(PositionChange[i]) > Largest) Largest = fabs(PositionChange[i]);
+			if ((fabs(PositionChange[i]) > MaxChange) || (PositionChange[i] != PositionChange[i]))
+			{
+				if (i < FirstBadNode) FirstBadNode = i;
+				++BadCount;
+			}
+			//more needed here!
+			else if ((BeachWidth[i] != -9999) && (PositionChange[i] < -(BeachWidth[i]))) PositionChange[i] = BeachWidth[i];
+		}
+		NoBadNodes = BadCount;
+		NoNaN = NaNCount;
+		LargestChange = Largest;
+		return FirstBadNode;
+	}
+
+	/// @brief tan(e1)+tan(e2) for node i from the last Setup
+	double get_SumTanE(int i) const { return SumTanE[i]; }
+
+	/// @brief Number of nodes that moved too far in the last CheckChanges
+	int get_NoBadNodes() const { return NoBadNodes; }
+
+	/// @brief Number of nodes whose position change was NaN in the last CheckChanges
+	int get_NoNaN() const { return NoNaN; }
+
+	/// @brief Largest change in position in the last CheckChanges, ignoring NaNs (m)
+	double get_LargestChange() const { return LargestChange; }
+
+	private:
+
+	int NoNodes;
+	int NoBadNodes, NoNaN;
+	double LargestChange; //(m)
+	double Slope, Depth; //Shoreface slope and closure depth (m)
+	vector<double> SumTanE; //tan(e1)+tan(e2)
+	vector<double> A, A1, B1, Q, Q3, R0, AOver3, Min2RootQ; //Cubic terms that don't depend on the volume change
+	vector<int> Upcoast; //Which of the three real cubic roots to use, 1 if e1 < 0
+	vector<double> QuadraticB, QuadraticBB, Quadratic4A, Quadratic2A; //Quadratic terms that don't depend on the volume change
+	vector<double> LinearScale; //CellWidth*ClosureDepth for cells where the equation is linear
+	vector<int> CubicNodes, QuadraticNodes, LinearNodes; //Nodes solved by each equation
+};
+
+#endif
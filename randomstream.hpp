@@ -0,0 +1,266 @@
+/*==============================================================
+
+randomstream.hpp
+
+Counter-based random number generator (Philox4x32-10) owned by
+each stochastic wave climate, with explicit seed and stream.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file randomstream.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief counter-based random numbers for wave climates
+@details The wave climates used to draw from the global rand(), which every
+climate's initialiser reseeded with srand(1). Results therefore depended on
+the order climates were made and on any other calls to rand() in a driver,
+two climates couldn't be sampled independently and sampling couldn't be
+shared between threads. RandomStream is the Philox4x32-10 generator of
+Salmon et al. (2011, Parallel random numbers: as easy as 1, 2, 3, SC11).
+The n-th block of four 32 bit numbers is a keyed bijection of n, so a stream
+is fixed by its seed (the key) and stream number (the upper half of the
+counter) alone, any position in it can be reached without generating the
+numbers before it, and different streams are statistically independent.
+Each object holds only its key, counter and a few buffered numbers, so each
+climate, or each member of an ensemble on its own thread, has its own.
+Normal deviates are by the Box-Muller transform, as before, using both
+deviates of each pair.
+@date 16/10/2026
+*/
+
+#ifndef randomstream_HPP
+#define randomstream_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+using namespace std;
+
+/// @brief Philox4x32-10 random number stream with an explicit seed and stream number.
+/// @details Streams with the same seed and stream number give the same numbers on
+/// any platform. Uniforms and Normals fill arrays with exactly the numbers the same
+/// number of calls to Uniform and Normal would give.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class RandomStream
+{
+	public:
+
+	/// @brief Stream 0 of seed 1
+	RandomStream() { Seed(1, 0); }
+
+	/// @brief Stream NewStream of seed NewSeed
+	RandomStream(uint64_t NewSeed, uint64_t NewStream = 0) { Seed(NewSeed, NewStream); }
+
+	/// @brief Starts stream NewStream of seed NewSeed from the beginning
+	void Seed(uint64_t NewSeed, uint64_t NewStream = 0)
+	{
+		SeedValue = NewSeed, StreamValue = NewStream;
+		SetPosition(0);
+	}
+
+	/// @brief Moves to the start of block Block of the stream, each block is four 32 bit numbers
+	void SetPosition(uint64_t Block)
+	{
+		NextBlock = Block;
+		Position = 4;
+		HaveSpare = 0;
+	}
+
+	/// @brief Next 32 bit random integer
+	uint32_t Next32()
+	{
+		if (Position == 4) Refill();
+		return Buffer[Position++];
+	}
+
+	/// @brief Uniform deviate on (0, 1), 53 bits from two 32 bit numbers
+	double Uniform()
+	{
+		uint32_t High = Next32();
+		return ToUniform(High, Next32());
+	}
+
+	/// @brief Standard normal deviate
+	double Normal()
+	{
+		if (HaveSpare == 1)
+		{
+			HaveSpare = 0;
+			return Spare;
+		}
+		double R = sqrt(-2.*log(Uniform()));
+		double Theta = 2.*M_PI*Uniform();
+		Spare = R*sin(Theta);
+		HaveSpare = 1;
+		return R*cos(Theta);
+	}
+
+	/// @brief Fills Out with N uniform deviates on (0, 1)
+	/// @details After finishing the current block, whole blocks are generated
+	/// a chunk at a time, each round of the bijection applied to every block
+	/// of the chunk in a loop the compiler can vectorise.
+	void Uniforms(double* Out, int N)
+	{
+		int k = 0;
+		while (k < N && Position != 4) Out[k++] = Uniform();
+
+		uint32_t c0[ChunkSize], c1[ChunkSize], c2[ChunkSize], c3[ChunkSize];
+		while (N-k >= 2)
+		{
+			int NoBlocks = min((int)ChunkSize, (N-k)/2);
+			for (int b=0; b<NoBlocks; ++b)
+			{
+				uint64_t Block = NextBlock+b;
+				c0[b] = (uint32_t)Block, c1[b] = (uint32_t)(Block >> 32);
+				c2[b] = (uint32_t)StreamValue, c3[b] = (uint32_t)(StreamValue >> 32);
+			}
+			PhiloxBlocks(c0, c1, c2, c3, NoBlocks);
+			for (int b=0; b<NoBlocks; ++b)
+			{
+				Out[k+2*b] = ToUniform(c0[b], c1[b]);
+				Out[k+2*b+1] = ToUniform(c2[b], c3[b]);
+			}
+			NextBlock += NoBlocks;
+			k += 2*NoBlocks;
+		}
+		if (k < N) Out[k] = Uniform();
+	}
+
+	/// @brief Fills Out with N standard normal deviates
+	/// @details The uniforms are drawn first, then transformed in pairs in a loop
+	/// with no branches or calls to the generator, which the compiler can vectorise.
+	void Normals(double* Out, int N)
+	{
+		int k = 0;
+		if (N > 0 && HaveSpare == 1) Out[k++] = Normal();
+		int NoPairs = (N-k)/2;
+		double* Pairs = Out+k;
+		Uniforms(Pairs, 2*NoPairs);
+		for (int p=0; p<NoPairs; ++p)
+		{
+			double R = sqrt(-2.*log(Pairs[2*p]));
+			double Theta = 2.*M_PI*Pairs[2*p+1];
+			Pairs[2*p] = R*cos(Theta);
+			Pairs[2*p+1] = R*sin(Theta);
+		}
+		if (k+2*NoPairs < N) Out[N-1] = Normal();
+	}
+
+	/// @brief 1 if the next call to Normal will return the second deviate of a pair
+	int get_HaveSpare() const { return HaveSpare; }
+
+	uint64_t get_Seed() const { return SeedValue; }
+	uint64_t get_Stream() const { return StreamValue; }
+
+	/// @brief Stream number from a set of parameters
+	/// @details FNV-1a hash of their bytes, so that objects made with different
+	/// parameters draw from different streams by default, whatever order they are made in.
+	static uint64_t StreamFor(const double* Parameters, int N)
+	{
+		uint64_t Hash = 14695981039346656037ULL;
+		const unsigned char* Bytes = (const unsigned char*)Parameters;
+		for (int b=0, n=N*(int)sizeof(double); b<n; ++b) Hash = (Hash ^ Bytes[b])*1099511628211ULL;
+		return Hash;
+	}
+
+	/// @brief The Philox4x32-10 bijection of Counter under Key
+	static void Philox(const uint32_t Counter[4], const uint32_t Key[2], uint32_t Out[4])
+	{
+		uint32_t c0 = Counter[0], c1 = Counter[1], c2 = Counter[2], c3 = Counter[3];
+		uint32_t k0 = Key[0], k1 = Key[1];
+		for (int Round=0; Round<10; ++Round)
+		{
+			uint64_t Product0 = (uint64_t)0xD2511F53U*c0;
+			uint64_t Product1 = (uint64_t)0xCD9E8D57U*c2;
+			uint32_t n0 = (uint32_t)(Product1 >> 32) ^ c1 ^ k0;
+			uint32_t n2 = (uint32_t)(Product0 >> 32) ^ c3 ^ k1;
+			c1 = (uint32_t)Product1, c3 = (uint32_t)Product0;
+			c0 = n0, c2 = n2;
+			k0 += 0x9E3779B9U, k1 += 0xBB67AE85U;
+		}
+		Out[0] = c0, Out[1] = c1, Out[2] = c2, Out[3] = c3;
+	}
+
+	private:
+
+	enum { ChunkSize = 64 }; //Blocks generated at once by Uniforms
+
+	uint64_t SeedValue, StreamValue;
+	uint64_t NextBlock; //Counter of the next block to generate
+	uint32_t Buffer[4]; //Current block
+	int Position; //Next number to use from Buffer, 4 = empty
+	int HaveSpare; //1 if Spare holds the second deviate of the last Box-Muller pair
+	double Spare;
+
+	/// @brief Uniform deviate on (0, 1) from the 53 high bits of High, Low
+	static double ToUniform(uint32_t High, uint32_t Low)
+	{
+		uint64_t Bits = ((uint64_t)High << 32) | Low;
+		return ((double)(Bits >> 11) + 0.5)*(1./9007199254740992.);
+	}
+
+	/// @brief Philox applied to NoBlocks counters at once, held as four arrays of words
+	void PhiloxBlocks(uint32_t* c0, uint32_t* c1, uint32_t* c2, uint32_t* c3, int NoBlocks) const
+	{
+		uint32_t k0 = (uint32_t)SeedValue, k1 = (uint32_t)(SeedValue >> 32);
+		for (int Round=0; Round<10; ++Round)
+		{
+			for (int b=0; b<NoBlocks; ++b)
+			{
+				uint64_t Product0 = (uint64_t)0xD2511F53U*c0[b];
+				uint64_t Product1 = (uint64_t)0xCD9E8D57U*c2[b];
+				uint32_t n0 = (uint32_t)(Product1 >> 32) ^ c1[b] ^ k0;
+				uint32_t n2 = (uint32_t)(Product0 >> 32) ^ c3[b] ^ k1;
+				c1[b] = (uint32_t)Product1, c3[b] = (uint32_t)Product0;
+				c0[b] = n0, c2[b] = n2;
+			}
+			k0 += 0x9E3779B9U, k1 += 0xBB67AE85U;
+		}
+	}
+
+	void Refill()
+	{
+		uint32_t Counter[4] = {(uint32_t)NextBlock, (uint32_t)(NextBlock >> 32), (uint32_t)StreamValue, (uint32_t)(StreamValue >> 32)};
+		uint32_t Key[2] = {(uint32_t)SeedValue, (uint32_t)(SeedValue >> 32)};
+		Philox(Counter, Key, Buffer);
+		++NextBlock;
+		Position = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*==============================================================
+
+segmentgrid.hpp
+
+Uniform grid of line segment bounding boxes used as a broad
+phase for finding which segments of a coastline or cliffline
+might touch one another, and which segment of one line is
+nearest to a point on the other.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file segmentgrid.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief uniform grid broad phase for polyline segments
+@details Segment i of a polyline joins node i to node i+1. The SegmentGrid
+bins the bounding box of every segment into square cells, so that the
+segments near a given box can be found without testing the whole line. It
+also answers nearest segment queries, used to measure beach width
+between a coastline and its cliffline.
+@date 16/10/2026
+*/
+
+#ifndef segmentgrid_HPP
+#define segmentgrid_HPP
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/// @brief Uniform grid of polyline segment bounding boxes.
+/// @details Built from node positions in O(N) with the segments of each cell
+/// stored contiguously (compressed rows). Storage is kept between builds, so
+/// rebuilding every timestep for a coast with a settled number of nodes does
+/// not touch the heap. Queries return every segment whose bounding box might
+/// overlap the query box, sorted by segment index; they can return segments
+/// that turn out not to overlap but never miss one that does.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class SegmentGrid
+{
+	public:
+
+	SegmentGrid() : NoSegments(0), NoCellsX(0), NoCellsY(0), XOrigin(0), YOrigin(0), CellSize(1), Pad(0), QueryNo(0) {}
+
+	/// @brief Bins segments 0 to NoSegs-1 of the polyline X, Y (NoSegs+1 nodes)
+	/// @details The cell size is the mean segment length, grown if needed so
+	/// that there are no more than MaxCellsPerSegment cells per segment.
+	void Build(const double* X, const double* Y, int NoSegs)
+	{
+		NoSegments = max(NoSegs, 0);
+		QueryNo = 0;
+		Reserve(Stamp, NoSegments);
+		Stamp.assign(NoSegments, 0);
+		if (NoSegments == 0)
+		{
+			NoCellsX = NoCellsY = 0;
+			CellStart.assign(1, 0);
+			CellSegments.clear();
+			return;
+		}
+
+		//extent of the line and mean segment length
+		double XMin = X[0], XMax = X[0], YMin = Y[0], YMax = Y[0];
+		double TotalLength = 0;
+		for (int i=0; i<NoSegments; ++i)
+		{
+			XMin = min(XMin, X[i+1]), XMax = max(XMax, X[i+1]);
+			YMin = min(YMin, Y[i+1]), YMax = max(YMax, Y[i+1]);
+			TotalLength += sqrt((X[i+1]-X[i])*(X[i+1]-X[i]) + (Y[i+1]-Y[i])*(Y[i+1]-Y[i]));
+		}
+		CellSize = TotalLength/NoSegments;
+		if (!(CellSize > 0)) CellSize = 1.;
+		while (((XMax-XMin)/CellSize+1.)*((YMax-YMin)/CellSize+1.) > (double)MaxCellsPerSegment*NoSegments) CellSize *= 2.;
+		XOrigin = XMin, YOrigin = YMin;
+		NoCellsX = (int)((XMax-XMin)/CellSize)+1;
+		NoCellsY = (int)((YMax-YMin)/CellSize)+1;
+
+		//boxes are grown slightly so that segments that only just touch are
+		//always binned together, whatever the rounding in the caller's test
+		Pad = 1e-6*CellSize;
+
+		//count the segments in each cell, then fill the rows
+		Reserve(CellStart, MaxCellsPerSegment*NoSegments+1); //the most cells the grid can have
+		Reserve(Cursor, MaxCellsPerSegment*NoSegments);
+		CellStart.assign(NoCellsX*NoCellsY+1, 0);
+		int XCell0, XCell1, YCell0, YCell1;
+		for (int i=0; i<NoSegments; ++i)
+		{
+			GetCells(min(X[i],X[i+1]), min(Y[i],Y[i+1]), max(X[i],X[i+1]), max(Y[i],Y[i+1]), XCell0, YCell0, XCell1, YCell1);
+			for (int b=YCell0; b<=YCell1; ++b) for (int a=XCell0; a<=XCell1; ++a) ++CellStart[b*NoCellsX+a+1];
+		}
+		for (int c=0; c<NoCellsX*NoCellsY; ++c) CellStart[c+1] += CellStart[c];
+		Reserve(CellSegments, max(CellStart[NoCellsX*NoCellsY], 4*NoSegments)); //a segment no longer than a cell is in at most 4
+		CellSegments.resize(CellStart[NoCellsX*NoCellsY]);
+		Cursor.assign(CellStart.begin(), CellStart.end()-1);
+		for (int i=0; i<NoSegments; ++i)
+		{
+			GetCells(min(X[i],X[i+1]), min(Y[i],Y[i+1]), max(X[i],X[i+1]), max(Y[i],Y[i+1]), XCell0, YCell0, XCell1, YCell1);
+			for (int b=YCell0; b<=YCell1; ++b) for (int a=XCell0; a<=XCell1; ++a) CellSegments[Cursor[b*NoCellsX+a]++] = i;
+		}
+	}
+
+	/// @brief Finds the segments that might overlap the box XMin-XMax, YMin-YMax
+	/// @param Segments vector<int>, cleared and filled with segment indices in ascending order
+	void Query(double XMin, double YMin, double XMax, double YMax, vector<int>& Segments)
+	{
+		Segments.clear();
+		if (NoSegments == 0) return;
+		if (Segments.capacity() < (size_t)NoSegments) Segments.reserve(NoSegments); //the most a query can find
+		int XCell0, XCell1, YCell0, YCell1;
+		GetCells(XMin, YMin, XMax, YMax, XCell0, YCell0, XCell1, YCell1);
+
+		//each segment is only reported once, however many cells it covers
+		++QueryNo;
+		for (int b=YCell0; b<=YCell1; ++b)
+		{
+			for (int a=XCell0; a<=XCell1; ++a)
+			{
+				for (int k=CellStart[b*NoCellsX+a]; k<CellStart[b*NoCellsX+a+1]; ++k)
+				{
+					if (Stamp[CellSegments[k]] == QueryNo) continue;
+					Stamp[CellSegments[k]] = QueryNo;
+					Segments.push_back(CellSegments[k]);
+				}
+			}
+		}
+		sort(Segments.begin(), Segments.end());
+	}
+
+	/// @brief Finds the segment nearest to the point PX, PY
+	/// @details Searches the cells around the point a ring at a time, stopping once no
+	/// segment outside the cells searched could be nearer than the nearest found. This is
+	/// exact, and for a point near the line it tests only the few segments close by, however
+	/// long the line. Ties go to the lower segment index. X and Y must be the nodes the grid
+	/// was built from.
+	/// @param Distance double, distance from the point to the segment (m)
+	/// @param t double, fraction along the segment of the point's projection onto it, the
+	/// nearest point on the segment is at t clamped to 0-1
+	/// @return int, the nearest segment, -1 if there are none
+	int Nearest(const double* X, const double* Y, double PX, double PY, double& Distance, double& t) const
+	{
+		Distance = -1, t = 0;
+		if (NoSegments == 0) return -1;
+		int XCell = GetCell(PX, XOrigin, NoCellsX);
+		int YCell = GetCell(PY, YOrigin, NoCellsY);
+		int Best = -1;
+		double BestDistance2 = 0, Bestt = 0;
+		for (int r=0; ; ++r)
+		{
+			int XCell0 = XCell-r, XCell1 = XCell+r, YCell0 = YCell-r, YCell1 = YCell+r;
+			for (int b=max(YCell0, 0); b<=min(YCell1, NoCellsY-1); ++b)
+			{
+				//the cells inside the ring were searched last time round
+				int Step = (b == YCell0 || b == YCell1) ? 1 : XCell1-XCell0;
+				for (int a=XCell0; a<=XCell1; a+=Step)
+				{
+					if (a < 0 || a > NoCellsX-1) continue;
+					for (int k=CellStart[b*NoCellsX+a]; k<CellStart[b*NoCellsX+a+1]; ++k)
+					{
+						int j = CellSegments[k];
+						double dX = X[j+1]-X[j], dY = Y[j+1]-Y[j];
+						double Length2 = dX*dX + dY*dY;
+						double tj = (Length2 > 0) ? ((PX-X[j])*dX + (PY-Y[j])*dY)/Length2 : 0;
+						double tc = (tj < 0) ? 0 : ((tj > 1) ? 1 : tj);
+						double ex = X[j]+tc*dX-PX, ey = Y[j]+tc*dY-PY;
+						double Distance2 = ex*ex + ey*ey;
+						if (Best < 0 || Distance2 < BestDistance2 || (Distance2 == BestDistance2 && j < Best))
+						{
+							Best = j, BestDistance2 = Distance2, Bestt = tj;
+						}
+					}
+				}
+			}
+
+			//any segment not yet tested lies beyond the edge of the cells searched,
+			//there is nothing beyond the edges of the grid
+			if (XCell0 <= 0 && YCell0 <= 0 && XCell1 >= NoCellsX-1 && YCell1 >= NoCellsY-1) break;
+			double Bound = 1e300;
+			if (XCell0 > 0) Bound = min(Bound, PX-(XOrigin+XCell0*CellSize));
+			if (XCell1 < NoCellsX-1) Bound = min(Bound, XOrigin+(XCell1+1)*CellSize-PX);
+			if (YCell0 > 0) Bound = min(Bound, PY-(YOrigin+YCell0*CellSize));
+			if (YCell1 < NoCellsY-1) Bound = min(Bound, YOrigin+(YCell1+1)*CellSize-PY);
+			if (Best >= 0 && Bound > 0 && Bound*Bound > BestDistance2) break;
+		}
+		Distance = sqrt(BestDistance2), t = Bestt;
+		return Best;
+	}
+
+	int get_NoSegments() const { return NoSegments; }
+
+	private:
+
+	enum { MaxCellsPerSegment = 4 };
+
+	int NoSegments;
+	int NoCellsX, NoCellsY;
+	double XOrigin, YOrigin;
+	double CellSize;
+	double Pad;
+	int QueryNo;
+	vector<int> CellStart; //Start of each cell's row in CellSegments, NoCellsX*NoCellsY+1
+	vector<int> CellSegments; //Segment indices binned by cell
+	vector<int> Cursor; //Fill position for each cell during Build
+	vector<int> Stamp; //Last query each segment was reported by
+
+	/// @brief Grows the capacity of v to at least n geometrically, so that a grid
+	/// rebuilt every timestep for a similar line does not reallocate
+	static void Reserve(vector<int>& v, int n)
+	{
+		if (v.capacity() < (size_t)n) v.reserve(max((size_t)n, 2*v.capacity()));
+	}
+
+	/// @brief Range of cells covered by a padded box, clamped to the grid
+	void GetCells(double XMin, double YMin, double XMax, double YMax, int& XCell0, int& YCell0, int& XCell1, int& YCell1) const
+	{
+		XCell0 = GetCell(XMin-Pad, XOrigin, NoCellsX);
+		XCell1 = GetCell(XMax+Pad, XOrigin, NoCellsX);
+		YCell0 = GetCell(YMin-Pad, YOrigin, NoCellsY);
+		YCell1 = GetCell(YMax+Pad, YOrigin, NoCellsY);
+	}
+
+	int GetCell(double Position, double Origin, int NoCells) const
+	{
+		double Cell = floor((Position-Origin)/CellSize);
+		if (!(Cell > 0)) return 0;
+		if (Cell > NoCells-1) return NoCells-1;
+		return (int)Cell;
+	}
+};
+
+#endif
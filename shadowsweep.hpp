@@ -0,0 +1,200 @@
+/*==============================================================
+
+shadowsweep.hpp
+
+Finds the segments of the coast that might shadow each node
+from the offshore waves by sweeping across the wave direction.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file shadowsweep.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief sweep line broad phase for Coastline::GetShadows
+@details A node is in shadow if the ray from it towards the offshore waves
+crosses the coast. Every point on that ray has the same position u across the
+wave direction as the node, and lies further offshore in v along the wave
+direction. So only segments whose u range contains the node's u and which reach
+further offshore than the node can cross it. Nodes and segments are sorted by
+u and swept in order, keeping the segments whose u range contains the current
+node, which for most coasts is only a few at a time. GetShadows tests only
+these candidates with its exact test, so the result is the same as testing
+every segment, in O(N log N) rather than O(N^2).
+@date 16/10/2026
+*/
+
+#ifndef shadowsweep_HPP
+#define shadowsweep_HPP
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/// @brief Sweeps nodes across the wave direction, finding the segments that might shadow each.
+/// @details Build once per wave direction, then call Advance for k = 0 to size()-1,
+/// which visits every node once in order of u. Storage is kept between builds.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class ShadowSweep
+{
+	public:
+
+	ShadowSweep() : N(0), NextSegment(0), Pad(0) {}
+
+	/// @brief Projects the nodes onto and across the wave direction and sorts them
+	/// @param X, Y const double*, node positions (m), with any periodic copies (see GhostColumn)
+	/// @param NewN int, number of nodes
+	/// @param WaveDirection double, direction the waves come from (degrees)
+	void Build(const double* X, const double* Y, int NewN, double WaveDirection)
+	{
+		N = NewN;
+		double SinDirection = sin((M_PI/180.)*WaveDirection);
+		double CosDirection = cos((M_PI/180.)*WaveDirection);
+		U.resize(N), V.resize(N);
+		double TotalLength = 0;
+		for (int k=0; k<N; ++k)
+		{
+			U[k] = X[k]*CosDirection - Y[k]*SinDirection;
+			V[k] = X[k]*SinDirection + Y[k]*CosDirection;
+			if (k > 0) TotalLength += fabs(U[k]-U[k-1]) + fabs(V[k]-V[k-1]);
+		}
+
+		//bounds are padded so that segments that only just reach a node are
+		//always candidates, whatever the rounding in the exact test
+		Pad = (N > 1) ? 1e-6*TotalLength/(N-1) + 1e-9 : 0;
+
+		int NoSegments = max(N-1, 0);
+		MinU.resize(NoSegments), MaxU.resize(NoSegments), MaxV.resize(NoSegments);
+		for (int j=0; j<NoSegments; ++j)
+		{
+			MinU[j] = min(U[j], U[j+1]);
+			MaxU[j] = max(U[j], U[j+1]);
+			MaxV[j] = max(V[j], V[j+1]);
+		}
+
+		NodeOrder.resize(N);
+		for (int k=0; k<N; ++k) NodeOrder[k] = k;
+		sort(NodeOrder.begin(), NodeOrder.end(), LessThan(U));
+		SegmentOrder.resize(NoSegments);
+		for (int j=0; j<NoSegments; ++j) SegmentOrder[j] = j;
+		sort(SegmentOrder.begin(), SegmentOrder.end(), LessThan(MinU));
+
+		//every segment may be active at once, so reserve for that rather than grow mid-sweep
+		Active.clear();
+		Active.reserve(NoSegments);
+		NextSegment = 0;
+	}
+
+	/// @brief Moves the sweep on to the k-th node in order of u
+	/// @param k int, position in the sweep, called for k = 0, 1, 2, ... in turn
+	/// @param Candidates vector<int>, cleared and filled with the segments that might shadow the node
+	/// @return int, index in the view of the node
+	int Advance(int k, vector<int>& Candidates)
+	{
+		int i = NodeOrder[k];
+		double u = U[i];
+		int NoSegments = SegmentOrder.size();
+		while (NextSegment < NoSegments && MinU[SegmentOrder[NextSegment]] <= u+Pad) Active.push_back(SegmentOrder[NextSegment++]);
+
+		//drop segments the sweep has passed, they can't reach any later node
+		Candidates.clear();
+		int NoActive = 0;
+		for (int a=0, m=Active.size(); a<m; ++a)
+		{
+			int j = Active[a];
+			if (MaxU[j] < u-Pad) continue;
+			Active[NoActive++] = j;
+			if (MaxV[j] >= V[i]-Pad) Candidates.push_back(j);
+		}
+		Active.resize(NoActive);
+		return i;
+	}
+
+	/// @brief Number of nodes to sweep
+	int size() const { return N; }
+
+	/// @brief Whether the ray from X1, Y1 along dX12, dY12 crosses the segment X3, Y3 to X4, Y4
+	/// @details The exact test used by GetShadows, from the cross products of the two lines.
+	static int RayCrossesSegment(double X1, double Y1, double dX12, double dY12, double X3, double Y3, double X4, double Y4)
+	{
+		double dX34 = X4-X3;
+		double dY34 = Y4-Y3;
+
+		//Find the cross product of the two vectors
+		double XProd = dX12*dY34 - dX34*dY12;
+
+		//Xproduct == 0 for parallel lines
+		if (XProd == 0) return 0;
+		int XProdPos = (XProd > 0) ? 1 : 0;
+
+		//assign third test segment
+		double dX31 = X1-X3;
+		double dY31 = Y1-Y3;
+
+		//get cross products
+		double S = dX12*dY31 - dY12*dX31;
+		double T = dX34*dY31 - dY34*dX31;
+
+		//logic for collision occurence
+		if ((S < 0) == XProdPos) return 0;
+		else if ((T < 0) == XProdPos) return 0;
+		else if (((S > XProd) == XProdPos) or ((T > XProd) == XProdPos)) return 0;
+		return 1;
+	}
+
+	private:
+
+	/// @brief Orders indices by a key
+	struct LessThan
+	{
+		const vector<double>& Key;
+		LessThan(const vector<double>& TheKey) : Key(TheKey) {}
+		bool operator()(int a, int b) const { return Key[a] < Key[b]; }
+	};
+
+	int N;
+	int NextSegment; //Next segment in SegmentOrder to join the sweep
+	double Pad; //Tolerance on the bounds (m)
+	vector<double> U, V; //Node positions across and along the wave direction (m)
+	vector<double> MinU, MaxU, MaxV; //Bounds of each segment
+	vector<int> NodeOrder; //Nodes sorted by U
+	vector<int> SegmentOrder; //Segments sorted by MinU
+	vector<int> Active; //Segments whose u range may contain the current node
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*==============================================================
+
+shorelinediffusion.hpp
+
+Semi-implicit correction of the change in shoreline position
+for the diffusive part of longshore transport, allowing long
+timesteps where waves approach the coast at low angles.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file shorelinediffusion.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief linearly implicit shoreline diffusion
+@details The flux Q_i between nodes i and i+1 depends on the orientation of
+the coast between them. Linearised about the current orientation, a change in
+position d of the two nodes rotates the segment by (d_i+1 - d_i)/dx_i and
+changes the flux by D_i times that, D_i = dQ/dtheta (see the Diffusivity
+functions in transportpolicies.hpp). Taking the change in flux at the end of
+the step rather than the start, each cell of width W and depth Dc satisfies
+
+	W_i Dc d_i + dt K_i-1 (d_i - d_i-1) + dt K_i (d_i - d_i+1) = W_i Dc d*_i,
+
+K_i = D_i/dx_i, where d* is the explicit change in position. This is backward
+Euler for the linear part of the problem and stable for any timestep. Only
+segments with D_i > 0 are treated this way, segments where high angle waves
+are anti-diffusive have K_i = 0 and stay explicit. The system is tridiagonal,
+or cyclic tridiagonal for periodic boundaries, and is solved by the Thomas
+algorithm, with the Sherman-Morrison formula for the corners of the cyclic
+system (Press et al. 1992).
+@date 16/10/2026
+*/
+
+#ifndef shorelinediffusion_HPP
+#define shorelinediffusion_HPP
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/// @brief Solves for the change in shoreline position with the diffusive flux implicit.
+/// @details Setup finds the coefficients for the current coast once per step,
+/// Apply corrects an explicit change in position for a given timestep and may be
+/// called again if the timestep is reduced.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class ShorelineDiffusion
+{
+	public:
+
+	ShorelineDiffusion() : NoNodes(0), Periodic(0), NoImplicitSegments(0) {}
+
+	/// @brief Finds the coefficients of the system for the current coast
+	/// @param N int, number of nodes
+	/// @param X, Y const double*, node positions (m)
+	/// @param CellWidth const double*, width of each cell (m)
+	/// @param Diffusivity const double*, dQ/dtheta between nodes i and i+1 (m3/day per radian), N-1 long
+	/// @param Fixed const int*, 1 if the node can't move
+	/// @param Depth double, depth of the active shoreface (m)
+	/// @param StartBoundary, EndBoundary int, 1 = periodic, 2 = fixed
+	void Setup(int N, const double* X, const double* Y, const double* CellWidth, const double* Diffusivity,
+			const int* Fixed, double Depth, int StartBoundary, int EndBoundary)
+	{
+		NoNodes = N;
+		Periodic = (StartBoundary == 1 && EndBoundary == 1) ? 1 : 0;
+		K.assign(N, 0.);
+		Mass.resize(N);
+		Held.assign(N, 0);
+
+		//segments where the flux is diffusive
+		NoImplicitSegments = 0;
+		for (int i=0; i<N-1; ++i)
+		{
+			if (Diffusivity[i] <= 0) continue;
+			double dX = X[i+1]-X[i];
+			double dY = Y[i+1]-Y[i];
+			double Distance = sqrt(dX*dX + dY*dY);
+			if (Distance > 0) K[i] = Diffusivity[i]/Distance, ++NoImplicitSegments;
+		}
+
+		//nodes whose change in position is already decided
+		for (int i=0; i<N; ++i)
+		{
+			Mass[i] = CellWidth[i]*Depth;
+			if (Fixed[i] == 1 || !(Mass[i] > 0)) Held[i] = 1;
+			else if ((i < 2) && (StartBoundary == 2)) Held[i] = 1;
+			else if ((i > N-3) && (EndBoundary == 2)) Held[i] = 1;
+		}
+	}
+
+	/// @brief Corrects the explicit change in position of every node
+	/// @details For periodic boundaries the first node is a copy of the last,
+	/// which joins the second by the first segment.
+	/// @param TimeDelta double, timestep (days)
+	/// @param PositionChange double*, explicit change in position in, corrected change out (m)
+	void Apply(double TimeDelta, double* PositionChange)
+	{
+		if (NoImplicitSegments == 0) return;
+
+		if (Periodic == 1)
+		{
+			//unknowns are nodes 1 to N-1, node N-1 joins node 1 through segment 0
+			int m = NoNodes-1;
+			if (m < 3) return;
+			Resize(m);
+			for (int k=0; k<m; ++k)
+			{
+				int i = k+1;
+				double Left = (i == 1) ? K[0] : K[i-1];
+				double Right = (i == NoNodes-1) ? K[0] : K[i];
+				SetRow(k, i, Left, Right, TimeDelta, PositionChange);
+			}
+			double Alpha = c[m-1], Beta = a[0]; //corners, row m-1 col 0 and row 0 col m-1
+			c[m-1] = 0, a[0] = 0;
+			SolveCyclic(m, Alpha, Beta);
+			for (int k=0; k<m; ++k) PositionChange[k+1] = x[k];
+			PositionChange[0] = PositionChange[NoNodes-1];
+		}
+		else
+		{
+			int m = NoNodes;
+			if (m < 2) return;
+			Resize(m);
+			for (int i=0; i<m; ++i)
+			{
+				double Left = (i > 0) ? K[i-1] : 0;
+				double Right = (i < m-1) ? K[i] : 0;
+				SetRow(i, i, Left, Right, TimeDelta, PositionChange);
+			}
+			SolveTridiagonal(m);
+			for (int i=0; i<m; ++i) PositionChange[i] = x[i];
+		}
+	}
+
+	/// @brief Number of segments treated implicitly at the last Setup
+	int get_NoImplicitSegments() const { return NoImplicitSegments; }
+
+	private:
+
+	int NoNodes;
+	int Periodic;
+	int NoImplicitSegments;
+	vector<double> K; //D/dx between nodes i and i+1, 0 where explicit (m2/day)
+	vector<double> Mass; //CellWidth*Depth, volume per unit change in position (m2)
+	vector<int> Held; //1 if the node's change in position isn't solved for
+	vector<double> a, b, c, d, x, Workspace; //Sub, main and super diagonals, right hand side and solution
+
+	void Resize(int m)
+	{
+		a.resize(m), b.resize(m), c.resize(m), d.resize(m), x.resize(m), Workspace.resize(m);
+	}
+
+	/// @brief Row k of the system, for node i
+	void SetRow(int k, int i, double Left, double Right, double TimeDelta, const double* PositionChange)
+	{
+		if (Held[i] == 1)
+		{
+			a[k] = 0, b[k] = 1., c[k] = 0, d[k] = PositionChange[i];
+			return;
+		}
+		a[k] = -TimeDelta*Left;
+		c[k] = -TimeDelta*Right;
+		b[k] = Mass[i] + TimeDelta*(Left+Right);
+		d[k] = Mass[i]*PositionChange[i];
+	}
+
+	/// @brief Thomas algorithm, solves rows 0 to m-1 of a, b, c and d into x
+	void SolveTridiagonal(int m)
+	{
+		SolveTridiagonal(m, d, x);
+	}
+
+	void SolveTridiagonal(int m, const vector<double>& RHS, vector<double>& Solution)
+	{
+		double Pivot = b[0];
+		Solution[0] = RHS[0]/Pivot;
+		for (int k=1; k<m; ++k)
+		{
+			Workspace[k] = c[k-1]/Pivot;
+			Pivot = b[k] - a[k]*Workspace[k];
+			Solution[k] = (RHS[k] - a[k]*Solution[k-1])/Pivot;
+		}
+		for (int k=m-2; k>=0; --k) Solution[k] -= Workspace[k+1]*Solution[k+1];
+	}
+
+	/// @brief Cyclic tridiagonal system with corners Alpha (row m-1, col 0) and Beta (row 0, col m-1)
+	/// @details Sherman-Morrison, following cyclic in Press et al. (1992). The corner
+	/// terms are taken out by modifying the first and last diagonal elements, and the
+	/// tridiagonal system is solved twice, once for the solution and once for the correction.
+	void SolveCyclic(int m, double Alpha, double Beta)
+	{
+		if (Alpha == 0 && Beta == 0)
+		{
+			SolveTridiagonal(m);
+			return;
+		}
+		double Gamma = -b[0];
+		double b0 = b[0], bm = b[m-1];
+		b[0] = b0 - Gamma;
+		b[m-1] = bm - Alpha*Beta/Gamma;
+		SolveTridiagonal(m);
+
+		vector<double> u(m, 0.), z(m);
+		u[0] = Gamma;
+		u[m-1] = Alpha;
+		SolveTridiagonal(m, u, z);
+		double Factor = (x[0] + Beta*x[m-1]/Gamma)/(1. + z[0] + Beta*z[m-1]/Gamma);
+		for (int k=0; k<m; ++k) x[k] -= Factor*z[k];
+		b[0] = b0, b[m-1] = bm;
+	}
+};
+
+#endif
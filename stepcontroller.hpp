@@ -0,0 +1,194 @@
+/*==============================================================
+
+stepcontroller.hpp
+
+Chooses the length of each timestep taken by
+Coastline::TransportSediment, shortening steps that move the
+coast too far and lengthening steps that move it too little.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file stepcontroller.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief adaptive timestep control for Coastline::TransportSediment
+@details The error of a step is the largest change in position of any node
+as a fraction of the largest change allowed (10 m by default). This is a cap
+on how far a step may move the coast, not an estimate of truncation error:
+fluxes are found once at the start of a step, and finding them again for a
+second estimate would cost as much as the step itself. Steps with an error
+above 1, or that give NaN, are rejected and tried again from the start of
+the step with a shorter timestep. Accepted steps set the length of
+the next step, which may be up to twice as long. Fluxes are found explicitly
+at the start of each step, so when run adaptively steps are also kept below
+the diffusive stability limit dx^2/(2D) of the flux law, D being the
+shoreline diffusivity (see the Diffusivity functions in transportpolicies.hpp).
+@date 16/10/2026
+*/
+
+#ifndef stepcontroller_HPP
+#define stepcontroller_HPP
+
+#include <cmath>
+
+using namespace std;
+
+/// @brief Accepts or rejects timesteps and proposes the next one.
+/// @details Start is called once per call to TransportSediment to get the
+/// first timestep to try, and Check after each attempt. A step of the
+/// minimum length is never rejected, so the model can't stall, but Check
+/// reports it so the caller can deal with the nodes that moved too far.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class TimeStepController
+{
+	public:
+
+	TimeStepController()
+	{
+		MinTimeDelta = 0.001;
+		MaxTimeDelta = 1.;
+		MaxPositionChange = 10.;
+		CFLNumber = 0.5;
+		Safety = 0.9;
+		MaxGrowth = 2.;
+		MaxShrink = 0.2;
+		NextTimeDelta = -9999;
+		TimeDelta = 0;
+		Error = 0;
+		NoAcceptedSteps = NoRejectedSteps = NoForcedSteps = 0;
+	}
+
+	/// @brief Sets the limits on the timestep and on the change in position
+	/// @param NewMinTimeDelta, NewMaxTimeDelta double, shortest and longest steps (days)
+	/// @param NewMaxPositionChange double, largest change in position of a node in one step (m)
+	/// @param NewCFLNumber double, fraction of the diffusive stability limit adaptive steps may use
+	void SetLimits(double NewMinTimeDelta, double NewMaxTimeDelta, double NewMaxPositionChange, double NewCFLNumber)
+	{
+		MinTimeDelta = NewMinTimeDelta;
+		MaxTimeDelta = NewMaxTimeDelta;
+		MaxPositionChange = NewMaxPositionChange;
+		CFLNumber = NewCFLNumber;
+	}
+
+	/// @brief The first timestep to try
+	/// @param Requested double, the timestep asked for by the caller (days). When
+	/// adaptive this is the longest step allowed, e.g. the time to the next wave.
+	/// @param StableTimeDelta double, the diffusive stability limit (days), only used when adaptive
+	/// @param Adaptive int, 1 = choose the timestep, 0 = try the requested timestep
+	/// @return double, the timestep to try (days)
+	double Start(double Requested, double StableTimeDelta, int Adaptive)
+	{
+		TimeDelta = Requested;
+		if (Adaptive == 1)
+		{
+			if (NextTimeDelta > 0 && NextTimeDelta < TimeDelta) TimeDelta = NextTimeDelta;
+			if (CFLNumber*StableTimeDelta < TimeDelta) TimeDelta = CFLNumber*StableTimeDelta;
+			if (MaxTimeDelta < TimeDelta) TimeDelta = MaxTimeDelta;
+			if (TimeDelta < MinTimeDelta) TimeDelta = (Requested < MinTimeDelta) ? Requested : MinTimeDelta;
+		}
+		return TimeDelta;
+	}
+
+	/// @brief Accepts or rejects the timestep just tried
+	/// @param LargestChange double, largest change in position of any node (m), ignoring NaNs
+	/// @param NoNaN int, number of nodes whose change in position is NaN
+	/// @return int, 1 = accepted, 0 = rejected, try again with get_TimeDelta,
+	/// -1 = rejected at the minimum timestep, the caller must take less than the
+	/// full step's change (see Coastline::TransportSediment) and accept it
+	int Check(double LargestChange, int NoNaN)
+	{
+		Error = (NoNaN > 0) ? HUGE_VAL : LargestChange/MaxPositionChange;
+
+		if (Error <= 1.)
+		{
+			//grow by up to MaxGrowth, shrink a little if close to the limit
+			double Factor = (Error > 0) ? Safety/Error : MaxGrowth;
+			if (Factor > MaxGrowth) Factor = MaxGrowth;
+			NextTimeDelta = TimeDelta*Factor;
+			if (NextTimeDelta > MaxTimeDelta) NextTimeDelta = MaxTimeDelta;
+			++NoAcceptedSteps;
+			return 1;
+		}
+
+		if (TimeDelta <= MinTimeDelta)
+		{
+			++NoAcceptedSteps;
+			++NoForcedSteps;
+			NextTimeDelta = MinTimeDelta;
+			return -1;
+		}
+		++NoRejectedSteps;
+
+		//position change is close to linear in timestep for small steps, NaN just halves it
+		double Factor = (NoNaN > 0) ? 0.5 : Safety/Error;
+		if (Factor < MaxShrink) Factor = MaxShrink;
+		TimeDelta *= Factor;
+		if (TimeDelta < MinTimeDelta) TimeDelta = MinTimeDelta;
+		return 0;
+	}
+
+	/// @brief The timestep being tried, or last accepted (days)
+	double get_TimeDelta() const { return TimeDelta; }
+
+	/// @brief The timestep proposed for the next step (days), -9999 before the first step
+	double get_NextTimeDelta() const { return NextTimeDelta; }
+
+	/// @brief Error of the last step tried, the largest change in position over the largest allowed
+	double get_Error() const { return Error; }
+
+	/// @brief The largest change in position of a node allowed in one step (m)
+	double get_MaxPositionChange() const { return MaxPositionChange; }
+
+	int get_NoAcceptedSteps() const { return NoAcceptedSteps; }
+	int get_NoRejectedSteps() const { return NoRejectedSteps; }
+	int get_NoForcedSteps() const { return NoForcedSteps; }
+
+	private:
+
+	double MinTimeDelta, MaxTimeDelta; //Shortest and longest timesteps (days)
+	double MaxPositionChange; //Largest change in position of a node in one step (m)
+	double CFLNumber; //Fraction of the diffusive stability limit used by adaptive steps
+	double Safety; //Steps aim for this fraction of MaxPositionChange
+	double MaxGrowth, MaxShrink; //Largest and smallest factors the timestep changes by
+	double TimeDelta; //Timestep being tried (days)
+	double NextTimeDelta; //Timestep proposed for the next step (days)
+	double Error; //Error of the last step tried
+	int NoAcceptedSteps, NoRejectedSteps; //Steps taken and attempts rejected
+	int NoForcedSteps; //Steps taken at the minimum timestep with nodes moving too far
+};
+
+#endif
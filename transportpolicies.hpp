@@ -0,0 +1,222 @@
+/*==============================================================
+
+transportpolicies.hpp
+
+Policy types that Coastline's per-node loops are compiled for:
+longshore flux laws, boundary conditions and breaking wave
+solutions.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file transportpolicies.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief flux law, boundary and wave breaking policies for Coastline
+@details The per-node loops of Coastline::TransportSediment are templates
+on these types, so the model's settings (FluxType, StartBoundary and
+EndBoundary, WaveTransformMethod) are fixed when the loop is compiled rather
+than tested at every node. Coastline::SelectPolicies picks the compiled
+loop for the current settings once, and again only if a setting changes.
+To add a flux law, write a policy with an Evaluate function like those
+below and give it a FluxType in Coastline::GetFluxFunction.
+@date 16/10/2026
+*/
+
+#ifndef transportpolicies_HPP
+#define transportpolicies_HPP
+
+#include <cmath>
+
+#include "fluxkernels.hpp"
+#include "breakingwavetable.hpp"
+
+using namespace std;
+
+/// @brief Node properties a flux law may use, all NoNodes long.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+struct FluxInputs
+{
+	const double* X;
+	const double* Y;
+	const double* FluxOrientation; //(degrees)
+	const double* BreakingWaveHeight; //(m)
+	const double* BreakingWaveAngle; //(degrees)
+	const double* Alpha_0; //Angle of offshore wave to the coast (degrees)
+	double WavePeriod; //(s)
+	double ShorefaceSlope;
+	double rho_w; //density of sea water (kg/m3)
+	double g; //gravitational acceleration (m/s2)
+};
+
+/* Flux laws. Evaluate fills Flux for nodes First to Last-1. Diffusivity is
+the rate of change of flux at node i with the orientation of the coast, dQ/dtheta
+(m3/day per radian), which divided by closure depth is the shoreline diffusivity
+that limits explicit timesteps (see TimeStepController) and is made implicit
+by ShorelineDiffusion. It is negative where high angle waves are anti-diffusive.
+86400 multiplier converts from units of m3/s to m3/day since timesteps in
+model are in days. */
+
+/// @brief FluxType 0, simple diffusion, this will need fixing
+struct DiffusionFlux
+{
+	static void Evaluate(const FluxInputs& In, double* Flux, int First, int Last)
+	{
+		double DiffCoef = 1.0;
+		for (int i=First; i<Last; ++i) Flux[i] = DiffCoef*In.FluxOrientation[i];
+	}
+	static double Diffusivity(const FluxInputs& In, int i)
+	{
+		double DiffCoef = 1.0;
+		return DiffCoef*180./M_PI;
+	}
+};
+
+/// @brief FluxType 1, CERC equation for sand
+struct CercSand
+{
+	static void Evaluate(const FluxInputs& In, double* Flux, int First, int Last)
+	{
+		FluxKernels::CERC(86400.*0.41/2., In.BreakingWaveHeight+First, In.BreakingWaveAngle+First, Flux+First, Last-First);
+	}
+	static double Diffusivity(const FluxInputs& In, int i)
+	{
+		return FluxKernels::CERCDiffusivity(86400.*0.41/2., In.BreakingWaveHeight[i], In.BreakingWaveAngle[i], In.Alpha_0[i], In.WavePeriod, In.g);
+	}
+};
+
+/// @brief FluxType 2, CERC equation for gravel
+struct CercGravel
+{
+	static void Evaluate(const FluxInputs& In, double* Flux, int First, int Last)
+	{
+		FluxKernels::CERC(86400.*0.054/2., In.BreakingWaveHeight+First, In.BreakingWaveAngle+First, Flux+First, Last-First);
+	}
+	static double Diffusivity(const FluxInputs& In, int i)
+	{
+		return FluxKernels::CERCDiffusivity(86400.*0.054/2., In.BreakingWaveHeight[i], In.BreakingWaveAngle[i], In.Alpha_0[i], In.WavePeriod, In.g);
+	}
+};
+
+/// @brief FluxType 9, CERC gravel equation with porosity term (Brown et al. 2016)
+/// @details Reduction factor of 18 following Soulsby and Damgaard (2005).
+/// 2000 = wet gravel density (kg per cubic metre), 0.45 = porosity factor for
+/// gravel, 19002.33 = 2^3.5 * sqrt(9.81) * (2000-1025) * (1-0.45)
+struct CercGravelPorosity
+{
+	static void Evaluate(const FluxInputs& In, double* Flux, int First, int Last)
+	{
+		//LongshoreFlux[i] = 86400.*0.054*(rho_w*pow(BreakingWaveHeight[i],2.5)*sin(2*((M_PI/180)*BreakingWaveAngle[i]))/19002.33);
+		//LongshoreFlux[i] = LongshoreFlux[i]/18;
+		FluxKernels::CERC(Coefficient(In), In.BreakingWaveHeight+First, In.BreakingWaveAngle+First, Flux+First, Last-First);
+	}
+	static double Diffusivity(const FluxInputs& In, int i)
+	{
+		return FluxKernels::CERCDiffusivity(Coefficient(In), In.BreakingWaveHeight[i], In.BreakingWaveAngle[i], In.Alpha_0[i], In.WavePeriod, In.g);
+	}
+	static double Coefficient(const FluxInputs& In)
+	{
+		return 86400.*0.054*In.rho_w/(pow(2,3.5)*pow(In.g,0.5)*(2000-In.rho_w)*(1-0.45));
+	}
+};
+
+/// @brief FluxType 11, CERC Equation, Ozasa & Brampton (1980) style! (see also van den Berg 2012).
+/// @details Justification still unclear as noted by Ashton et al 2006.
+struct OzasaBramptonFlux
+{
+	static void Evaluate(const FluxInputs& In, double* Flux, int First, int Last)
+	{
+		for (int i=First; i<Last; ++i)
+		{
+			double dX = In.X[i+1]-In.X[i];
+			double dY = In.Y[i+1]-In.Y[i];
+			double Distance = sqrt(dX*dX + dY*dY);
+			double K1 = 0.054;
+			double K2 = 2.*K1/In.ShorefaceSlope;
+			Flux[i] = 86400.*(In.BreakingWaveHeight[i],2.5)
+							*(K1*sin(2.*In.BreakingWaveAngle[i])
+							- K2*cos(In.BreakingWaveAngle[i])*((In.BreakingWaveAngle[i+1]-In.BreakingWaveAngle[i])/Distance));
+		}
+	}
+	static double Diffusivity(const FluxInputs& In, int i)
+	{
+		//from the first term only, as written above (angle in radians, height term 2.5)
+		double K1 = 0.054;
+		return 86400.*2.5*K1*2.*cos(2.*In.BreakingWaveAngle[i]);
+	}
+};
+
+/* Boundary conditions, set by StartBoundary and EndBoundary */
+
+/// @brief StartBoundary = EndBoundary = 1, sediment passed out of one end comes in the other
+struct PeriodicBoundary { enum { Periodic = 1, Fixed = 0 }; };
+
+/// @brief StartBoundary = EndBoundary = 2, fixed ends with or without sediment supplied
+struct FixedBoundary { enum { Periodic = 0, Fixed = 1 }; };
+
+/// @brief Any other combination, the ends get no special treatment
+struct OpenBoundary { enum { Periodic = 0, Fixed = 0 }; };
+
+/* Breaking wave solutions, set by WaveTransformMethod (see BreakingWaveTable) */
+
+/// @brief WaveTransformMethod 0, march down in depth until the wave breaks
+struct MarchBreaking
+{
+	static void Break(BreakingWaveTable& Table, double H_0, double C_0, double L_0, double Alpha_0, double& H_b, double& Alpha_b)
+	{
+		BreakingWaveTable::MarchBreakingWave(H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+	}
+};
+
+/// @brief WaveTransformMethod 1, interpolate the breaking depth from the lookup table
+struct TableBreaking
+{
+	static void Break(BreakingWaveTable& Table, double H_0, double C_0, double L_0, double Alpha_0, double& H_b, double& Alpha_b)
+	{
+		Table.GetBreakingWave(H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+	}
+};
+
+/// @brief WaveTransformMethod 2, solve for the breaking depth by Newton's method
+struct NewtonBreaking
+{
+	static void Break(BreakingWaveTable& Table, double H_0, double C_0, double L_0, double Alpha_0, double& H_b, double& Alpha_b)
+	{
+		BreakingWaveTable::SolveBreakingWave(H_0, C_0, L_0, Alpha_0, H_b, Alpha_b);
+	}
+};
+
+#endif
@@ -144,8 +144,10 @@ void GaussianWaveClimate::Initialise(double OffshoreMeanWavePeriod, double Offsh
 	Dir_StD = OffshoreStDWaveDirection;
 	Height_Mean = OffshoreMeanWaveHeight;
 	Height_StD = OffshoreStDWaveHeight;
-	//srand(time(NULL));
-	srand(1);
+	
+	//each climate has its own random numbers, see SetSeed
+	double Parameters[] = {Period_Mean, Period_StD, Dir_Mean, Dir_StD, Height_Mean, Height_StD};
+	Random.Seed(1, RandomStream::StreamFor(Parameters, 6));
 }
 
 Wave GaussianWaveClimate::Get_Wave()
@@ -158,21 +160,18 @@ Wave GaussianWaveClimate::Get_Wave()
 	Get wave properties based on random sampling from a normal distribution
 	described by a mean and standard deviation of offshore wave conditions
 	
-	Random normal distribution from Box-Muller transform 
-	sqrt(-2*log((double)rand()/RAND_MAX))*sin(2*PI*((double)rand()/RAND_MAX)) */
+	Random normal distribution from Box-Muller transform in the
+	climate's own RandomStream */
 		
  	//initialise a temprary wave object
 	Wave TempWave = Wave();
 	
-	double WavePeriod, OffshoreWaveHeight, OffshoreWaveDirection, rand1, rand2;
+	double WavePeriod, OffshoreWaveHeight, OffshoreWaveDirection;
 		
-	//Get two random numbers and generate wave data
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-	WavePeriod = Period_Mean + Period_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-	OffshoreWaveHeight = Height_Mean + Height_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-	OffshoreWaveDirection = Dir_Mean + Dir_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+	//generate wave data from normal deviates
+	WavePeriod = Period_Mean + Period_StD*Random.Normal();
+	OffshoreWaveHeight = Height_Mean + Height_StD*Random.Normal();
+	OffshoreWaveDirection = Dir_Mean + Dir_StD*Random.Normal();
 			
 	//assign wave properties from wave climate
 	TempWave.AssignWaveDirection(OffshoreWaveDirection);
@@ -183,6 +182,20 @@ Wave GaussianWaveClimate::Get_Wave()
 	return TempWave;
 }
 
+void GaussianWaveClimate::Fill(WaveBatch& Batch, int NoBatchWaves)
+{
+	//three normal deviates per wave, in the order Get_Wave uses them
+	Batch.Resize(NoBatchWaves);
+	Deviates.resize(3*NoBatchWaves);
+	Random.Normals(Deviates.data(), 3*NoBatchWaves);
+	for (int k=0; k<NoBatchWaves; ++k)
+	{
+		Batch.Period[k] = Period_Mean + Period_StD*Deviates[3*k];
+		Batch.Height[k] = Height_Mean + Height_StD*Deviates[3*k+1];
+		Batch.Dir[k] = Dir_Mean + Dir_StD*Deviates[3*k+2];
+	}
+}
+
 //=====================================================================
 
 //=====================================================================
@@ -206,38 +219,19 @@ void RealWaveClimate::Initialise()
 
 void RealWaveClimate::Initialise(string WaveFileName)
 {
-	/*	Reads a wave data from a text file 
+	/*	Opens a wave data text file, or its binary form, for streaming
 		File format is
 								Headers
 								Dir[0] | Period[0] | Height[0]
 								Dir[1] | Period[1] | Height[1]	
-								 ...   |    ...    |   ...		*/
-
-	//declarations
-	float T, D, H;
-	string Temp, line;
-	
-	NoWaves = 0;
-	WaveCounter = 0;
-	
-	ifstream ReadWaveFile;
-	ReadWaveFile.open(WaveFileName.c_str());
-	if (ReadWaveFile.is_open()) ReadWaveFile >> Temp >> Temp >> Temp;
-	else
-	{
-		cout << "Coastline.ReadCoast: Error, the file " << WaveFileName << " has not been read correctly." << endl;
-		exit(EXIT_FAILURE);
-	}
-
-	//Loop through file and read in wave data
-	while (!ReadWaveFile.eof())
-	{
-		ReadWaveFile >> D >> T >> H; 
-		Dir.push_back(D);
-		Period.push_back(T);
-		Height.push_back(H);
-		NoWaves += 1;
-	}
+								 ...   |    ...    |   ...
+		or, timed, with a first column Time[0], Time[1], ...	*/
+
+	Reader.Open(WaveFileName);
+	Interpolation = 1;
+	HaveBracket = 0;
+	Cycle = Reader.get_LastTime()-Reader.get_FirstTime()+Reader.get_LastInterval();
+	if (Cycle <= 0) Cycle = 1.;
 }
 
 Wave RealWaveClimate::Get_Wave()
@@ -250,19 +244,100 @@ Wave RealWaveClimate::Get_Wave()
  	//initialise a temprary wave object
 	Wave TempWave = Wave();
 	
-	//assign wave properties from wave climate
-	TempWave.AssignWaveDirection(Dir[WaveCounter]);
-	TempWave.AssignWaveHeight(Height[WaveCounter]);
-	TempWave.AssignWavePeriod(Period[WaveCounter]);
-	
-	//update wave counter and reset if necessary
-	WaveCounter += 1;
-	if (WaveCounter >= NoWaves) WaveCounter = 0;
+	//assign wave properties from the next record of the wave file
+	double D, T, H;
+	Reader.Next(D, T, H);
+	TempWave.AssignWaveDirection(D);
+	TempWave.AssignWaveHeight(H);
+	TempWave.AssignWavePeriod(T);
 	
 	//return the wave object
 	return TempWave;
 }
 
+Wave RealWaveClimate::Get_Wave(double Time)
+{
+	/* Get_Wave(Time) returns the wave at Time from a timed wave file,
+	interpolated between the records either side of it. Time is first
+	brought into the first cycle of the series. Starting from the records
+	either side of the last time sampled, up to 8 records are read on to
+	reach Time, otherwise the file is searched for it. */
+	
+	if (Reader.get_IsTimed() == 0)
+	{
+		cout << "RealWaveClimate.Get_Wave: Error, the wave file has no times" << endl;
+		exit(EXIT_FAILURE);
+	}
+	double FirstTime = Reader.get_FirstTime();
+	double CycleTime = Time - Cycle*floor((Time-FirstTime)/Cycle);
+	if (CycleTime < FirstTime) CycleTime = FirstTime;
+	
+	//time relative to the bracket, later in the cycle if before its first record
+	double BracketedTime = CycleTime;
+	int Found = 0;
+	for (int Steps=0; HaveBracket == 1 && Steps < 8; ++Steps)
+	{
+		BracketedTime = (CycleTime < BracketTime[0]) ? CycleTime+Cycle : CycleTime;
+		if (BracketedTime < BracketTime[1])
+		{
+			Found = 1;
+			break;
+		}
+		Advance();
+	}
+	if (Found == 0)
+	{
+		Reader.Seek(CycleTime);
+		double T, D, P, H;
+		Reader.Next(T, D, P, H);
+		BracketTime[0] = T;
+		BracketWave[0] = Wave(P, H, D);
+		ReadBracket();
+		HaveBracket = 1;
+		BracketedTime = CycleTime;
+	}
+	
+	if (Interpolation == 0) return BracketWave[0];
+	
+	//linear interpolation, direction along the shorter arc
+	double Fraction = (BracketedTime-BracketTime[0])/(BracketTime[1]-BracketTime[0]);
+	Wave& Before = BracketWave[0];
+	Wave& After = BracketWave[1];
+	double Turn = fmod(After.Get_WaveDirection()-Before.Get_WaveDirection()+540., 360.)-180.;
+	double Direction = Before.Get_WaveDirection()+Fraction*Turn;
+	if (Direction < 0) Direction += 360.;
+	else if (Direction >= 360.) Direction -= 360.;
+	return Wave(Before.Get_WavePeriod()+Fraction*(After.Get_WavePeriod()-Before.Get_WavePeriod()),
+	            Before.Get_WaveHeight()+Fraction*(After.Get_WaveHeight()-Before.Get_WaveHeight()), Direction);
+}
+
+void RealWaveClimate::ReadBracket()
+{
+	/* Reads the record after BracketTime[0] into BracketTime[1], a cycle
+	later if it is the first record again */
+	
+	double T, D, P, H;
+	if (Reader.Next(T, D, P, H) == 1) T += Cycle;
+	BracketTime[1] = T;
+	BracketWave[1] = Wave(P, H, D);
+}
+
+void RealWaveClimate::Advance()
+{
+	/* Moves the bracket on one record, keeping its first record in the first cycle */
+	
+	BracketTime[0] = BracketTime[1];
+	BracketWave[0] = BracketWave[1];
+	if (BracketTime[0] >= Reader.get_FirstTime()+Cycle) BracketTime[0] -= Cycle;
+	ReadBracket();
+}
+
+void RealWaveClimate::Fill(WaveBatch& Batch, int NoBatchWaves)
+{
+	Batch.Resize(NoBatchWaves);
+	for (int k=0; k<NoBatchWaves; ++k) Reader.Next(Batch.Dir[k], Batch.Period[k], Batch.Height[k]);
+}
+
 //=====================================================================
 
 //=====================================================================
@@ -297,8 +372,9 @@ void UAWaveClimate::Initialise(	double input_U, double input_A, double Trend,
 	Height_Mean = OffshoreMeanWaveHeight;
 	Height_StD = OffshoreStDWaveHeight;
 	
-	//srand(time(NULL));
-	srand(1);
+	//each climate has its own random numbers, see SetSeed
+	double Parameters[] = {U, A, CoastTrend, Period_Mean, Period_StD, Height_Mean, Height_StD};
+	Random.Seed(1, RandomStream::StreamFor(Parameters, 7));
 }
 
 Wave UAWaveClimate::Get_Wave()
@@ -310,8 +386,8 @@ Wave UAWaveClimate::Get_Wave()
 	a normal distribution described by a mean and standard deviation of 
 	offshore wave conditions
 	
-	Random normal distribution from Box-Muller transform 
-	sqrt(-2*log((double)rand()/RAND_MAX))*sin(2*PI*((double)rand()/RAND_MAX))
+	Random normal distribution from Box-Muller transform in the
+	climate's own RandomStream
 	
 	Wave direction sampled following the U and A approach of Ashton et al
 	2006. U is fraction of high angle waves and A is fraction of waves coming
@@ -322,16 +398,13 @@ Wave UAWaveClimate::Get_Wave()
 	
 	double WavePeriod, OffshoreWaveHeight, OffshoreWaveDirection, rand1, rand2;
 		
-	//Get two random numbers and generate wave data
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-	WavePeriod = Period_Mean + Period_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-	OffshoreWaveHeight = Height_Mean + Height_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+	//generate wave data from normal deviates
+	WavePeriod = Period_Mean + Period_StD*Random.Normal();
+	OffshoreWaveHeight = Height_Mean + Height_StD*Random.Normal();
 	
 	//Get wave Direction from U and A following Ashton & Murray (2006) CEM
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-	OffshoreWaveDirection = rand1*45.;
-	rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
+	OffshoreWaveDirection = Random.Uniform()*45.;
+	rand1 = Random.Uniform(); rand2 = Random.Uniform();
 	if (rand1 < U) OffshoreWaveDirection += 45.;
 	if (rand2 < A) OffshoreWaveDirection *= -1;
 	OffshoreWaveDirection += CoastTrend;
@@ -345,6 +418,34 @@ Wave UAWaveClimate::Get_Wave()
 	return TempWave;
 }
 
+void UAWaveClimate::Fill(WaveBatch& Batch, int NoBatchWaves)
+{
+	//Get_Wave's two normal deviates are one Box-Muller pair unless a wave has been
+	//sampled some other way, in which case sample them one at a time
+	if (Random.get_HaveSpare() == 1)
+	{
+		WaveClimate::Fill(Batch, NoBatchWaves);
+		return;
+	}
+	
+	//five uniform deviates per wave, in the order Get_Wave uses them
+	Batch.Resize(NoBatchWaves);
+	Uniforms.resize(5*NoBatchWaves);
+	Random.Uniforms(Uniforms.data(), 5*NoBatchWaves);
+	for (int k=0; k<NoBatchWaves; ++k)
+	{
+		const double* u = &Uniforms[5*k];
+		double R = sqrt(-2.*log(u[0]));
+		double Theta = 2.*M_PI*u[1];
+		Batch.Period[k] = Period_Mean + Period_StD*(R*cos(Theta));
+		Batch.Height[k] = Height_Mean + Height_StD*(R*sin(Theta));
+		
+		//wave direction from U and A, as Get_Wave but without branches
+		double Direction = u[2]*45. + ((u[3] < U) ? 45. : 0.);
+		Batch.Dir[k] = ((u[4] < A) ? -Direction : Direction) + CoastTrend;
+	}
+}
+
 //=====================================================================
 
 
@@ -392,8 +493,13 @@ void BimodalWaveClimate::Initialise(	double FractionWaveDirection1,
 											OffshoreMeanWavePeriod2, OffshoreStDWavePeriod2,
 											OffshoreMeanWaveHeight2, OffshoreStDWaveHeight2);
 	
-	//srand(time(NULL));
-	srand(1);
+	//each climate has its own random numbers, see SetSeed
+	double Parameters[] = {FractionWaveDirection1,
+							OffshoreMeanWaveDirection1, OffshoreStDWaveDirection1, OffshoreMeanWavePeriod1, OffshoreStDWavePeriod1,
+							OffshoreMeanWaveHeight1, OffshoreStDWaveHeight1,
+							OffshoreMeanWaveDirection2, OffshoreStDWaveDirection2, OffshoreMeanWavePeriod2, OffshoreStDWavePeriod2,
+							OffshoreMeanWaveHeight2, OffshoreStDWaveHeight2};
+	Random.Seed(1, RandomStream::StreamFor(Parameters, 13));
 }
 
 Wave BimodalWaveClimate::Get_Wave()
@@ -405,8 +511,8 @@ Wave BimodalWaveClimate::Get_Wave()
 	a normal distribution described by a mean and standard deviation of 
 	offshore wave conditions
 	
-	Random normal distribution from Box-Muller transform 
-	sqrt(-2*log((double)rand()/RAND_MAX))*sin(2*PI*((double)rand()/RAND_MAX))
+	Random normal distribution from Box-Muller transform in the
+	climate's own RandomStream
 	
 	Wave direction sampled from two guassian distributions weighted according
 	to Dir_Fraction1 */
@@ -414,41 +520,35 @@ Wave BimodalWaveClimate::Get_Wave()
  	//initialise a temprary wave object
 	Wave TempWave = Wave();
 	
-	double WavePeriod, OffshoreWaveHeight, OffshoreWaveDirection, rand1, rand2;
+	double WavePeriod, OffshoreWaveHeight, OffshoreWaveDirection, rand1;
 
 	//Get a random number to determine which wave direction mode to use
-	rand1 = (double)rand()/RAND_MAX;
+	rand1 = Random.Uniform();
 	
 	//for WaveMode #1
 	if (rand1 < 0.5)
 	{
 		//get a wave direction
-		rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-		OffshoreWaveDirection = WaveMode1.Dir_Mean + WaveMode1.Dir_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+		OffshoreWaveDirection = WaveMode1.Dir_Mean + WaveMode1.Dir_StD*Random.Normal();
 	
 		//Get wave Period
-		rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-		WavePeriod = WaveMode1.Period_Mean + WaveMode1.Period_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+		WavePeriod = WaveMode1.Period_Mean + WaveMode1.Period_StD*Random.Normal();
 		
 		//get wave hieght
-		rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-		OffshoreWaveHeight = WaveMode1.Height_Mean + WaveMode1.Height_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+		OffshoreWaveHeight = WaveMode1.Height_Mean + WaveMode1.Height_StD*Random.Normal();
 	}
 	
 	//for WaveMode #2
 	else
 	{
 		//get a wave direction
-		rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-		OffshoreWaveDirection = WaveMode2.Dir_Mean + WaveMode2.Dir_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+		OffshoreWaveDirection = WaveMode2.Dir_Mean + WaveMode2.Dir_StD*Random.Normal();
 	
 		//Get wave Period
-		rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-		WavePeriod = WaveMode2.Period_Mean + WaveMode2.Period_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+		WavePeriod = WaveMode2.Period_Mean + WaveMode2.Period_StD*Random.Normal();
 		
 		//get wave hieght
-		rand1 = (double)rand()/RAND_MAX; rand2 = (double)rand()/RAND_MAX;
-		OffshoreWaveHeight = WaveMode2.Height_Mean + WaveMode2.Height_StD*sqrt(-2.*log(rand1))*cos(2.*M_PI*(rand2));
+		OffshoreWaveHeight = WaveMode2.Height_Mean + WaveMode2.Height_StD*Random.Normal();
 	}
 
 	//assign wave properties from wave climate
@@ -460,4 +560,48 @@ Wave BimodalWaveClimate::Get_Wave()
 	return TempWave;
 }
 
+void BimodalWaveClimate::Fill(WaveBatch& Batch, int NoBatchWaves)
+{
+	/* Get_Wave takes a uniform deviate to choose the mode, then three normal
+	deviates. From no spare normal deviate, two waves take eight uniforms: the
+	first its mode and two Box-Muller pairs, the second its mode and one pair,
+	after the spare of the first. A wave started with a spare, or left over at
+	the end, is sampled with Get_Wave. */
+	Batch.Resize(NoBatchWaves);
+	int k = 0;
+	if (Random.get_HaveSpare() == 1 && NoBatchWaves > 0)
+	{
+		Wave TheWave = Get_Wave();
+		Batch.Period[k] = TheWave.Period, Batch.Height[k] = TheWave.Height, Batch.Dir[k] = TheWave.Dir;
+		++k;
+	}
+
+	int NoPairs = (NoBatchWaves-k)/2;
+	Uniforms.resize(8*NoPairs);
+	Random.Uniforms(Uniforms.data(), 8*NoPairs);
+	for (int p=0; p<NoPairs; ++p, k+=2)
+	{
+		const double* u = &Uniforms[8*p];
+		double R1 = sqrt(-2.*log(u[1])), Theta1 = 2.*M_PI*u[2];
+		double R2 = sqrt(-2.*log(u[3])), Theta2 = 2.*M_PI*u[4];
+		double R3 = sqrt(-2.*log(u[6])), Theta3 = 2.*M_PI*u[7];
+
+		const GaussianWaveClimate& First = (u[0] < 0.5) ? WaveMode1 : WaveMode2;
+		Batch.Dir[k] = First.Dir_Mean + First.Dir_StD*(R1*cos(Theta1));
+		Batch.Period[k] = First.Period_Mean + First.Period_StD*(R1*sin(Theta1));
+		Batch.Height[k] = First.Height_Mean + First.Height_StD*(R2*cos(Theta2));
+
+		const GaussianWaveClimate& Second = (u[5] < 0.5) ? WaveMode1 : WaveMode2;
+		Batch.Dir[k+1] = Second.Dir_Mean + Second.Dir_StD*(R2*sin(Theta2));
+		Batch.Period[k+1] = Second.Period_Mean + Second.Period_StD*(R3*cos(Theta3));
+		Batch.Height[k+1] = Second.Height_Mean + Second.Height_StD*(R3*sin(Theta3));
+	}
+
+	if (k < NoBatchWaves)
+	{
+		Wave TheWave = Get_Wave();
+		Batch.Period[k] = TheWave.Period, Batch.Height[k] = TheWave.Height, Batch.Dir[k] = TheWave.Dir;
+	}
+}
+
 #endif 
@@ -59,6 +59,9 @@ distribution (i.e. two Gaussians) or using real wave climate data.
 #include <vector>
 #include <cstring>
 
+#include "randomstream.hpp"
+#include "wavefilereader.hpp"
+
 using namespace std;
 
 #ifndef waveclimate_HPP
@@ -169,11 +172,101 @@ class SingleWaveClimate
 	
 };
 
+/// @brief A batch of waves, stored as separate arrays of period, height and direction.
+/// @details Filled by WaveClimate::Fill, then taken one wave at a time with Next
+/// until Empty, when the driver fills it again.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class WaveBatch
+{
+	public:
+	
+	vector<double> Period; //(s)
+	vector<double> Height; //(m)
+	vector<double> Dir; //(azimuth)
+	
+	WaveBatch() : NoWaves(0), Cursor(0) {}
+	
+	/// @brief Makes room for NoNewWaves waves and moves the cursor back to the start
+	void Resize(int NoNewWaves)
+	{
+		NoWaves = NoNewWaves;
+		Period.resize(NoWaves), Height.resize(NoWaves), Dir.resize(NoWaves);
+		Cursor = 0;
+	}
+	
+	/// @brief Takes the wave at the cursor and moves the cursor on
+	Wave Next()
+	{
+		Wave TheWave(Period[Cursor], Height[Cursor], Dir[Cursor]);
+		++Cursor;
+		return TheWave;
+	}
+	
+	/// @brief The k-th wave of the batch, without moving the cursor
+	Wave Get_Wave(int k) const { return Wave(Period[k], Height[k], Dir[k]); }
+	
+	/// @brief 1 if every wave has been taken
+	int Empty() const { return (Cursor >= NoWaves) ? 1 : 0; }
+	
+	int get_NoWaves() const { return NoWaves; }
+	int get_Cursor() const { return Cursor; }
+	
+	private:
+	
+	int NoWaves;
+	int Cursor; //Next wave to take
+};
+
+/// @brief Interface common to the wave climates that can be sampled for a sequence of waves.
+/// @details Fill generates a batch of waves in one pass, which the Gaussian and UA
+/// climates do a whole batch at a time with their random numbers drawn first and
+/// transformed in loops the compiler can vectorise. A batch always holds the waves the
+/// same number of calls to Get_Wave would have given, so a sequence of waves doesn't
+/// depend on the batch size or on mixing Fill and Get_Wave.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class WaveClimate
+{
+	public:
+	
+	virtual ~WaveClimate() {}
+	
+	/// @brief Samples the next wave from the wave climate
+	/// @return Wave object
+	virtual Wave Get_Wave() = 0;
+	
+	/// @brief Replaces the waves in Batch with the next NoBatchWaves waves from the wave climate
+	/// @details By default calls Get_Wave NoBatchWaves times.
+	/// @param Batch WaveBatch, resized to NoBatchWaves with its cursor at the start
+	/// @param NoBatchWaves int, number of waves to generate
+	virtual void Fill(WaveBatch& Batch, int NoBatchWaves)
+	{
+		Batch.Resize(NoBatchWaves);
+		for (int k=0; k<NoBatchWaves; ++k)
+		{
+			Wave TheWave = Get_Wave();
+			Batch.Period[k] = TheWave.Period, Batch.Height[k] = TheWave.Height, Batch.Dir[k] = TheWave.Dir;
+		}
+	}
+	
+	/// @brief Writes the next NoBatchWaves waves from the wave climate to Waves
+	void Fill(Wave* Waves, int NoBatchWaves)
+	{
+		Fill(Buffer, NoBatchWaves);
+		for (int k=0; k<NoBatchWaves; ++k) Waves[k] = Buffer.Get_Wave(k);
+	}
+	
+	private:
+	
+	WaveBatch Buffer; //For filling arrays of Wave objects
+};
+
 /// @brief Gaussian wave climate object, described by mean and standard deviation
 /// wave direction, height and period.
 /// @author Martin D. Hurst
 /// @date 26/10/2015
-class GaussianWaveClimate 
+class GaussianWaveClimate : public WaveClimate
 {
 	
 	//BimodalWaveClimate will need to be a friend since it uses two GaussianWaveClimates
@@ -188,6 +281,8 @@ class GaussianWaveClimate
 	double Dir_StD;
 	double Height_Mean;
 	double Height_StD;
+	RandomStream Random; //Stream the waves are sampled from
+	vector<double> Deviates; //Random numbers for Fill
 	
 	//Initialise functions
 	void Initialise();
@@ -223,21 +318,44 @@ class GaussianWaveClimate
 	/// @author Martin D. Hurst
 	/// @date 26/10/2015
 	Wave Get_Wave();
+	/// @brief Replaces the waves in Batch with the next NoBatchWaves waves from the wave climate
+	/// @details Draws the three normal deviates of every wave at once, in the order Get_Wave would.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void Fill(WaveBatch& Batch, int NoBatchWaves);
+	using WaveClimate::Fill;
+	/// @brief Sets the random number stream waves are sampled from
+	/// @details By default each climate samples from seed 1 and a stream found from its
+	/// parameters, so climates with different parameters are independent and the waves
+	/// don't depend on what else a driver samples or in what order. Give ensemble members
+	/// the same seed and different streams, or different seeds.
+	/// @param Seed unsigned long long, the seed
+	/// @param Stream unsigned long long, the stream number
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void SetSeed(unsigned long long Seed, unsigned long long Stream = 0) { Random.Seed(Seed, Stream); }
 };
 
 /// @brief Real wave climate object, reading wave data from a text file
 /// containing wave direction, height and period.
+/// @details The file is streamed by a WaveFileReader rather than read in
+/// whole, and may also be a binary file made from the text file by WriteBinary.
 /// @author Martin D. Hurst
 /// @date 26/10/2015
-class RealWaveClimate 
+class RealWaveClimate : public WaveClimate
 {
 	private:
 	
 	// data members
-	vector<double> Period;
-	vector<double> Dir;
-	vector<double> Height;
-	int NoWaves, WaveCounter;
+	WaveFileReader Reader;
+	int Interpolation; //0 = hold each record until the next, 1 = linear
+	double Cycle; //Time after which a timed series repeats
+	int HaveBracket; //1 once the records either side of a time have been read
+	double BracketTime[2]; //Times of the records either side of the last time sampled
+	Wave BracketWave[2];
+	
+	void Advance();
+	void ReadBracket();
 	
 	// initialise functions
 	void Initialise();
@@ -253,13 +371,28 @@ class RealWaveClimate
 	/// @brief Initialise function. Creates a real wave climate object from a specified text file.
 	/// @details  Reads wave data from a text file. File format is three columns, the first is wave 
 	/// directions (azimuth), the second is wave periods (seconds) and the third is wave height (metres).
-	/// The function assumes that the file as 1 header line.
+	/// The function assumes that the file as 1 header line. A timed file has a fourth column before
+	/// these, the time of each wave, for Get_Wave(Time).
 	/// @return RealWaveClimate
 	/// @param WaveFileName String, name of the wave file
 	/// @author Martin D. Hurst
 	/// @date 26/10/2015
 	RealWaveClimate(string WaveFileName) { Initialise(WaveFileName); }
 	
+	/// @brief Converts a text wave file to the binary form, once, so that later runs start without parsing it.
+	/// @details The binary file can be given to RealWaveClimate in place of the text file and gives the same waves.
+	/// @return long long, number of waves written
+	/// @param TextFileName String, name of the text wave file
+	/// @param BinaryFileName String, name of the binary wave file to write
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	static long long WriteBinary(string TextFileName, string BinaryFileName) { return WaveFileReader::WriteBinary(TextFileName, BinaryFileName); }
+	
+	/// @brief Number of waves in the file, -1 for a text file until all of it has been sampled
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	long long get_NoWaves() const { return Reader.get_NoRecords(); }
+	
 	/// @brief Function to sample a wave from the wave climate.
 	/// @details Function updates an index counter so that waves are sampled from the RealWaveClimate
 	/// object sequentially.
@@ -267,6 +400,33 @@ class RealWaveClimate
 	/// @author Martin D. Hurst
 	/// @date 26/10/2015
 	Wave Get_Wave();
+	
+	/// @brief Function to sample the wave at a given time from a timed wave file.
+	/// @details The file's first column is the time of each record, in the units of Time (e.g. days).
+	/// The wave is that of the last record at or before Time, or interpolated linearly between it
+	/// and the next (see SetInterpolation), direction along the shorter arc between the two. Times
+	/// may come in any order and at any spacing. The records either side of the last time are kept,
+	/// and the next few read on, so a run stepping forward reads the file once, while any other time
+	/// is found by bisection, e.g. the start time of a restarted run. The series repeats, the first
+	/// record following the last after the interval between the last two.
+	/// @return Wave object
+	/// @param Time double, the time
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	Wave Get_Wave(double Time);
+	
+	/// @brief Sets how waves are found between records by Get_Wave(Time)
+	/// @param NewInterpolation int, 0 = the wave of the last record, 1 = linear interpolation (default)
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void SetInterpolation(int NewInterpolation) { Interpolation = NewInterpolation; }
+	
+	/// @brief Replaces the waves in Batch with the next NoBatchWaves waves from the wave climate
+	/// @details Copies the next waves from the file, starting again from the beginning at the end.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void Fill(WaveBatch& Batch, int NoBatchWaves);
+	using WaveClimate::Fill;
 };
 
 /// @brief Four-bin PDF wave climate object following Ashton & Murray (2006).
@@ -279,7 +439,7 @@ class RealWaveClimate
 /// Wave height and period represented by Gaussian distributions.
 /// @author Martin D. Hurst
 /// @date 26/10/2015
-class UAWaveClimate 
+class UAWaveClimate : public WaveClimate
 {
 	private:
 	
@@ -291,6 +451,8 @@ class UAWaveClimate
 	double U;
 	double A;
 	double CoastTrend;
+	RandomStream Random; //Stream the waves are sampled from
+	vector<double> Uniforms; //Random numbers for Fill
 	
 	void Initialise();
 	void Initialise( double input_U, double input_A, double Trend, 
@@ -327,19 +489,39 @@ class UAWaveClimate
 	/// @return Wave object
 	/// @author Martin D. Hurst
 	/// @date 26/10/2015
-	Wave Get_Wave();											
+	Wave Get_Wave();
+
+	/// @brief Replaces the waves in Batch with the next NoBatchWaves waves from the wave climate
+	/// @details Draws the five uniform deviates of every wave at once, in the order Get_Wave would, then transforms them.
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void Fill(WaveBatch& Batch, int NoBatchWaves);
+	using WaveClimate::Fill;
+
+	/// @brief Sets the random number stream waves are sampled from
+	/// @details By default each climate samples from seed 1 and a stream found from its
+	/// parameters, so climates with different parameters are independent and the waves
+	/// don't depend on what else a driver samples or in what order. Give ensemble members
+	/// the same seed and different streams, or different seeds.
+	/// @param Seed unsigned long long, the seed
+	/// @param Stream unsigned long long, the stream number
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void SetSeed(unsigned long long Seed, unsigned long long Stream = 0) { Random.Seed(Seed, Stream); }
 };
 
 /// @brief Bimodal wave climate object, described by two GaussianWaveClimate objects.
 /// @author Martin D. Hurst
 /// @date 26/10/2015
-class BimodalWaveClimate 
+class BimodalWaveClimate : public WaveClimate
 {
 	private:
 	
 	//data members
 	GaussianWaveClimate WaveMode1;
 	GaussianWaveClimate WaveMode2;
+	RandomStream Random; //Stream the waves are sampled from, the modes' own streams aren't used
+	vector<double> Uniforms; //Random numbers for Fill
 	
 	void Initialise();
 	void Initialise(double FractionWaveDirection1,
@@ -396,6 +578,22 @@ class BimodalWaveClimate
 	/// @author Martin D. Hurst
 	/// @date 26/10/2015
 	Wave Get_Wave();
+
+	/// @brief Replaces the waves in Batch with the next NoBatchWaves waves from the wave climate
+	/// @details Draws the uniform deviates of every pair of waves at once, in the order Get_Wave would, then transforms them.
+	void Fill(WaveBatch& Batch, int NoBatchWaves);
+	using WaveClimate::Fill;
+
+	/// @brief Sets the random number stream waves are sampled from
+	/// @details By default each climate samples from seed 1 and a stream found from its
+	/// parameters, so climates with different parameters are independent and the waves
+	/// don't depend on what else a driver samples or in what order. Give ensemble members
+	/// the same seed and different streams, or different seeds.
+	/// @param Seed unsigned long long, the seed
+	/// @param Stream unsigned long long, the stream number
+	/// @author Martin D. Hurst
+	/// @date 16/10/2026
+	void SetSeed(unsigned long long Seed, unsigned long long Stream = 0) { Random.Seed(Seed, Stream); }
 	
 };
 #endif
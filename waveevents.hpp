@@ -0,0 +1,235 @@
+/*==============================================================
+
+waveevents.hpp
+
+Groups consecutive similar waves from any wave climate into
+representative wave events, so that the coast can be evolved
+once per event rather than once per wave.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file waveevents.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief wave event aggregation for morphological acceleration
+@details Longshore transport follows the waves so slowly that a run of
+similar waves moves the coast much as a single wave held for the whole run
+would. WaveEventAggregator takes waves one at a time, from any wave climate,
+and merges each into the current event while it is within a tolerance of
+the event's height, period and direction. The event's wave keeps the total
+H^2.5 times duration of the waves merged (the CERC transport potential) and
+their transport weighted mean period and direction. Each event is then
+applied to the coast with one call to Coastline::TransportSediment for its
+whole duration, i.e. with the sediment volume of all of its waves, and with
+adaptive timesteps (Coastline::SetAdaptiveTimeStep) the step controller
+splits it if that would be unstable. The morphological acceleration factor
+is the number of waves per event.
+@date 16/10/2026
+*/
+
+#ifndef waveevents_HPP
+#define waveevents_HPP
+
+#include <cmath>
+
+#include "waveclimate.hpp"
+
+using namespace std;
+
+/// @brief A representative wave and how long it lasts.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+struct WaveEvent
+{
+	Wave TheWave;
+	double Duration; //(days)
+	int NoWaves; //Number of waves merged into the event
+};
+
+/// @brief Merges consecutive similar waves into wave events.
+/// @details Add a wave with Add. When it isn't similar to the current event,
+/// or the event would last longer than the longest event allowed, the current
+/// event is closed and a new one started with the wave. A closed event is
+/// taken with Get_Event before the next wave is added. Flush closes the
+/// current event, e.g. at the end of a run or before writing results.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class WaveEventAggregator
+{
+	public:
+
+	/// @brief Aggregator with the default tolerances, 10% in height, 1 s in period,
+	/// 10 degrees in direction and events of up to 5 days
+	WaveEventAggregator() { Initialise(0.1, 1., 10., 5.); }
+
+	/// @brief Aggregator with given tolerances
+	/// @param NewHeightTolerance double, relative difference in wave height allowed
+	/// @param NewPeriodTolerance double, difference in wave period allowed (s)
+	/// @param NewDirectionTolerance double, difference in wave direction allowed (degrees)
+	/// @param NewMaxDuration double, longest event allowed (days)
+	WaveEventAggregator(double NewHeightTolerance, double NewPeriodTolerance, double NewDirectionTolerance, double NewMaxDuration)
+	{
+		Initialise(NewHeightTolerance, NewPeriodTolerance, NewDirectionTolerance, NewMaxDuration);
+	}
+
+	/// @brief Adds the next wave
+	/// @param TheWave Wave, the wave
+	/// @param Duration double, how long the wave lasts (days)
+	/// @return int, 1 if adding the wave closed an event, which must be taken with Get_Event
+	int Add(Wave TheWave, double Duration)
+	{
+		++NoWaves;
+		int Closed = 0;
+		if (Current.NoWaves > 0 && !IsSimilar(TheWave, Duration))
+		{
+			Close();
+			Closed = 1;
+		}
+
+		//transport weighted sums, CERC flux goes as H^2.5
+		double Height = TheWave.Get_WaveHeight();
+		double Weight = pow(Height, 2.5)*Duration;
+		double Direction = (M_PI/180.)*TheWave.Get_WaveDirection();
+		SumDuration += Duration;
+		SumWeight += Weight;
+		SumPeriod += Weight*TheWave.Get_WavePeriod();
+		SumPeriodDuration += Duration*TheWave.Get_WavePeriod();
+		SumSin += Weight*sin(Direction);
+		SumCos += Weight*cos(Direction);
+		SumSinDuration += Duration*sin(Direction);
+		SumCosDuration += Duration*cos(Direction);
+		Current.Duration = SumDuration;
+		++Current.NoWaves;
+		Current.TheWave = Representative();
+		return Closed;
+	}
+
+	/// @brief Closes the current event, if it has any waves
+	/// @return int, 1 if an event was closed, which must be taken with Get_Event
+	int Flush()
+	{
+		if (Current.NoWaves == 0) return 0;
+		Close();
+		return 1;
+	}
+
+	/// @brief 1 if there is a closed event to take
+	int EventReady() const { return Ready; }
+
+	/// @brief Takes the last closed event
+	WaveEvent Get_Event()
+	{
+		Ready = 0;
+		return Last;
+	}
+
+	/// @brief Number of waves added
+	int get_NoWaves() const { return NoWaves; }
+
+	/// @brief Number of events closed
+	int get_NoEvents() const { return NoEvents; }
+
+	private:
+
+	double HeightTolerance, PeriodTolerance, DirectionTolerance, MaxDuration;
+	WaveEvent Current; //Event the waves are being merged into
+	WaveEvent Last; //Last event closed
+	int Ready; //1 if Last hasn't been taken
+	int NoWaves, NoEvents;
+	double SumDuration, SumWeight, SumPeriod, SumSin, SumCos; //Weighted sums for the current event
+	double SumPeriodDuration, SumSinDuration, SumCosDuration; //Sums weighted by duration only, for waves of no height
+
+	void Initialise(double NewHeightTolerance, double NewPeriodTolerance, double NewDirectionTolerance, double NewMaxDuration)
+	{
+		HeightTolerance = NewHeightTolerance;
+		PeriodTolerance = NewPeriodTolerance;
+		DirectionTolerance = NewDirectionTolerance;
+		MaxDuration = NewMaxDuration;
+		Ready = 0;
+		NoWaves = NoEvents = 0;
+		Reset();
+	}
+
+	void Reset()
+	{
+		Current.NoWaves = 0;
+		Current.Duration = 0;
+		SumDuration = SumWeight = SumPeriod = SumSin = SumCos = 0;
+		SumPeriodDuration = SumSinDuration = SumCosDuration = 0;
+	}
+
+	void Close()
+	{
+		Last = Current;
+		Ready = 1;
+		++NoEvents;
+		Reset();
+	}
+
+	/// @brief Whether a wave can be merged into the current event
+	int IsSimilar(Wave TheWave, double Duration)
+	{
+		if (SumDuration+Duration > MaxDuration*(1.+1e-9)) return 0;
+		double EventHeight = Current.TheWave.Get_WaveHeight();
+		if (fabs(TheWave.Get_WaveHeight()-EventHeight) > HeightTolerance*EventHeight) return 0;
+		if (fabs(TheWave.Get_WavePeriod()-Current.TheWave.Get_WavePeriod()) > PeriodTolerance) return 0;
+		double DirectionDifference = fabs(fmod(TheWave.Get_WaveDirection()-Current.TheWave.Get_WaveDirection()+540., 360.)-180.);
+		if (DirectionDifference > DirectionTolerance) return 0;
+		return 1;
+	}
+
+	/// @brief The wave with the transport potential and weighted mean period and direction of the event
+	Wave Representative()
+	{
+		double Height, Period, Direction;
+		if (SumWeight > 0)
+		{
+			Height = pow(SumWeight/SumDuration, 0.4);
+			Period = SumPeriod/SumWeight;
+			Direction = (180./M_PI)*atan2(SumSin, SumCos);
+		}
+		else
+		{
+			Height = 0;
+			Period = SumPeriodDuration/SumDuration;
+			Direction = (180./M_PI)*atan2(SumSinDuration, SumCosDuration);
+		}
+		if (Direction < 0) Direction += 360.;
+		return Wave(Period, Height, Direction);
+	}
+};
+
+#endif
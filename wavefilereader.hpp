@@ -0,0 +1,491 @@
+/*==============================================================
+
+wavefilereader.hpp
+
+Streaming reader for wave time series files, memory mapping the
+file and parsing a window of records at a time, with a compact
+binary form for long hindcasts.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+/** @file wavefilereader.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief streaming reader for real wave climate files
+@details RealWaveClimate used to read its whole text file with operator>>
+into three vectors of doubles before the first wave, which for a 40 year
+hourly hindcast is over 350,000 records read one character at a time
+through the stream. WaveFileReader memory maps the file instead and parses
+records only as they are sampled, a window of them at a time, with
+std::from_chars, so a run starts at once and holds just the window (as
+floats, the precision the file was always read at). The operating system
+pages the file in as it is read and can drop the pages behind. At the end
+of the data it starts again from the first record. WriteBinary converts a
+text file, once, to a binary file of native byte order floats, which Open
+recognises by its first eight bytes and samples straight from the mapping
+without parsing at all.
+
+A file may also give the time of each record in a first column. Seek then
+finds the last record at or before a time by bisection, of the records of
+a binary file or of the bytes of a text file (moving each guess on to the
+start of a line), so a run can start anywhere in a long series at once.
+@date 16/10/2026
+*/
+
+#ifndef wavefilereader_HPP
+#define wavefilereader_HPP
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/// @brief A file mapped read only into memory, unmapped when destroyed.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class MappedWaveFile
+{
+	public:
+
+	const char* Data; //Start of the file, NULL if it is empty
+	size_t Size; //Length of the file (bytes)
+
+	/// @brief Maps the file FileName, exits if it can't be opened
+	MappedWaveFile(string FileName) : Data(NULL), Size(0)
+	{
+		int Descriptor = open(FileName.c_str(), O_RDONLY);
+		struct stat Status;
+		if (Descriptor < 0 || fstat(Descriptor, &Status) != 0)
+		{
+			cout << "WaveFileReader.Open: Error, the file " << FileName << " has not been read correctly." << endl;
+			exit(EXIT_FAILURE);
+		}
+		Size = Status.st_size;
+		if (Size > 0)
+		{
+			void* Mapping = mmap(NULL, Size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+			if (Mapping == MAP_FAILED)
+			{
+				cout << "WaveFileReader.Open: Error, the file " << FileName << " could not be mapped." << endl;
+				exit(EXIT_FAILURE);
+			}
+			madvise(Mapping, Size, MADV_SEQUENTIAL);
+			Data = (const char*)Mapping;
+		}
+		//the mapping stays valid after the file is closed
+		close(Descriptor);
+	}
+
+	~MappedWaveFile() { if (Data != NULL) munmap((void*)Data, Size); }
+
+	private:
+
+	MappedWaveFile(const MappedWaveFile&);
+	MappedWaveFile& operator=(const MappedWaveFile&);
+};
+
+/// @brief Reads wave records (direction, period, height), optionally timed, from a
+/// text or binary wave file in order, starting again from the first at the end.
+/// @details A text file has a header line, then one record per line of three
+/// numbers, or four for a timed file whose first column is the time. Times must
+/// increase. A binary file, made by WriteBinary, is the eight byte identifier
+/// (COVEWAV1, or COVEWAT1 if timed), the number of records as a 64 bit integer
+/// and then the records, the time as a double if timed and three floats, in
+/// native byte order. Copies share the mapped file and carry on from the same record.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class WaveFileReader
+{
+	public:
+
+	WaveFileReader() : NoRecords(0), IsBinary(0), IsTimed(0), NoColumns(3), RecordSize(12), FirstTime(0), LastTime(0),
+	                   LastInterval(0), WindowSize(0), WindowCount(0), WindowPosition(0), First(NULL), End(NULL),
+	                   Cursor(NULL), RecordsThisPass(0), CountingPass(1), BinaryCounter(0) {}
+
+	/// @brief Opens a text or binary wave file, exits if it has no records
+	/// @param FileName string, name of the wave file
+	/// @param NewWindowSize int, number of records of a text file parsed at a time
+	void Open(string FileName, int NewWindowSize = 4096)
+	{
+		File = make_shared<MappedWaveFile>(FileName);
+		First = File->Data;
+		End = File->Data + File->Size;
+		WindowSize = (NewWindowSize > 0) ? NewWindowSize : 1;
+		WindowCount = WindowPosition = 0;
+		RecordsThisPass = 0;
+		CountingPass = 1;
+		BinaryCounter = 0;
+
+		if (File->Size >= 16 && (memcmp(File->Data, "COVEWAV1", 8) == 0 || memcmp(File->Data, "COVEWAT1", 8) == 0))
+		{
+			IsBinary = 1;
+			IsTimed = (File->Data[6] == 'T') ? 1 : 0;
+			NoColumns = 3 + IsTimed;
+			RecordSize = 12 + 8*IsTimed;
+			int64_t Count;
+			memcpy(&Count, File->Data+8, 8);
+			if (Count <= 0 || File->Size != 16 + RecordSize*(size_t)Count)
+			{
+				cout << "WaveFileReader.Open: Error, the binary wave file " << FileName << " is incomplete or has no waves." << endl;
+				exit(EXIT_FAILURE);
+			}
+			NoRecords = Count;
+			if (IsTimed == 1)
+			{
+				FirstTime = BinaryTime(0);
+				LastTime = BinaryTime(NoRecords-1);
+				LastInterval = (NoRecords > 1) ? LastTime-BinaryTime(NoRecords-2) : 0;
+			}
+			return;
+		}
+
+		//text, skip the header line, then count the columns of the first record
+		IsBinary = 0;
+		NoRecords = -1;
+		while (First < End && *First != '\n') ++First;
+		while (First < End && IsSpace(*First)) ++First;
+		Cursor = First;
+		NoColumns = 0;
+		for (const char* p = First; p < End && *p != '\n'; ++NoColumns)
+		{
+			double Value;
+			if (ParseNumber(p, Value) == 0) break;
+			while (p < End && *p != '\n' && IsSpace(*p)) ++p;
+		}
+		if (NoColumns == 0)
+		{
+			cout << "WaveFileReader.Open: Error, the file " << FileName << " has no waves." << endl;
+			exit(EXIT_FAILURE);
+		}
+		if (NoColumns != 3 && NoColumns != 4)
+		{
+			cout << "WaveFileReader.Open: Error, the file " << FileName << " has " << NoColumns
+			     << " columns, wave files have three (direction, period, height) or four (time first)." << endl;
+			exit(EXIT_FAILURE);
+		}
+		IsTimed = (NoColumns == 4) ? 1 : 0;
+		RecordSize = 12 + 8*IsTimed;
+		WindowTime.resize(WindowSize);
+		WindowDir.resize(WindowSize);
+		WindowPeriod.resize(WindowSize);
+		WindowHeight.resize(WindowSize);
+		WindowStartsPass.resize(WindowSize);
+
+		if (IsTimed == 1)
+		{
+			//times of the first and last two records, the last found back from the end of the file
+			double Record[4];
+			const char* p = First;
+			ParseRecord(p, Record);
+			FirstTime = LastTime = Record[0];
+			LastInterval = 0;
+			const char* Line = End;
+			for (int i=0; i<2 && Line > First; ++i)
+			{
+				while (Line > First && IsSpace(Line[-1])) --Line;
+				while (Line > First && Line[-1] != '\n') --Line;
+				p = Line;
+				if (ParseRecord(p, Record) == 0)
+				{
+					cout << "WaveFileReader.Open: Error, the last lines of " << FileName << " are not wave records." << endl;
+					exit(EXIT_FAILURE);
+				}
+				if (i == 0) LastTime = Record[0];
+				else LastInterval = LastTime-Record[0];
+			}
+		}
+	}
+
+	/// @brief The next record, starting again from the first after the last
+	/// @return int, 1 if the record is the first of the file
+	int Next(double& Dir, double& Period, double& Height)
+	{
+		double Time;
+		return Next(Time, Dir, Period, Height);
+	}
+
+	/// @brief The next record and its time (0 if the file isn't timed), starting again from the first after the last
+	/// @return int, 1 if the record is the first of the file
+	int Next(double& Time, double& Dir, double& Period, double& Height)
+	{
+		if (IsBinary == 1)
+		{
+			int StartsPass = (BinaryCounter == 0) ? 1 : 0;
+			const char* Record = File->Data + 16 + RecordSize*(size_t)BinaryCounter;
+			Time = (IsTimed == 1) ? BinaryTime(BinaryCounter) : 0;
+			float Values[3];
+			memcpy(Values, Record + 8*IsTimed, 12);
+			Dir = Values[0], Period = Values[1], Height = Values[2];
+			if (++BinaryCounter == NoRecords) BinaryCounter = 0;
+			return StartsPass;
+		}
+		if (WindowPosition == WindowCount) FillWindow();
+		Time = WindowTime[WindowPosition];
+		Dir = WindowDir[WindowPosition];
+		Period = WindowPeriod[WindowPosition];
+		Height = WindowHeight[WindowPosition];
+		return WindowStartsPass[WindowPosition++];
+	}
+
+	/// @brief Moves to the last record at or before Time, or the first record if
+	/// Time is before it, so that it is the next read. Timed files only.
+	void Seek(double Time)
+	{
+		if (IsTimed == 0)
+		{
+			cout << "WaveFileReader.Seek: Error, the wave file has no times." << endl;
+			exit(EXIT_FAILURE);
+		}
+		if (IsBinary == 1)
+		{
+			long long Low = 0, High = NoRecords;
+			while (High-Low > 1)
+			{
+				long long Middle = Low + (High-Low)/2;
+				if (BinaryTime(Middle) <= Time) Low = Middle;
+				else High = Middle;
+			}
+			BinaryCounter = Low;
+			return;
+		}
+
+		//bisect the bytes, Low is the start of a line at or before Time and no
+		//line starting at or after High is, until there is just a line or two between
+		const char* Low = First;
+		const char* High = End;
+		while (true)
+		{
+			const char* Line = NextLine(Low + (High-Low)/2);
+			if (Line >= High) break;
+			double LineTime;
+			const char* p = Line;
+			if (ParseNumber(p, LineTime) == 1 && LineTime <= Time) Low = Line;
+			else High = Line;
+		}
+		for (const char* Line = NextLine(Low); Line < High; Line = NextLine(Line))
+		{
+			double LineTime;
+			const char* p = Line;
+			if (ParseNumber(p, LineTime) == 0 || LineTime > Time) break;
+			Low = Line;
+		}
+		Cursor = Low;
+		WindowCount = WindowPosition = 0;
+		CountingPass = (Low == First) ? 1 : 0;
+		RecordsThisPass = 0;
+	}
+
+	/// @brief Number of records in the file, -1 for a text file whose end hasn't been reached yet
+	long long get_NoRecords() const { return NoRecords; }
+
+	/// @brief 1 if the file is binary
+	int get_IsBinary() const { return IsBinary; }
+
+	/// @brief 1 if the file gives the time of each record
+	int get_IsTimed() const { return IsTimed; }
+
+	/// @brief Time of the first record
+	double get_FirstTime() const { return FirstTime; }
+
+	/// @brief Time of the last record
+	double get_LastTime() const { return LastTime; }
+
+	/// @brief Time between the last two records, 0 if there is only one
+	double get_LastInterval() const { return LastInterval; }
+
+	/// @brief Converts a text wave file to binary, exits if it can't
+	/// @param TextFileName string, name of the text wave file
+	/// @param BinaryFileName string, name of the binary file to write
+	/// @return long long, the number of records written
+	static long long WriteBinary(string TextFileName, string BinaryFileName)
+	{
+		WaveFileReader Reader;
+		Reader.Open(TextFileName, 1);
+		if (Reader.IsBinary == 1)
+		{
+			cout << "WaveFileReader.WriteBinary: Error, " << TextFileName << " is already binary." << endl;
+			exit(EXIT_FAILURE);
+		}
+		ofstream WriteFile(BinaryFileName.c_str(), ios::binary);
+		if (!WriteFile.is_open())
+		{
+			cout << "WaveFileReader.WriteBinary: Error, the file " << BinaryFileName << " could not be written." << endl;
+			exit(EXIT_FAILURE);
+		}
+		int64_t Count = 0;
+		WriteFile.write((Reader.IsTimed == 1) ? "COVEWAT1" : "COVEWAV1", 8);
+		WriteFile.write((const char*)&Count, 8);
+		double Record[4];
+		const char* Position = Reader.First;
+		while (Reader.ParseRecord(Position, Record) == 1)
+		{
+			if (Reader.IsTimed == 1) WriteFile.write((const char*)Record, 8);
+			float Values[3] = {(float)Record[Reader.IsTimed], (float)Record[Reader.IsTimed+1], (float)Record[Reader.IsTimed+2]};
+			WriteFile.write((const char*)Values, 12);
+			++Count;
+		}
+		WriteFile.seekp(8);
+		WriteFile.write((const char*)&Count, 8);
+		WriteFile.close();
+		if (WriteFile.fail())
+		{
+			cout << "WaveFileReader.WriteBinary: Error, the file " << BinaryFileName << " could not be written." << endl;
+			exit(EXIT_FAILURE);
+		}
+		return Count;
+	}
+
+	private:
+
+	shared_ptr<MappedWaveFile> File;
+	long long NoRecords;
+	int IsBinary, IsTimed;
+	int NoColumns; //Numbers per record
+	size_t RecordSize; //Bytes per binary record
+	double FirstTime, LastTime, LastInterval;
+
+	//text files, a window of parsed records
+	vector<double> WindowTime;
+	vector<float> WindowDir, WindowPeriod, WindowHeight;
+	vector<char> WindowStartsPass; //1 for the first record of the file
+	int WindowSize, WindowCount, WindowPosition;
+	const char* First; //First record
+	const char* End; //End of the file
+	const char* Cursor; //Next record to parse
+	long long RecordsThisPass; //Records parsed since last starting from the first
+	int CountingPass; //0 after a seek, until the first record is reached again
+
+	//binary files, the next record
+	long long BinaryCounter;
+
+	static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+
+	/// @brief Start of the line after the one Position is in
+	const char* NextLine(const char* Position) const
+	{
+		while (Position < End && *Position != '\n') ++Position;
+		while (Position < End && IsSpace(*Position)) ++Position;
+		return Position;
+	}
+
+	/// @brief Time of record i of a timed binary file
+	double BinaryTime(long long i) const
+	{
+		double Time;
+		memcpy(&Time, File->Data + 16 + RecordSize*(size_t)i, 8);
+		return Time;
+	}
+
+	/// @brief Parses the number at Position (after any white space) and moves Position past it
+	/// @return int, 0 if there isn't a number
+	int ParseNumber(const char*& Position, double& Value) const
+	{
+		const char* p = Position;
+		while (p < End && IsSpace(*p)) ++p;
+		if (p < End && *p == '+') ++p;
+		from_chars_result Result = from_chars(p, End, Value);
+		if (Result.ec != errc()) return 0;
+		Position = Result.ptr;
+		return 1;
+	}
+
+	/// @brief Parses the record at Position and moves Position past it, the
+	/// direction, period and height to float as they always have been read
+	/// @return int, 0 at the end of the data (or anything that isn't a record)
+	int ParseRecord(const char*& Position, double* Record) const
+	{
+		const char* p = Position;
+		for (int i=0; i<NoColumns; ++i)
+		{
+			if (IsTimed == 1 && i == 0)
+			{
+				if (ParseNumber(p, Record[i]) == 0) return 0;
+				continue;
+			}
+			while (p < End && IsSpace(*p)) ++p;
+			if (p < End && *p == '+') ++p;
+			float Value;
+			from_chars_result Result = from_chars(p, End, Value);
+			if (Result.ec != errc()) return 0;
+			Record[i] = Value;
+			p = Result.ptr;
+		}
+		Position = p;
+		return 1;
+	}
+
+	/// @brief Parses the next window of records, starting again from the first at the end
+	void FillWindow()
+	{
+		WindowCount = WindowPosition = 0;
+		double Record[4];
+		int StartsPass = (Cursor == First) ? 1 : 0;
+		while (WindowCount < WindowSize)
+		{
+			if (ParseRecord(Cursor, Record) == 0)
+			{
+				if (NoRecords < 0 && CountingPass == 1) NoRecords = RecordsThisPass;
+				Cursor = First;
+				RecordsThisPass = 0;
+				CountingPass = 1;
+				StartsPass = 1;
+				continue;
+			}
+			WindowTime[WindowCount] = (IsTimed == 1) ? Record[0] : 0;
+			WindowDir[WindowCount] = (float)Record[IsTimed];
+			WindowPeriod[WindowCount] = (float)Record[IsTimed+1];
+			WindowHeight[WindowCount] = (float)Record[IsTimed+2];
+			WindowStartsPass[WindowCount] = StartsPass;
+			StartsPass = 0;
+			++WindowCount;
+			++RecordsThisPass;
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*==============================================================
+
+wavepipeline.hpp
+
+Samples waves from a wave climate on a background thread into a
+bounded ring, read in order by one or more consumers.
+
+Developed by:
+Martin D. Hurst
+Andrew Barkwith
+Michael A. Ellis
+Christopher W. Thomas
+A. Brad Murray
+
+Copyright (C) 2015, Martin Hurst
+
+Developer can be contacted:
+mhurst@bgs.ac.uk
+
+Martin D. Hurst
+British Geological Survey,
+Environmental Science Centre,
+Nicker Hill,
+Keyworth,
+Nottingham,
+UK,
+NG12 5GG
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+==============================================================*/
+
+
+/** @file wavepipeline.hpp
+@author Martin D. Hurst, British Geological Survey
+@brief wave climate sampling on a producer thread
+@details Sampling a wave (Box-Muller deviates, or parsing a hindcast) ran on
+the same thread as Coastline::TransportSediment, between steps. WavePipeline
+moves it to a thread of its own, which samples the climate in batches with
+WaveClimate::Fill and writes the waves to a ring of fixed capacity. Each
+consumer, e.g. each coastline of an ensemble forced by the same waves, reads
+every wave in order from its own position in the ring, so all consumers get
+exactly the waves the climate would have given one at a time, however the
+threads run. The producer only waits when the ring is full, i.e. when the
+slowest consumer is the capacity behind, and a consumer only when it has
+read every wave made. There are no locks, the producer publishes the count
+of waves written and each consumer the count it has read, each counter on a
+cache line of its own.
+@date 16/10/2026
+*/
+
+#ifndef wavepipeline_HPP
+#define wavepipeline_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+#include "waveclimate.hpp"
+
+using namespace std;
+
+/// @brief A count of waves, on a cache line of its own.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+struct alignas(64) PipelineCounter
+{
+	atomic<uint64_t> Count;
+	uint64_t LastWritten; //Consumer's copy of the producer's count, saves reading it for every wave
+	long long NoWaits; //Times the consumer found no wave ready
+	PipelineCounter() : Count(0), LastWritten(0), NoWaits(0) {}
+};
+
+/// @brief Samples a wave climate on a producer thread for one or more consumers.
+/// @details The producer starts when the pipeline is made and stops when it is
+/// destroyed or Stop is called. The climate must not be used by anything else
+/// until then. Consumer i must be read from one thread only, but different
+/// consumers can be read from different threads. No consumer can get more
+/// than the capacity ahead of the slowest, so consumers read on the same
+/// thread must be read in turn.
+/// @author Martin D. Hurst
+/// @date 16/10/2026
+class WavePipeline
+{
+	public:
+
+	/// @brief Starts sampling Climate for NewNoConsumers consumers
+	/// @param NewClimate WaveClimate&, the wave climate
+	/// @param NewNoConsumers int, number of consumers, each given every wave
+	/// @param NewCapacity int, number of waves the ring holds, rounded up to a power of two
+	/// @param NewBatchSize int, number of waves sampled at a time
+	WavePipeline(WaveClimate& NewClimate, int NewNoConsumers = 1, int NewCapacity = 4096, int NewBatchSize = 256)
+	: Climate(NewClimate), NoConsumers(NewNoConsumers), BatchSize(NewBatchSize), Consumers(NewNoConsumers), Stopping(0), NoProducerWaits(0)
+	{
+		Capacity = 1;
+		while (Capacity < (uint64_t)NewCapacity) Capacity *= 2;
+		Ring.resize(Capacity);
+		if (BatchSize < 1) BatchSize = 1;
+		Producer = thread(&WavePipeline::Produce, this);
+	}
+
+	~WavePipeline() { Stop(); }
+
+	/// @brief Next wave for a consumer, waiting for the producer if none is ready
+	/// @param Consumer int, the consumer
+	Wave Get_Wave(int Consumer = 0)
+	{
+		Wave TheWave;
+		if (TryGet_Wave(TheWave, Consumer) == 1) return TheWave;
+		++Consumers[Consumer].NoWaits;
+		while (TryGet_Wave(TheWave, Consumer) == 0) this_thread::yield();
+		return TheWave;
+	}
+
+	/// @brief Next wave for a consumer, if one is ready
+	/// @param TheWave Wave&, set to the wave
+	/// @param Consumer int, the consumer
+	/// @return int, 0 if no wave was ready
+	int TryGet_Wave(Wave& TheWave, int Consumer = 0)
+	{
+		PipelineCounter& Reader = Consumers[Consumer];
+		uint64_t Read = Reader.Count.load(memory_order_relaxed);
+		if (Read == Reader.LastWritten)
+		{
+			Reader.LastWritten = Written.Count.load(memory_order_acquire);
+			if (Read == Reader.LastWritten) return 0;
+		}
+		TheWave = Ring[Read & (Capacity-1)];
+		Reader.Count.store(Read+1, memory_order_release);
+		return 1;
+	}
+
+	/// @brief Stops the producer, waves already made can still be read
+	void Stop()
+	{
+		if (!Producer.joinable()) return;
+		Stopping.store(1);
+		Producer.join();
+	}
+
+	/// @brief Number of consumers
+	int get_NoConsumers() const { return NoConsumers; }
+
+	/// @brief Number of waves the ring holds
+	long long get_Capacity() const { return Capacity; }
+
+	/// @brief Times the producer found the ring full and waited for the slowest consumer
+	long long get_NoProducerWaits() const { return NoProducerWaits.load(memory_order_relaxed); }
+
+	/// @brief Times a consumer found no wave ready and waited for the producer
+	long long get_NoConsumerWaits(int Consumer = 0) const { return Consumers[Consumer].NoWaits; }
+
+	private:
+
+	WaveClimate& Climate;
+	int NoConsumers, BatchSize;
+	uint64_t Capacity;
+	vector<Wave> Ring;
+	PipelineCounter Written; //Waves written by the producer
+	vector<PipelineCounter> Consumers; //Waves read by each consumer
+	atomic<int> Stopping;
+	atomic<long long> NoProducerWaits;
+	thread Producer;
+
+	/// @brief Count of waves read by the slowest consumer
+	uint64_t SlowestRead() const
+	{
+		uint64_t Slowest = Consumers[0].Count.load(memory_order_acquire);
+		for (int i=1; i<NoConsumers; ++i)
+		{
+			uint64_t Read = Consumers[i].Count.load(memory_order_acquire);
+			if (Read < Slowest) Slowest = Read;
+		}
+		return Slowest;
+	}
+
+	/// @brief The producer thread, samples batches of waves into the ring until stopped
+	void Produce()
+	{
+		WaveBatch Batch;
+		uint64_t Count = 0, Slowest = 0;
+		while (Stopping.load(memory_order_relaxed) == 0)
+		{
+			Climate.Fill(Batch, BatchSize);
+			for (int k=0; k<BatchSize; ++k)
+			{
+				//wait while the ring is full, until the slowest consumer reads a wave
+				if (Count-Slowest == Capacity) Slowest = SlowestRead();
+				if (Count-Slowest == Capacity)
+				{
+					NoProducerWaits.fetch_add(1, memory_order_relaxed);
+					while (Count-Slowest == Capacity)
+					{
+						if (Stopping.load(memory_order_relaxed) == 1) return;
+						this_thread::yield();
+						Slowest = SlowestRead();
+					}
+				}
+				Ring[Count & (Capacity-1)] = Batch.Get_Wave(k);
+				Written.Count.store(++Count, memory_order_release);
+			}
+		}
+	}
+};
+
+#endif